@@ -20,9 +20,39 @@ MESSAGE_SIZES=(64 1500 65536)
 LATENCY_ROUNDS=50000
 THROUGHPUT_MESSAGES=5000000
 
+# Repeated trials: every lat/thr configuration runs TRIALS times and the
+# median (outliers dropped) is reported with a 95% bootstrap CI. Set
+# TARGET_CI (percent of the median) to keep adding trials, up to MAX_TRIALS,
+# until the CI is that narrow: noisy configurations get more runs.
+TRIALS=${TRIALS:-5}
+TARGET_CI=${TARGET_CI:-}
+MAX_TRIALS=${MAX_TRIALS:-20}
+
 # Ports
-LAT_PORT=5555
-THR_PORT=5556
+CONTROL_PORT=5550
+IPC_CONTROL_PORT=5551
+DATA_PORT=5556
+URING_LAT_PORT=5557
+URING_THR_PORT=5558
+STREAM_THR_PORT=5559
+STREAM_LAT_PORT=5560
+RAW_CONTROL_PORT=5552
+RAW_DATA_PORT=5561
+ASYNC_LAT_PORT=5562
+ASYNC_THR_PORT=5563
+CURVE_LAT_PORT=5564
+CURVE_THR_PORT=5565
+PATTERNS_PORT=5566   # pub-sub replies on the next port
+DUPLEX_PORT=5568
+PROXY_PORT=5569      # the server behind the proxy binds the next port
+MDP_PORT=5571
+PIRATE_PORT=5572     # the Paranoid Pirate queue's backend binds the next port
+SCATTER_PORT=5600    # scatter servers bind this port and the next 63
+CONNS_PORT=5573
+
+# Co-located transports
+IPC_PATH="/tmp/zmq_bench_thr.ipc"
+SHM_RING="/zmq_bench_thr"
 
 # Build directory
 BUILD_DIR="build"
@@ -30,6 +60,10 @@ BUILD_DIR="build"
 # Output file
 OUTPUT_FILE="../docs/results/cpp-baseline.md"
 
+# Machine-readable records from every benchmark binary (JSON Lines);
+# scripts/compare.py reads these instead of parsing the markdown
+RECORDS_FILE="../docs/results/cpp-results.jsonl"
+
 echo -e "${GREEN}=== ZeroMQ C++ Benchmark ===${NC}"
 echo ""
 
@@ -40,15 +74,78 @@ if [ ! -d "$BUILD_DIR" ]; then
     exit 1
 fi
 
-if [ ! -f "$BUILD_DIR/local_lat" ] || [ ! -f "$BUILD_DIR/remote_lat" ] || \
-   [ ! -f "$BUILD_DIR/local_thr" ] || [ ! -f "$BUILD_DIR/remote_thr" ]; then
+if [ ! -f "$BUILD_DIR/zmqbench" ]; then
     echo -e "${RED}Error: Benchmark executables not found. Please build the project first.${NC}"
     exit 1
 fi
 
+# Optional raw C API build of zmqbench (same kernels, no cppzmq in the timed loops)
+HAVE_RAW_API=0
+if [ -f "$BUILD_DIR/zmqbench_raw" ]; then
+    HAVE_RAW_API=1
+fi
+
+# Optional ZMQ_STREAM variants (raw TCP through libzmq, no ZMTP)
+HAVE_STREAM=0
+if [ -f "$BUILD_DIR/local_lat_stream" ] && [ -f "$BUILD_DIR/remote_lat_stream" ] && \
+   [ -f "$BUILD_DIR/local_thr_stream" ] && [ -f "$BUILD_DIR/remote_thr_stream" ]; then
+    HAVE_STREAM=1
+fi
+
+# Optional async variants (epoll on ZMQ_FD + C++20 coroutines, Linux only)
+HAVE_ASYNC=0
+if [ -f "$BUILD_DIR/local_lat_async" ] && [ -f "$BUILD_DIR/remote_lat_async" ] && \
+   [ -f "$BUILD_DIR/local_thr_async" ] && [ -f "$BUILD_DIR/remote_thr_async" ]; then
+    HAVE_ASYNC=1
+fi
+
+# CURVE runs need libzmq built with libsodium/tweetnacl; encrypted throughput
+# is one to two orders of magnitude lower, so it runs on a fraction of the count
+HAVE_CURVE=0
+if "$BUILD_DIR/zmqbench" connect --mechanism curve --zap off -n 1 \
+       -e "tcp://127.0.0.1:${CURVE_LAT_PORT}" > /dev/null 2>&1; then
+    HAVE_CURVE=1
+fi
+CURVE_MESSAGES=$((THROUGHPUT_MESSAGES / 50))
+
+# Full-duplex runs send this many messages in each direction, twice (one
+# direction alone, then both)
+DUPLEX_MESSAGES=$((THROUGHPUT_MESSAGES / 10))
+
+# Pipeline chains pass this many messages through every stage
+CHAIN_MESSAGES=$((THROUGHPUT_MESSAGES / 10))
+
+# Pirate runs wait out a timeout for every dropped request, so they get fewer
+PIRATE_REQUESTS=$((LATENCY_ROUNDS / 25))
+
+# Scatter-gather waits on up to 64 servers per request
+SCATTER_REQUESTS=$((LATENCY_ROUNDS / 25))
+
+# Connection scaling splits these requests over the N connections (at least
+# one round each)
+CONNS_REQUESTS=$((LATENCY_ROUNDS * 2))
+
+# Optional raw TCP io_uring baseline (Linux only, built when kernel headers allow)
+HAVE_URING=0
+if [ -f "$BUILD_DIR/local_lat_uring" ] && [ -f "$BUILD_DIR/remote_lat_uring" ] && \
+   [ -f "$BUILD_DIR/local_thr_uring" ] && [ -f "$BUILD_DIR/remote_thr_uring" ]; then
+    HAVE_URING=1
+fi
+
+# Optional co-located ceilings (POSIX shared memory and memcpy)
+HAVE_SHM=0
+if [ -f "$BUILD_DIR/inproc_thr" ] && [ -f "$BUILD_DIR/local_thr_shm" ] && \
+   [ -f "$BUILD_DIR/remote_thr_shm" ] && [ -f "$BUILD_DIR/memcpy_thr" ]; then
+    HAVE_SHM=1
+fi
+
 # Create output directory if it doesn't exist
 mkdir -p "$(dirname "$OUTPUT_FILE")"
 
+# Fresh record file for this run; every binary appends to it
+: > "$RECORDS_FILE"
+export ZMQ_BENCH_OUTPUT="$(cd "$(dirname "$RECORDS_FILE")" && pwd)/$(basename "$RECORDS_FILE")"
+
 # Initialize output file
 cat > "$OUTPUT_FILE" << EOF
 # C++ Baseline Benchmark Results (cppzmq)
@@ -63,6 +160,7 @@ cat > "$OUTPUT_FILE" << EOF
 - **Latency Rounds:** ${LATENCY_ROUNDS}
 - **Throughput Messages:** ${THROUGHPUT_MESSAGES}
 - **Message Sizes:** ${MESSAGE_SIZES[@]} bytes
+- **Trials:** ${TRIALS}${TARGET_CI:+ (until 95% CI < ${TARGET_CI}% of median, max ${MAX_TRIALS})}, median reported
 
 ## Results
 
@@ -71,6 +169,52 @@ EOF
 echo -e "${YELLOW}Starting benchmarks...${NC}"
 echo ""
 
+# Persistent servers (tcp and ipc data endpoints). Clients hand them one test
+# at a time over the control channel; readiness and completion are confirmed
+# there, so no sleeps are needed.
+"$BUILD_DIR/zmqbench" serve --control "tcp://127.0.0.1:${CONTROL_PORT}" \
+    --endpoint "tcp://*:${DATA_PORT}" > /tmp/zmqbench_serve.txt 2>&1 &
+SERVE_PID=$!
+"$BUILD_DIR/zmqbench" serve --control "tcp://127.0.0.1:${IPC_CONTROL_PORT}" \
+    --endpoint "ipc://${IPC_PATH}" > /tmp/zmqbench_serve_ipc.txt 2>&1 &
+IPC_SERVE_PID=$!
+RAW_SERVE_PID=
+if [ "$HAVE_RAW_API" -eq 1 ]; then
+    "$BUILD_DIR/zmqbench_raw" serve --control "tcp://127.0.0.1:${RAW_CONTROL_PORT}" \
+        --endpoint "tcp://*:${RAW_DATA_PORT}" > /tmp/zmqbench_serve_raw.txt 2>&1 &
+    RAW_SERVE_PID=$!
+fi
+trap 'kill $SERVE_PID $IPC_SERVE_PID $RAW_SERVE_PID 2>/dev/null || true' EXIT
+
+# zmqbench client against the tcp server: bench <command> <size> <count>
+bench() {
+    "$BUILD_DIR/zmqbench" "$1" --role client --control "tcp://127.0.0.1:${CONTROL_PORT}" \
+        --endpoint "tcp://localhost:${DATA_PORT}" --size "$2" --count "$3" \
+        --trials "$TRIALS" ${TARGET_CI:+--target-ci "$TARGET_CI" --max-trials "$MAX_TRIALS"} "${@:4}"
+}
+
+# Waits until a background server has printed <pattern> to <file>; after 5 s
+# it gives up and leaves the rest to the client's connect retries
+# wait_for_line <file> <pattern>
+wait_for_line() {
+    for _ in $(seq 50); do
+        grep -q "$2" "$1" 2>/dev/null && return 0
+        sleep 0.1
+    done
+    return 0
+}
+
+# "[low, high] <unit> (N trials)" from a zmqbench result: trial_ci <file> <unit>
+# Empty for a single trial
+trial_ci() {
+    local trials ci
+    trials=$(grep "^Trials:" "$1" | awk '{print $2}')
+    ci=$(grep "% CI:" "$1" | sed 's/.*CI: \(\[[^]]*\]\).*/\1/')
+    if [ -n "$trials" ]; then
+        echo "${ci} $2 (${trials} trials)"
+    fi
+}
+
 # Run benchmarks for each message size
 for size in "${MESSAGE_SIZES[@]}"; do
     echo -e "${GREEN}Testing with message size: ${size} bytes${NC}"
@@ -81,24 +225,14 @@ for size in "${MESSAGE_SIZES[@]}"; do
     # ===========================
     echo -e "${YELLOW}  [1/2] Running latency test...${NC}"
 
-    # Start local_lat in background
-    "$BUILD_DIR/local_lat" "tcp://*:${LAT_PORT}" "$size" "$LATENCY_ROUNDS" > /tmp/lat_local.txt 2>&1 &
-    LOCAL_LAT_PID=$!
-
-    # Wait for server to start
-    sleep 1
-
-    # Run remote_lat
-    "$BUILD_DIR/remote_lat" "tcp://localhost:${LAT_PORT}" "$size" "$LATENCY_ROUNDS" > /tmp/lat_remote.txt 2>&1
-
-    # Wait for local_lat to finish
-    wait $LOCAL_LAT_PID
+    bench lat "$size" "$LATENCY_ROUNDS" > /tmp/lat_remote.txt 2>&1
 
     # Extract latency result
     LATENCY=$(grep "Average latency:" /tmp/lat_remote.txt | awk '{print $3}')
     MSG_RATE=$(grep "Message rate:" /tmp/lat_remote.txt | awk '{print $3}')
+    LATENCY_CI=$(trial_ci /tmp/lat_remote.txt us)
 
-    echo -e "    Latency: ${GREEN}${LATENCY} us${NC}"
+    echo -e "    Latency: ${GREEN}${LATENCY} us${NC} ${LATENCY_CI:+95% CI ${LATENCY_CI}}"
     echo -e "    Message rate: ${GREEN}${MSG_RATE} msg/s${NC}"
     echo ""
 
@@ -107,25 +241,18 @@ for size in "${MESSAGE_SIZES[@]}"; do
     # ===========================
     echo -e "${YELLOW}  [2/2] Running throughput test...${NC}"
 
-    # Start local_thr in background
-    "$BUILD_DIR/local_thr" "tcp://*:${THR_PORT}" "$size" "$THROUGHPUT_MESSAGES" > /tmp/thr_local.txt 2>&1 &
-    LOCAL_THR_PID=$!
-
-    # Wait for server to start
-    sleep 1
-
-    # Run remote_thr
-    "$BUILD_DIR/remote_thr" "tcp://localhost:${THR_PORT}" "$size" "$THROUGHPUT_MESSAGES" > /tmp/thr_remote.txt 2>&1
-
-    # Wait for local_thr to finish
-    wait $LOCAL_THR_PID
+    # The client prints the receiver's measurement plus its own end-to-end rate
+    bench thr "$size" "$THROUGHPUT_MESSAGES" > /tmp/thr_remote.txt 2>&1
 
     # Extract throughput results
-    THROUGHPUT=$(grep "Throughput:" /tmp/thr_local.txt | head -n 1 | awk '{print $2}')
-    MBPS=$(grep "Throughput:" /tmp/thr_local.txt | tail -n 1 | awk '{print $2}')
+    THROUGHPUT=$(grep "^Throughput:" /tmp/thr_remote.txt | head -n 1 | awk '{print $2}')
+    MBPS=$(grep "^Throughput:" /tmp/thr_remote.txt | tail -n 1 | awk '{print $2}')
+    E2E_THROUGHPUT=$(grep "End-to-end throughput:" /tmp/thr_remote.txt | awk '{print $3}')
+    THROUGHPUT_CI=$(trial_ci /tmp/thr_remote.txt msg/s)
 
-    echo -e "    Throughput: ${GREEN}${THROUGHPUT} msg/s${NC}"
+    echo -e "    Throughput: ${GREEN}${THROUGHPUT} msg/s${NC} ${THROUGHPUT_CI:+95% CI ${THROUGHPUT_CI}}"
     echo -e "    Throughput: ${GREEN}${MBPS} Mb/s${NC}"
+    echo -e "    End-to-end: ${GREEN}${E2E_THROUGHPUT} msg/s${NC}"
     echo ""
 
     # Append to output file
@@ -134,18 +261,469 @@ for size in "${MESSAGE_SIZES[@]}"; do
 
 **Latency:**
 - Average: ${LATENCY} us
+- 95% CI: ${LATENCY_CI:-n/a}
 - Message rate: ${MSG_RATE} msg/s
 
 **Throughput:**
 - Messages/sec: ${THROUGHPUT} msg/s
+- 95% CI: ${THROUGHPUT_CI:-n/a}
 - Megabits/sec: ${MBPS} Mb/s
+- End-to-end (sender clock): ${E2E_THROUGHPUT} msg/s
+
+EOF
+
+    # ===========================
+    # Receive path (message_t vs buffer)
+    # ===========================
+    if [ "$(uname -s)" = "Linux" ]; then
+        echo -e "${YELLOW}  [recv] Comparing message_t and buffer receive...${NC}"
+
+        bench thr "$size" "$THROUGHPUT_MESSAGES" --recv message --allocs > /tmp/recv_message.txt 2>&1
+        bench thr "$size" "$THROUGHPUT_MESSAGES" --recv buffer --allocs > /tmp/recv_buffer.txt 2>&1
+
+        MESSAGE_RATE=$(grep "^Throughput:" /tmp/recv_message.txt | head -n 1 | awk '{print $2}')
+        MESSAGE_ALLOCS=$(grep "^Allocations:" /tmp/recv_message.txt | awk '{print $2}')
+        BUFFER_RATE=$(grep "^Throughput:" /tmp/recv_buffer.txt | head -n 1 | awk '{print $2}')
+        BUFFER_ALLOCS=$(grep "^Allocations:" /tmp/recv_buffer.txt | awk '{print $2}')
+
+        echo -e "    message_t: ${GREEN}${MESSAGE_RATE} msg/s${NC}, ${MESSAGE_ALLOCS} allocs/msg"
+        echo -e "    buffer:    ${GREEN}${BUFFER_RATE} msg/s${NC}, ${BUFFER_ALLOCS} allocs/msg"
+        echo ""
+
+        cat >> "$OUTPUT_FILE" << EOF
+**Receive path (receiver process, allocation counting on):**
+- recv(message_t): ${MESSAGE_RATE} msg/s, ${MESSAGE_ALLOCS} allocations/message
+- recv(mutable_buffer): ${BUFFER_RATE} msg/s, ${BUFFER_ALLOCS} allocations/message
 
 EOF
+    fi
+
+    # ===========================
+    # Raw C API (cppzmq overhead)
+    # ===========================
+    if [ "$HAVE_RAW_API" -eq 1 ]; then
+        echo -e "${YELLOW}  [api] Running raw libzmq C API build...${NC}"
+
+        raw_bench() {
+            "$BUILD_DIR/zmqbench_raw" "$1" --role client --control "tcp://127.0.0.1:${RAW_CONTROL_PORT}" \
+                --endpoint "tcp://localhost:${RAW_DATA_PORT}" --size "$2" --count "$3" \
+                --trials "$TRIALS" ${TARGET_CI:+--target-ci "$TARGET_CI" --max-trials "$MAX_TRIALS"}
+        }
+        raw_bench lat "$size" "$LATENCY_ROUNDS" > /tmp/raw_lat.txt 2>&1
+        raw_bench thr "$size" "$THROUGHPUT_MESSAGES" > /tmp/raw_thr.txt 2>&1
+
+        RAW_LATENCY=$(grep "Average latency:" /tmp/raw_lat.txt | awk '{print $3}')
+        RAW_THROUGHPUT=$(grep "^Throughput:" /tmp/raw_thr.txt | head -n 1 | awk '{print $2}')
+
+        echo -e "    Latency: ${GREEN}${RAW_LATENCY} us${NC}"
+        echo -e "    Throughput: ${GREEN}${RAW_THROUGHPUT} msg/s${NC}"
+        echo ""
+
+        {
+            echo "**Raw libzmq C API (same kernels without cppzmq):**"
+            echo "- Latency: ${RAW_LATENCY} us ($(trial_ci /tmp/raw_lat.txt us))"
+            echo "- Messages/sec: ${RAW_THROUGHPUT} msg/s ($(trial_ci /tmp/raw_thr.txt msg/s))"
+            awk -v cpp="$LATENCY" -v raw="$RAW_LATENCY" \
+                'BEGIN { printf "- cppzmq latency overhead (cppzmq - C API): %.3f us\n", cpp - raw }'
+            awk -v cpp="$THROUGHPUT" -v raw="$RAW_THROUGHPUT" \
+                'BEGIN { printf "- cppzmq throughput vs C API: %.1f%%\n", 100 * cpp / raw }'
+            echo ""
+        } >> "$OUTPUT_FILE"
+    fi
+
+    # ===========================
+    # ZMQ_STREAM (ZMTP overhead)
+    # ===========================
+    if [ "$HAVE_STREAM" -eq 1 ]; then
+        echo -e "${YELLOW}  [stream] Running ZMQ_STREAM tests...${NC}"
+
+        # The STREAM clients wait for the connect notification, so no sleep is needed
+        "$BUILD_DIR/local_lat_stream" "tcp://*:${STREAM_LAT_PORT}" "$size" "$LATENCY_ROUNDS" > /tmp/stream_lat_local.txt 2>&1 &
+        LOCAL_LAT_PID=$!
+        "$BUILD_DIR/remote_lat_stream" "tcp://localhost:${STREAM_LAT_PORT}" "$size" "$LATENCY_ROUNDS" > /tmp/stream_lat_remote.txt 2>&1
+        wait $LOCAL_LAT_PID
+
+        "$BUILD_DIR/local_thr_stream" "tcp://*:${STREAM_THR_PORT}" "$size" "$THROUGHPUT_MESSAGES" > /tmp/stream_thr_local.txt 2>&1 &
+        LOCAL_THR_PID=$!
+        "$BUILD_DIR/remote_thr_stream" "tcp://localhost:${STREAM_THR_PORT}" "$size" "$THROUGHPUT_MESSAGES" > /tmp/stream_thr_remote.txt 2>&1
+        wait $LOCAL_THR_PID
+
+        STREAM_LATENCY=$(grep "Average latency:" /tmp/stream_lat_remote.txt | awk '{print $3}')
+        STREAM_THROUGHPUT=$(grep "Throughput:" /tmp/stream_thr_local.txt | head -n 1 | awk '{print $2}')
+        STREAM_MBPS=$(grep "Throughput:" /tmp/stream_thr_local.txt | tail -n 1 | awk '{print $2}')
+
+        echo -e "    Latency: ${GREEN}${STREAM_LATENCY} us${NC}"
+        echo -e "    Throughput: ${GREEN}${STREAM_THROUGHPUT} msg/s${NC}"
+        echo ""
+
+        {
+            echo "**ZMQ_STREAM (raw TCP through libzmq, 4-byte length framing):**"
+            echo "- Latency: ${STREAM_LATENCY} us"
+            echo "- Messages/sec: ${STREAM_THROUGHPUT} msg/s"
+            echo "- Megabits/sec: ${STREAM_MBPS} Mb/s"
+            awk -v zmtp="$LATENCY" -v raw="$STREAM_LATENCY" \
+                'BEGIN { printf "- ZMTP latency overhead (REQ/REP - STREAM): %.2f us\n", zmtp - raw }'
+            awk -v zmtp="$THROUGHPUT" -v raw="$STREAM_THROUGHPUT" \
+                'BEGIN { printf "- PUSH/PULL throughput vs STREAM: %.1f%%\n", 100 * zmtp / raw }'
+            echo ""
+        } >> "$OUTPUT_FILE"
+    fi
+
+    # ===========================
+    # Async layer (epoll + coroutines)
+    # ===========================
+    if [ "$HAVE_ASYNC" -eq 1 ]; then
+        echo -e "${YELLOW}  [async] Running blocking and async executables...${NC}"
+
+        # Both variants as one-shot process pairs, so only the I/O style differs.
+        # Their records are tagged so the one-shot blocking runs stay out of the
+        # persistent-server lat/thr samples that regress.py and compare.py use.
+        # async_pair <local> <remote> <port> <count> <prefix>
+        async_pair() {
+            : > "/tmp/$5_local.txt"  # no stale "Listening on" from the last size
+            ZMQ_BENCH_SUITE=async "$BUILD_DIR/$1" "tcp://*:$3" "$size" "$4" > "/tmp/$5_local.txt" 2>&1 &
+            local local_pid=$!
+            wait_for_line "/tmp/$5_local.txt" "^Listening on"
+            ZMQ_BENCH_SUITE=async "$BUILD_DIR/$2" "tcp://localhost:$3" "$size" "$4" > "/tmp/$5_remote.txt" 2>&1
+            wait $local_pid
+        }
+        async_pair local_lat remote_lat "$ASYNC_LAT_PORT" "$LATENCY_ROUNDS" blocking_lat
+        async_pair local_lat_async remote_lat_async "$ASYNC_LAT_PORT" "$LATENCY_ROUNDS" async_lat
+        async_pair local_thr remote_thr "$ASYNC_THR_PORT" "$THROUGHPUT_MESSAGES" blocking_thr
+        async_pair local_thr_async remote_thr_async "$ASYNC_THR_PORT" "$THROUGHPUT_MESSAGES" async_thr
+
+        BLOCKING_LATENCY=$(grep "Average latency:" /tmp/blocking_lat_remote.txt | awk '{print $3}')
+        ASYNC_LATENCY=$(grep "Average latency:" /tmp/async_lat_remote.txt | awk '{print $3}')
+        BLOCKING_THROUGHPUT=$(grep "Throughput:" /tmp/blocking_thr_local.txt | head -n 1 | awk '{print $2}')
+        ASYNC_THROUGHPUT=$(grep "Throughput:" /tmp/async_thr_local.txt | head -n 1 | awk '{print $2}')
+        ASYNC_WAKEUPS=$(grep "Epoll wakeups:" /tmp/async_thr_local.txt | awk '{print $3}')
+
+        echo -e "    Latency: ${GREEN}${ASYNC_LATENCY} us${NC} (blocking ${BLOCKING_LATENCY} us)"
+        echo -e "    Throughput: ${GREEN}${ASYNC_THROUGHPUT} msg/s${NC} (blocking ${BLOCKING_THROUGHPUT} msg/s)"
+        echo ""
+
+        {
+            echo "**Async (edge-triggered epoll on ZMQ_FD, C++20 coroutines) vs blocking:**"
+            echo "- Latency: ${ASYNC_LATENCY} us (blocking: ${BLOCKING_LATENCY} us)"
+            echo "- Messages/sec: ${ASYNC_THROUGHPUT} msg/s (blocking: ${BLOCKING_THROUGHPUT} msg/s)"
+            echo "- Receiver epoll wakeups: ${ASYNC_WAKEUPS} per message"
+            awk -v async="$ASYNC_LATENCY" -v blocking="$BLOCKING_LATENCY" \
+                'BEGIN { printf "- Async latency overhead (async - blocking): %.3f us\n", async - blocking }'
+            awk -v async="$ASYNC_THROUGHPUT" -v blocking="$BLOCKING_THROUGHPUT" \
+                'BEGIN { printf "- Async throughput vs blocking: %.1f%%\n", 100 * async / blocking }'
+            echo ""
+        } >> "$OUTPUT_FILE"
+    fi
+
+    # ===========================
+    # Socket Pattern Matrix
+    # ===========================
+    echo -e "${YELLOW}  [patterns] Running lat/thr over every socket pattern...${NC}"
+
+    # One process per size; lat and thr both run LATENCY_ROUNDS messages
+    "$BUILD_DIR/zmqbench" patterns --endpoint "tcp://127.0.0.1:${PATTERNS_PORT}" --size "$size" \
+        --count "$LATENCY_ROUNDS" > /tmp/patterns.txt 2>&1
+
+    sed -n '/^Pattern /,/^Latency is one-way/p' /tmp/patterns.txt | sed 's/^/    /'
+    echo ""
+
+    {
+        echo "**Socket pattern matrix (tcp, ${LATENCY_ROUNDS} messages per test):**"
+        echo ""
+        echo "\`\`\`"
+        sed -n '/^Pattern /,/^Latency is one-way/p' /tmp/patterns.txt
+        echo "\`\`\`"
+        echo ""
+    } >> "$OUTPUT_FILE"
+
+    # ===========================
+    # Full-Duplex Throughput
+    # ===========================
+    echo -e "${YELLOW}  [duplex] Running DEALER/DEALER in both directions...${NC}"
+
+    "$BUILD_DIR/zmqbench" duplex --endpoint "tcp://127.0.0.1:${DUPLEX_PORT}" --size "$size" \
+        --count "$DUPLEX_MESSAGES" > /tmp/duplex.txt 2>&1
+
+    DUPLEX_ONE_WAY=$(grep "One direction alone" /tmp/duplex.txt | awk '{print $(NF-1)}')
+    DUPLEX_C2S=$(grep "Duplex client -> server:" /tmp/duplex.txt | awk '{print $5}')
+    DUPLEX_S2C=$(grep "Duplex server -> client:" /tmp/duplex.txt | awk '{print $5}')
+    DUPLEX_AGGREGATE=$(grep "Aggregate throughput:" /tmp/duplex.txt | awk '{print $3}')
+    DUPLEX_CPU=$(grep "I/O thread CPU" /tmp/duplex.txt | awk -F': ' '{print $2}')
 
-    # Small delay between tests
-    sleep 1
+    echo -e "    Aggregate: ${GREEN}${DUPLEX_AGGREGATE} msg/s${NC} (one direction alone ${DUPLEX_ONE_WAY} msg/s)"
+    echo ""
+
+    {
+        echo "**Full-duplex DEALER/DEALER (${DUPLEX_MESSAGES} messages each way, one connection):**"
+        echo "- One direction alone: ${DUPLEX_ONE_WAY} msg/s"
+        echo "- Duplex client -> server: ${DUPLEX_C2S} msg/s, server -> client: ${DUPLEX_S2C} msg/s"
+        echo "- Aggregate: ${DUPLEX_AGGREGATE} msg/s"
+        awk -v duplex="$DUPLEX_C2S" -v alone="$DUPLEX_ONE_WAY" \
+            'BEGIN { printf "- Per-direction rate vs one direction alone: %.1f%%\n", 100 * duplex / alone }'
+        echo "- I/O thread CPU (both sides, one process): ${DUPLEX_CPU}"
+        echo ""
+    } >> "$OUTPUT_FILE"
+
+    # ===========================
+    # Proxy Hop
+    # ===========================
+    echo -e "${YELLOW}  [proxy] Running lat/thr through zmq::proxy, zmq_proxy_steerable and a batching forwarder...${NC}"
+
+    "$BUILD_DIR/zmqbench" proxy --endpoint "tcp://127.0.0.1:${PROXY_PORT}" --size "$size" \
+        --count "$LATENCY_ROUNDS" > /tmp/proxy.txt 2>&1
+
+    sed -n '/^Path /,/^Batching forwarder/p' /tmp/proxy.txt | sed 's/^/    /'
+    echo ""
+
+    {
+        echo "**Proxy hop (REQ/ROUTER|DEALER/REP and PUSH/PULL|PUSH/PULL, ${LATENCY_ROUNDS} messages per test):**"
+        echo ""
+        echo "\`\`\`"
+        sed -n '/^Path /,/^Batching forwarder/p' /tmp/proxy.txt
+        echo "\`\`\`"
+        echo ""
+    } >> "$OUTPUT_FILE"
+
+    # ===========================
+    # Pipeline Chain
+    # ===========================
+    echo -e "${YELLOW}  [chain] Running PULL -> PUSH pipelines of 3 and 8 stages (threads, inproc)...${NC}"
+
+    "$BUILD_DIR/zmqbench" chain --endpoint "inproc://zmqbench-chain" --stages 3,8 --size "$size" \
+        --count "$CHAIN_MESSAGES" > /tmp/chain.txt 2>&1
+
+    grep -E "^(Stages|End-to-end throughput|Bottleneck):" /tmp/chain.txt | sed 's/^/    /'
+    echo ""
+
+    {
+        echo "**Pipeline chain (source -> N x PULL/PUSH stage -> sink, ${CHAIN_MESSAGES} messages):**"
+        echo ""
+        echo "\`\`\`"
+        sed -n '/^Stages:/,/^Bottleneck:/p' /tmp/chain.txt
+        echo "\`\`\`"
+        echo ""
+    } >> "$OUTPUT_FILE"
+
+    # ===========================
+    # Majordomo broker
+    # ===========================
+    echo -e "${YELLOW}  [mdp] Running RPC through a Majordomo broker...${NC}"
+
+    "$BUILD_DIR/zmqbench" mdp --endpoint "tcp://127.0.0.1:${MDP_PORT}" --size "$size" \
+        --workers 1,4,16 --services 1,4 --heartbeat 10,2500 --count "$LATENCY_ROUNDS" > /tmp/mdp.txt 2>&1
+
+    sed -n '/^ *Workers /,/^RPC latency is/p' /tmp/mdp.txt | sed 's/^/    /'
+    echo ""
+
+    {
+        echo "**Majordomo broker (4 clients, one request in flight each, ${LATENCY_ROUNDS} RPCs per run):**"
+        echo ""
+        echo "\`\`\`"
+        sed -n '/^ *Workers /,/^RPC latency is/p' /tmp/mdp.txt
+        grep "^Warning:" /tmp/mdp.txt || true
+        echo "\`\`\`"
+        echo ""
+    } >> "$OUTPUT_FILE"
+
+    # ===========================
+    # Reliable request-reply (Lazy / Paranoid Pirate)
+    # ===========================
+    echo -e "${YELLOW}  [pirate] Running Lazy and Paranoid Pirate with 1% dropped, 1% delayed requests...${NC}"
+
+    "$BUILD_DIR/zmqbench" pirate --endpoint "tcp://127.0.0.1:${PIRATE_PORT}" --size "$size" \
+        --count "$PIRATE_REQUESTS" > /tmp/pirate.txt 2>&1
+
+    sed -n '/^Server side /,/^timeout to the reply/p' /tmp/pirate.txt | sed 's/^/    /'
+    echo ""
+
+    {
+        echo "**Reliable request-reply (Lazy / Paranoid Pirate, ${PIRATE_REQUESTS} requests, 1% dropped, 1% delayed 200 ms):**"
+        echo ""
+        echo "\`\`\`"
+        sed -n '/^Server side /,/^timeout to the reply/p' /tmp/pirate.txt
+        echo "\`\`\`"
+        echo ""
+    } >> "$OUTPUT_FILE"
+
+    # ===========================
+    # Scatter-gather tail latency
+    # ===========================
+    echo -e "${YELLOW}  [scatter] Running scatter-gather to 1..64 servers (exp:100 us service time)...${NC}"
+
+    "$BUILD_DIR/zmqbench" scatter --endpoint "tcp://127.0.0.1:${SCATTER_PORT}" --size "$size" \
+        --gather dealer --fanout 1,4,16,64 --service-time exp:100 \
+        --count "$SCATTER_REQUESTS" > /tmp/scatter.txt 2>&1
+
+    sed -n '/^ *K /,/^Latency is request/p' /tmp/scatter.txt | sed 's/^/    /'
+    echo ""
+
+    {
+        echo "**Scatter-gather (one DEALER per server, exponential 100 us service time, ${SCATTER_REQUESTS} requests per fan-out):**"
+        echo ""
+        echo "\`\`\`"
+        sed -n '/^ *K /,/^Latency is request/p' /tmp/scatter.txt
+        echo "\`\`\`"
+        echo ""
+    } >> "$OUTPUT_FILE"
+
+    # ===========================
+    # Connection scaling
+    # ===========================
+    # Several N in one process: each N has to start from a clean socket table
+    echo -e "${YELLOW}  [conns] Running 1, 100 and 1000 DEALER connections to one ROUTER...${NC}"
+
+    "$BUILD_DIR/zmqbench" conns --endpoint "tcp://127.0.0.1:${CONNS_PORT}" --size "$size" \
+        --sockets 1,100,1000 --count "$CONNS_REQUESTS" > /tmp/conns.txt 2>&1
+
+    grep -E '^(Connections|Throughput|Latency)' /tmp/conns.txt | sed 's/^/    /'
+    echo ""
+
+    {
+        echo "**Connection scaling (N DEALER connections to one ROUTER echo, ${CONNS_REQUESTS} requests per N):**"
+        echo ""
+        echo "\`\`\`"
+        grep -E '^(Connections|Throughput|Latency|Process)' /tmp/conns.txt
+        echo "\`\`\`"
+        echo ""
+    } >> "$OUTPUT_FILE"
+
+    # ===========================
+    # CURVE encryption
+    # ===========================
+    if [ "$HAVE_CURVE" -eq 1 ]; then
+        echo -e "${YELLOW}  [curve] Running plaintext and CURVE executables...${NC}"
+
+        # One-shot process pairs; wait for the server's "Listening on" line, and
+        # with CURVE for the public key the remote side needs. Records are
+        # tagged so the plaintext runs stay out of the lat/thr samples.
+        # curve_pair <local> <remote> <port> <count> <prefix> <null|curve>
+        curve_pair() {
+            local mode_arg="" ready="^Listening on" key=""
+            if [ "$6" = "curve" ]; then
+                mode_arg="curve"
+                ready="CURVE server key:"
+            fi
+            : > "/tmp/$5_local.txt"  # no stale output from the last size
+            ZMQ_BENCH_SUITE=curve "$BUILD_DIR/$1" "tcp://*:$3" "$size" "$4" $mode_arg > "/tmp/$5_local.txt" 2>&1 &
+            local local_pid=$!
+            wait_for_line "/tmp/$5_local.txt" "$ready"
+            if [ "$6" = "curve" ]; then
+                key=$(grep "CURVE server key:" "/tmp/$5_local.txt" | awk '{print $4}')
+            fi
+            ZMQ_BENCH_SUITE=curve "$BUILD_DIR/$2" "tcp://localhost:$3" "$size" "$4" $key > "/tmp/$5_remote.txt" 2>&1
+            wait $local_pid
+        }
+        curve_pair local_lat remote_lat "$CURVE_LAT_PORT" "$LATENCY_ROUNDS" plain_lat null
+        curve_pair local_lat remote_lat "$CURVE_LAT_PORT" "$LATENCY_ROUNDS" curve_lat curve
+        curve_pair local_thr remote_thr "$CURVE_THR_PORT" "$CURVE_MESSAGES" plain_thr null
+        curve_pair local_thr remote_thr "$CURVE_THR_PORT" "$CURVE_MESSAGES" curve_thr curve
+
+        PLAIN_LATENCY=$(grep "Average latency:" /tmp/plain_lat_remote.txt | awk '{print $3}')
+        CURVE_LATENCY=$(grep "Average latency:" /tmp/curve_lat_remote.txt | awk '{print $3}')
+        PLAIN_THROUGHPUT=$(grep "Throughput:" /tmp/plain_thr_local.txt | head -n 1 | awk '{print $2}')
+        CURVE_THROUGHPUT=$(grep "Throughput:" /tmp/curve_thr_local.txt | head -n 1 | awk '{print $2}')
+
+        echo -e "    Latency: ${GREEN}${CURVE_LATENCY} us${NC} (plaintext ${PLAIN_LATENCY} us)"
+        echo -e "    Throughput: ${GREEN}${CURVE_THROUGHPUT} msg/s${NC} (plaintext ${PLAIN_THROUGHPUT} msg/s)"
+        echo ""
+
+        {
+            echo "**CURVE encryption vs plaintext (${CURVE_MESSAGES} messages for throughput):**"
+            echo "- Latency: ${CURVE_LATENCY} us (plaintext: ${PLAIN_LATENCY} us)"
+            echo "- Messages/sec: ${CURVE_THROUGHPUT} msg/s (plaintext: ${PLAIN_THROUGHPUT} msg/s)"
+            awk -v curve="$CURVE_LATENCY" -v plain="$PLAIN_LATENCY" \
+                'BEGIN { printf "- CURVE latency overhead (curve - plaintext): %.3f us\n", curve - plain }'
+            awk -v curve="$CURVE_THROUGHPUT" -v plain="$PLAIN_THROUGHPUT" \
+                'BEGIN { printf "- Throughput loss: %.1f%%\n", 100 * (1 - curve / plain) }'
+            awk -v curve="$CURVE_THROUGHPUT" -v plain="$PLAIN_THROUGHPUT" \
+                'BEGIN { printf "- Per-message encryption cost: %.3f us\n", 1000000 / curve - 1000000 / plain }'
+            echo ""
+        } >> "$OUTPUT_FILE"
+    fi
+
+    # ===========================
+    # Raw TCP io_uring Baseline
+    # ===========================
+    if [ "$HAVE_URING" -eq 1 ]; then
+        echo -e "${YELLOW}  [raw] Running io_uring TCP baseline...${NC}"
+
+        # The raw clients retry connect() until the server listens, so no sleep is needed
+        "$BUILD_DIR/local_lat_uring" "tcp://*:${URING_LAT_PORT}" "$size" "$LATENCY_ROUNDS" > /tmp/uring_lat_local.txt 2>&1 &
+        LOCAL_LAT_PID=$!
+        "$BUILD_DIR/remote_lat_uring" "tcp://127.0.0.1:${URING_LAT_PORT}" "$size" "$LATENCY_ROUNDS" > /tmp/uring_lat_remote.txt 2>&1
+        wait $LOCAL_LAT_PID
+
+        "$BUILD_DIR/local_thr_uring" "tcp://*:${URING_THR_PORT}" "$size" "$THROUGHPUT_MESSAGES" > /tmp/uring_thr_local.txt 2>&1 &
+        LOCAL_THR_PID=$!
+        "$BUILD_DIR/remote_thr_uring" "tcp://127.0.0.1:${URING_THR_PORT}" "$size" "$THROUGHPUT_MESSAGES" > /tmp/uring_thr_remote.txt 2>&1
+        wait $LOCAL_THR_PID
+
+        URING_LATENCY=$(grep "Average latency:" /tmp/uring_lat_remote.txt | awk '{print $3}')
+        URING_THROUGHPUT=$(grep "Throughput:" /tmp/uring_thr_local.txt | head -n 1 | awk '{print $2}')
+        URING_MBPS=$(grep "Throughput:" /tmp/uring_thr_local.txt | tail -n 1 | awk '{print $2}')
+
+        echo -e "    Latency: ${GREEN}${URING_LATENCY} us${NC}"
+        echo -e "    Throughput: ${GREEN}${URING_THROUGHPUT} msg/s${NC}"
+        echo ""
+
+        cat >> "$OUTPUT_FILE" << EOF
+**Raw TCP baseline (io_uring, no ZeroMQ):**
+- Latency: ${URING_LATENCY} us
+- Messages/sec: ${URING_THROUGHPUT} msg/s
+- Megabits/sec: ${URING_MBPS} Mb/s
+
+EOF
+    fi
+
+    # ===========================
+    # Co-located Ceilings
+    # ===========================
+    if [ "$HAVE_SHM" -eq 1 ]; then
+        echo -e "${YELLOW}  [ceil] Running inproc/ipc and shared-memory ceilings...${NC}"
+
+        "$BUILD_DIR/inproc_thr" "$size" "$THROUGHPUT_MESSAGES" > /tmp/inproc_thr.txt 2>&1
+        INPROC_THROUGHPUT=$(grep "Throughput:" /tmp/inproc_thr.txt | head -n 1 | awk '{print $2}')
+
+        "$BUILD_DIR/zmqbench" thr --role client --control "tcp://127.0.0.1:${IPC_CONTROL_PORT}" \
+            --endpoint "ipc://${IPC_PATH}" --size "$size" --count "$THROUGHPUT_MESSAGES" > /tmp/ipc_thr.txt 2>&1
+        IPC_THROUGHPUT=$(grep "^Throughput:" /tmp/ipc_thr.txt | head -n 1 | awk '{print $2}')
+
+        # The shm producer waits for the consumer to create the ring
+        "$BUILD_DIR/local_thr_shm" "$SHM_RING" "$size" "$THROUGHPUT_MESSAGES" > /tmp/shm_thr_local.txt 2>&1 &
+        LOCAL_THR_PID=$!
+        "$BUILD_DIR/remote_thr_shm" "$SHM_RING" "$size" "$THROUGHPUT_MESSAGES" > /dev/null 2>&1
+        wait $LOCAL_THR_PID
+        SHM_THROUGHPUT=$(grep "Throughput:" /tmp/shm_thr_local.txt | head -n 1 | awk '{print $2}')
+
+        "$BUILD_DIR/memcpy_thr" "$size" "$THROUGHPUT_MESSAGES" > /tmp/memcpy_thr.txt 2>&1
+        MEMCPY_THROUGHPUT=$(grep "Throughput:" /tmp/memcpy_thr.txt | head -n 1 | awk '{print $2}')
+
+        echo -e "    SHM ring: ${GREEN}${SHM_THROUGHPUT} msg/s${NC}, memcpy: ${GREEN}${MEMCPY_THROUGHPUT} msg/s${NC}"
+        echo ""
+
+        {
+            echo "**Co-located ceilings (throughput as a fraction of shared memory and memcpy):**"
+            echo ""
+            echo "| Path | Messages/sec | % of SHM ring | % of memcpy |"
+            echo "|------|--------------|---------------|-------------|"
+            for row in "memcpy:${MEMCPY_THROUGHPUT}" "SHM SPSC ring:${SHM_THROUGHPUT}" \
+                       "ZMQ inproc:${INPROC_THROUGHPUT}" "ZMQ ipc:${IPC_THROUGHPUT}" "ZMQ tcp:${THROUGHPUT}"; do
+                awk -v name="${row%%:*}" -v value="${row#*:}" -v shm="$SHM_THROUGHPUT" -v mem="$MEMCPY_THROUGHPUT" \
+                    'BEGIN { printf "| %s | %.0f | %.1f%% | %.2f%% |\n", name, value, 100 * value / shm, 100 * value / mem }'
+            done
+            echo ""
+        } >> "$OUTPUT_FILE"
+    fi
 done
 
+# Stop the persistent servers
+"$BUILD_DIR/zmqbench" stop --control "tcp://127.0.0.1:${CONTROL_PORT}" > /dev/null
+"$BUILD_DIR/zmqbench" stop --control "tcp://127.0.0.1:${IPC_CONTROL_PORT}" > /dev/null
+if [ "$HAVE_RAW_API" -eq 1 ]; then
+    "$BUILD_DIR/zmqbench" stop --control "tcp://127.0.0.1:${RAW_CONTROL_PORT}" > /dev/null
+fi
+wait $SERVE_PID $IPC_SERVE_PID
+
 # Add footer to output file
 cat >> "$OUTPUT_FILE" << EOF
 
@@ -153,8 +731,59 @@ cat >> "$OUTPUT_FILE" << EOF
 
 - Latency is measured as round-trip time divided by 2 (one-way latency)
 - Throughput measurement excludes the first message (warm-up)
+- Latency and throughput run against a persistent \`zmqbench serve\` process;
+  readiness and completion are confirmed over its control channel instead of
+  fixed sleeps. End-to-end throughput runs on the sender's clock until the
+  receiver confirms the last message
 - All tests use inproc or tcp://localhost for consistency
 - Built with: \`-O3 -march=native -flto\`
+- The async runs compare one-shot process pairs of the blocking and the
+  async executables; the async side tries every send/recv non-blocking
+  first and parks the coroutine on epoll only when it would block
+- The CURVE runs compare one-shot process pairs with and without
+  encryption; the server generates a keypair at startup and the client
+  connects with its public key. Throughput uses 1/50 of the message count
+- The socket pattern matrix runs the lat and thr kernels in one process per
+  pattern; ROUTERs use ROUTER_MANDATORY and publishers XPUB_NODROP, so no
+  pattern drops messages at the high-water mark
+- The full-duplex runs stream over one DEALER/DEALER connection from a
+  single zmq_poll loop per side (a socket belongs to one thread); both sides
+  share one process and one libzmq I/O thread
+- The proxy hop runs the unchanged lat and thr kernels direct and through a
+  proxy thread (zmq::proxy, zmq_proxy_steerable, and a forwarder that moves
+  up to 256 messages per side per poll); client, proxy and server each have
+  their own context, so the "Added" column is the cost of the hop
+- The pipeline chains run every stage as a thread of one process over
+  inproc; hop latencies come from timestamps carried in each message, and
+  the bottleneck is the element busy (neither starved nor blocked) for the
+  largest share of its window
+- The Majordomo runs put broker, workers and clients in one process over
+  tcp; broker CPU is the broker thread's share of one core, and at 100% the
+  broker is the limit
+- The Pirate runs inject failures on the server side (dropped requests;
+  in paranoid mode the worker crashes and restarts) and retry on a fresh
+  REQ socket after each timeout; latency includes the retries
+- The scatter runs complete each request on the last of K replies; servers
+  sleep for their service time, so with one core the growth in p99 is the
+  max-of-K effect plus scheduling, not CPU contention
+- The connection scaling runs open N DEALER sockets in the same process as
+  the ROUTER echo, so RSS and fds per connection cover both ends; latency
+  is request to reply behind the other N-1 requests of the round
+- The receive path runs count every heap allocation in the receiver (libzmq
+  included); recv(mutable_buffer) copies into one preallocated buffer, so
+  what remains is libzmq's own decoder allocation
+- The raw C API runs use \`zmqbench_raw\`, built from the same sources with
+  the timed loops on zmq_msg_init_size/zmq_msg_send/zmq_msg_recv instead of
+  cppzmq; the gap to the main results is cppzmq's own cost
+- ZMQ_STREAM runs carry no ZMTP greeting or frame headers; messages use a
+  4-byte length prefix and are reassembled by the application, so the gap to
+  REQ/REP and PUSH/PULL is the cost of the ZMTP protocol layer
+- The raw TCP baseline (Linux only) uses io_uring multishot recv with a provided
+  buffer ring, batched sends, and IORING_OP_SEND_ZC from a registered buffer
+  for payloads of 16 KB and above when the kernel supports it
+- Co-located ceilings: the SHM ring is a cross-process SPSC ring in /dev/shm
+  (one copy in, one copy out); memcpy is a single copy per message into an
+  arena of the same footprint
 
 ## Raw Test Output
 
@@ -165,16 +794,24 @@ $(cat /tmp/lat_remote.txt)
 
 ### Throughput Test (Last Run)
 \`\`\`
-$(cat /tmp/thr_local.txt)
+$(cat /tmp/thr_remote.txt)
 \`\`\`
 EOF
 
 # Cleanup temp files
-rm -f /tmp/lat_local.txt /tmp/lat_remote.txt /tmp/thr_local.txt /tmp/thr_remote.txt
+rm -f /tmp/lat_remote.txt /tmp/thr_remote.txt /tmp/zmqbench_serve.txt /tmp/zmqbench_serve_ipc.txt
+rm -f /tmp/raw_lat.txt /tmp/raw_thr.txt /tmp/zmqbench_serve_raw.txt
+rm -f /tmp/recv_message.txt /tmp/recv_buffer.txt /tmp/patterns.txt /tmp/duplex.txt /tmp/proxy.txt /tmp/chain.txt /tmp/mdp.txt /tmp/pirate.txt /tmp/scatter.txt /tmp/conns.txt
+rm -f /tmp/blocking_lat_*.txt /tmp/async_lat_*.txt /tmp/blocking_thr_*.txt /tmp/async_thr_*.txt
+rm -f /tmp/plain_lat_*.txt /tmp/curve_lat_*.txt /tmp/plain_thr_*.txt /tmp/curve_thr_*.txt
+rm -f /tmp/stream_lat_local.txt /tmp/stream_lat_remote.txt /tmp/stream_thr_local.txt /tmp/stream_thr_remote.txt
+rm -f /tmp/uring_lat_local.txt /tmp/uring_lat_remote.txt /tmp/uring_thr_local.txt /tmp/uring_thr_remote.txt
+rm -f /tmp/inproc_thr.txt /tmp/ipc_thr.txt /tmp/shm_thr_local.txt /tmp/memcpy_thr.txt "$IPC_PATH"
 
 echo -e "${GREEN}=== Benchmark Complete ===${NC}"
 echo ""
 echo -e "Results saved to: ${GREEN}${OUTPUT_FILE}${NC}"
+echo -e "Records saved to: ${GREEN}${RECORDS_FILE}${NC}"
 echo ""
 
 # Display results
@@ -0,0 +1,344 @@
+/*
+ * Machine-readable benchmark records (JSON Lines or CSV).
+ *
+ * One record per measured configuration: full configuration, raw counters,
+ * rates, latency percentiles, environment and libzmq version. The flat keys
+ * size / latency_us / msg_per_sec / mbps match the per-size entries of
+ * docs/results/benchmark_data.json, so records can be aggregated without
+ * parsing the human-readable output.
+ *
+ * Standalone executables append to the file named by ZMQ_BENCH_OUTPUT (CSV
+ * when it ends in .csv, JSON Lines otherwise); zmqbench also takes
+ * --format/--output. ZMQ_BENCH_SUITE, when set, is stored as config "suite"
+ * in every appended JSON record, marking runs that only serve one section's
+ * comparison. Header-only and independent of libzmq so the raw baselines can
+ * use it too; callers that link libzmq fill zmq_version.
+ */
+
+#ifndef ZMQ_BENCHMARK_BENCH_OUTPUT_HPP
+#define ZMQ_BENCHMARK_BENCH_OUTPUT_HPP
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/utsname.h>
+#include <unistd.h>
+#endif
+
+namespace bench_output {
+
+constexpr int SCHEMA_VERSION = 2;
+
+struct record {
+    std::string benchmark;  // "lat", "thr", "thr_shm", "lat_uring", ...
+    std::string role;       // side that measured: "server", "client", "both"
+    std::string transport;  // "tcp", "ipc", "inproc", "shm", "memory"
+    std::string endpoint;
+    size_t size = 0;
+    long long count = 0;  // configured messages (thr) or roundtrips (lat)
+
+    // Raw counters of the measured phase
+    long long messages = 0;
+    double elapsed_us = 0.0;
+
+    // Rates; NAN when not measured by this record
+    double msg_per_sec = NAN;
+    double mbps = NAN;
+    double end_to_end_msg_per_sec = NAN;
+
+    // One-way latency in microseconds; NAN when not measured
+    double latency_us = NAN;
+    double min_us = NAN;
+    double p50_us = NAN;
+    double p90_us = NAN;
+    double p99_us = NAN;
+    double p999_us = NAN;
+    double max_us = NAN;
+    long long samples = 0;
+
+    // Repeated trials: the rates/latency above are then the median of the
+    // kept trials and [ci_low, ci_high] its confidence interval
+    long long trials = 0;
+    long long rejected_trials = 0;
+    double ci_low = NAN;
+    double ci_high = NAN;
+    double confidence = NAN;
+    std::vector<double> trial_values;  // headline value of every trial (JSON only)
+
+    std::string binding = "cppzmq";  // "none" for the raw baselines
+    std::string zmq_version;         // empty: not linked against libzmq
+
+    // Extra configuration (socket options, batch size, ...); values are JSON
+    std::vector<std::pair<std::string, std::string>> config;
+
+    void set(const std::string &key, long long value) {
+        config.emplace_back(key, std::to_string(value));
+    }
+    void set(const std::string &key, const std::string &value);
+};
+
+// --- JSON helpers ----------------------------------------------------------
+
+inline std::string json_string(const std::string &s) {
+    std::string out = "\"";
+    for (char c : s) {
+        switch (c) {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+                out += buf;
+            } else {
+                out += c;
+            }
+        }
+    }
+    return out + "\"";
+}
+
+inline std::string json_number(double value) {
+    if (!std::isfinite(value)) {
+        return "null";
+    }
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.10g", value);
+    return buf;
+}
+
+inline void record::set(const std::string &key, const std::string &value) {
+    config.emplace_back(key, json_string(value));
+}
+
+// --- Environment -----------------------------------------------------------
+
+struct environment {
+    std::string hostname;
+    std::string os;
+    std::string kernel;
+    std::string arch;
+    std::string compiler;
+    unsigned cpu_count = 0;
+    std::string timestamp;  // UTC, ISO 8601
+};
+
+inline environment current_environment() {
+    environment env;
+#ifdef _WIN32
+    const char *host = std::getenv("COMPUTERNAME");
+    const char *arch = std::getenv("PROCESSOR_ARCHITECTURE");
+    env.hostname = host ? host : "";
+    env.os = "Windows";
+    env.arch = arch ? arch : "";
+#else
+    char host[256] = {0};
+    if (gethostname(host, sizeof(host) - 1) == 0) {
+        env.hostname = host;
+    }
+    struct utsname uts;
+    if (uname(&uts) == 0) {
+        env.os = uts.sysname;
+        env.kernel = uts.release;
+        env.arch = uts.machine;
+    }
+#endif
+
+#if defined(__clang__)
+    env.compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+    env.compiler = "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    env.compiler = "msvc " + std::to_string(_MSC_VER);
+#endif
+
+    env.cpu_count = std::thread::hardware_concurrency();
+
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm utc{};
+#ifdef _WIN32
+    gmtime_s(&utc, &now);
+#else
+    gmtime_r(&now, &utc);
+#endif
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    env.timestamp = stamp;
+    return env;
+}
+
+// --- Formats ---------------------------------------------------------------
+
+inline std::string to_json(const record &r, const environment &env) {
+    std::ostringstream out;
+    out << "{\"schema\":" << SCHEMA_VERSION
+        << ",\"language\":\"C++\",\"binding\":" << json_string(r.binding)
+        << ",\"benchmark\":" << json_string(r.benchmark)
+        << ",\"role\":" << json_string(r.role)
+        << ",\"transport\":" << json_string(r.transport)
+        << ",\"endpoint\":" << json_string(r.endpoint)
+        << ",\"size\":" << r.size
+        << ",\"count\":" << r.count;
+
+    out << ",\"config\":{";
+    for (size_t i = 0; i < r.config.size(); i++) {
+        out << (i ? "," : "") << json_string(r.config[i].first) << ":" << r.config[i].second;
+    }
+    out << "}";
+
+    out << ",\"counters\":{\"messages\":" << r.messages
+        << ",\"bytes\":" << static_cast<long long>(r.messages) * static_cast<long long>(r.size)
+        << ",\"elapsed_us\":" << json_number(r.elapsed_us) << "}";
+
+    out << ",\"msg_per_sec\":" << json_number(r.msg_per_sec)
+        << ",\"mbps\":" << json_number(r.mbps)
+        << ",\"end_to_end_msg_per_sec\":" << json_number(r.end_to_end_msg_per_sec)
+        << ",\"latency_us\":" << json_number(r.latency_us);
+
+    if (r.samples > 0) {
+        out << ",\"percentiles_us\":{\"min\":" << json_number(r.min_us)
+            << ",\"p50\":" << json_number(r.p50_us)
+            << ",\"p90\":" << json_number(r.p90_us)
+            << ",\"p99\":" << json_number(r.p99_us)
+            << ",\"p99.9\":" << json_number(r.p999_us)
+            << ",\"max\":" << json_number(r.max_us)
+            << ",\"samples\":" << r.samples << "}";
+    }
+
+    if (r.trials > 0) {
+        out << ",\"trials\":{\"count\":" << r.trials
+            << ",\"rejected\":" << r.rejected_trials
+            << ",\"confidence\":" << json_number(r.confidence)
+            << ",\"ci_low\":" << json_number(r.ci_low)
+            << ",\"ci_high\":" << json_number(r.ci_high) << ",\"values\":[";
+        for (size_t i = 0; i < r.trial_values.size(); i++) {
+            out << (i ? "," : "") << json_number(r.trial_values[i]);
+        }
+        out << "]}";
+    }
+
+    out << ",\"environment\":{\"hostname\":" << json_string(env.hostname)
+        << ",\"os\":" << json_string(env.os)
+        << ",\"kernel\":" << json_string(env.kernel)
+        << ",\"arch\":" << json_string(env.arch)
+        << ",\"compiler\":" << json_string(env.compiler)
+        << ",\"cpu_count\":" << env.cpu_count << "}";
+
+    out << ",\"zmq_version\":" << (r.zmq_version.empty() ? "null" : json_string(r.zmq_version))
+        << ",\"timestamp\":" << json_string(env.timestamp) << "}";
+    return out.str();
+}
+
+// Fixed column set so rows from different benchmarks share one file
+inline std::string csv_header() {
+    return "benchmark,role,transport,endpoint,size,count,messages,bytes,elapsed_us,"
+           "msg_per_sec,mbps,end_to_end_msg_per_sec,latency_us,min_us,p50_us,p90_us,"
+           "p99_us,p999_us,max_us,samples,trials,rejected_trials,ci_low,ci_high,zmq_version,"
+           "hostname,os,kernel,arch,timestamp";
+}
+
+inline std::string csv_number(double value) {
+    return std::isfinite(value) ? json_number(value) : "";
+}
+
+inline std::string csv_field(const std::string &s) {
+    if (s.find_first_of(",\"\n") == std::string::npos) {
+        return s;
+    }
+    std::string out = "\"";
+    for (char c : s) {
+        out += c == '"' ? std::string("\"\"") : std::string(1, c);
+    }
+    return out + "\"";
+}
+
+inline std::string to_csv(const record &r, const environment &env) {
+    std::ostringstream out;
+    out << csv_field(r.benchmark) << "," << csv_field(r.role) << "," << csv_field(r.transport) << ","
+        << csv_field(r.endpoint) << "," << r.size << "," << r.count << "," << r.messages << ","
+        << static_cast<long long>(r.messages) * static_cast<long long>(r.size) << ","
+        << csv_number(r.elapsed_us) << "," << csv_number(r.msg_per_sec) << ","
+        << csv_number(r.mbps) << "," << csv_number(r.end_to_end_msg_per_sec) << ","
+        << csv_number(r.latency_us) << "," << csv_number(r.min_us) << ","
+        << csv_number(r.p50_us) << "," << csv_number(r.p90_us) << "," << csv_number(r.p99_us) << ","
+        << csv_number(r.p999_us) << "," << csv_number(r.max_us) << "," << r.samples << ","
+        << r.trials << "," << r.rejected_trials << "," << csv_number(r.ci_low) << ","
+        << csv_number(r.ci_high) << ","
+        << csv_field(r.zmq_version) << "," << csv_field(env.hostname) << "," << csv_field(env.os) << ","
+        << csv_field(env.kernel) << "," << csv_field(env.arch) << "," << csv_field(env.timestamp);
+    return out.str();
+}
+
+// Scheme of a ZeroMQ endpoint ("tcp" for tcp://host:port); empty without one
+inline std::string transport_of(const std::string &endpoint) {
+    size_t pos = endpoint.find("://");
+    return pos == std::string::npos ? std::string() : endpoint.substr(0, pos);
+}
+
+inline bool is_csv_path(const std::string &path) {
+    return path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+}
+
+// Appends one record; writes the CSV header first when the file is new or empty
+inline bool append(const std::string &path, record r) {
+    environment env = current_environment();
+    const char *suite = std::getenv("ZMQ_BENCH_SUITE");
+    if (suite && *suite) {
+        r.set("suite", std::string(suite));
+    }
+    bool csv = is_csv_path(path);
+
+    bool empty = true;
+    {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        empty = !in || in.tellg() <= 0;
+    }
+
+    std::ofstream out(path, std::ios::app);
+    if (!out) {
+        return false;
+    }
+    if (csv && empty) {
+        out << csv_header() << "\n";
+    }
+    out << (csv ? to_csv(r, env) : to_json(r, env)) << "\n";
+    return static_cast<bool>(out);
+}
+
+// Destination for standalone executables; empty when records are off
+inline std::string output_path_from_env() {
+    const char *path = std::getenv("ZMQ_BENCH_OUTPUT");
+    return path ? path : "";
+}
+
+// Appends to ZMQ_BENCH_OUTPUT when set; reports failures on stderr
+inline void emit(const record &r) {
+    std::string path = output_path_from_env();
+    if (!path.empty() && !append(path, r)) {
+        std::fprintf(stderr, "Warning: could not write result record to %s\n", path.c_str());
+    }
+}
+
+}  // namespace bench_output
+
+#endif  // ZMQ_BENCHMARK_BENCH_OUTPUT_HPP
@@ -0,0 +1,276 @@
+/*
+ * cppzmq API Overhead - Google Benchmark microbenchmarks
+ *
+ * Isolates the cost of the cppzmq wrappers from the transport: every
+ * send/recv benchmark runs over an inproc PAIR, one message per iteration,
+ * and changes only one side against a raw libzmq counterpart.
+ * - message_t construction by size: VSM (<= 33 bytes, stored inline in
+ *   zmq_msg_t) vs heap, with and without copying the payload
+ * - send: socket.send(buffer), send(message_t), raw zmq_send, zmq_msg_send
+ *   (receiver: raw zmq_recv)
+ * - recv: recv(message_t), recv(mutable_buffer), raw zmq_msg_recv, zmq_recv
+ *   (sender: raw zmq_send)
+ * - multipart: multipart_t, send/recv_multipart and raw ZMQ_SNDMORE loops
+ *
+ * Times are per operation (ns). Google Benchmark flags apply, e.g.
+ * --benchmark_filter=send --benchmark_format=json.
+ *
+ * Usage: ./cppzmq_micro [--benchmark_filter=REGEX] [--benchmark_repetitions=N]
+ * Example: ./cppzmq_micro --benchmark_filter=message_t
+ */
+
+#include <benchmark/benchmark.h>
+#include <zmq.hpp>
+#include <zmq_addon.hpp>
+
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Largest payload libzmq keeps inside zmq_msg_t (ZMQ_MAX_VSM_SIZE on 64-bit)
+constexpr size_t VSM_LIMIT = 33;
+
+// Connected inproc PAIR; the sender never runs ahead of the receiver by more
+// than one message, so queueing stays out of the numbers
+struct inproc_pair {
+    zmq::context_t context{1};
+    zmq::socket_t sender{context, zmq::socket_type::pair};
+    zmq::socket_t receiver{context, zmq::socket_type::pair};
+
+    inproc_pair() {
+        receiver.bind("inproc://cppzmq_micro");
+        sender.connect("inproc://cppzmq_micro");
+    }
+};
+
+// Labels by where libzmq stores each part; bytes/s counts every part
+void label_size(benchmark::State &state, size_t size, size_t parts = 1) {
+    state.SetLabel(size <= VSM_LIMIT ? "vsm" : "heap");
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size * parts));
+}
+
+void no_free(void *, void *) {}
+
+// --- message_t construction -------------------------------------------------
+
+void message_t_size(benchmark::State &state) {
+    size_t size = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        zmq::message_t msg(size);
+        benchmark::DoNotOptimize(msg.data());
+    }
+    label_size(state, size);
+}
+
+void message_t_copy(benchmark::State &state) {
+    size_t size = static_cast<size_t>(state.range(0));
+    std::vector<char> payload(size, 'X');
+    for (auto _ : state) {
+        zmq::message_t msg(payload.data(), size);
+        benchmark::DoNotOptimize(msg.data());
+    }
+    label_size(state, size);
+}
+
+void message_t_zero_copy(benchmark::State &state) {
+    size_t size = static_cast<size_t>(state.range(0));
+    std::vector<char> payload(size, 'X');
+    for (auto _ : state) {
+        zmq::message_t msg(payload.data(), size, no_free, nullptr);
+        benchmark::DoNotOptimize(msg.data());
+    }
+    label_size(state, size);
+    state.SetLabel("external");
+}
+
+void raw_zmq_msg_init_size(benchmark::State &state) {
+    size_t size = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        zmq_msg_t msg;
+        zmq_msg_init_size(&msg, size);
+        benchmark::DoNotOptimize(zmq_msg_data(&msg));
+        zmq_msg_close(&msg);
+    }
+    label_size(state, size);
+}
+
+// --- send (receiver: raw zmq_recv) -------------------------------------------
+
+struct send_buffer {
+    static void send(zmq::socket_t &socket, const std::vector<char> &payload) {
+        socket.send(zmq::buffer(payload), zmq::send_flags::none);
+    }
+};
+
+struct send_message {
+    static void send(zmq::socket_t &socket, const std::vector<char> &payload) {
+        zmq::message_t msg(payload.data(), payload.size());
+        socket.send(msg, zmq::send_flags::none);
+    }
+};
+
+struct raw_zmq_send {
+    static void send(zmq::socket_t &socket, const std::vector<char> &payload) {
+        zmq_send(socket.handle(), payload.data(), payload.size(), 0);
+    }
+};
+
+struct raw_zmq_msg_send {
+    static void send(zmq::socket_t &socket, const std::vector<char> &payload) {
+        zmq_msg_t msg;
+        zmq_msg_init_size(&msg, payload.size());
+        std::memcpy(zmq_msg_data(&msg), payload.data(), payload.size());
+        zmq_msg_send(&msg, socket.handle(), 0);
+    }
+};
+
+template <typename Sender>
+void send(benchmark::State &state) {
+    size_t size = static_cast<size_t>(state.range(0));
+    inproc_pair pair;
+    std::vector<char> payload(size, 'X');
+    std::vector<char> sink(size);
+    for (auto _ : state) {
+        Sender::send(pair.sender, payload);
+        zmq_recv(pair.receiver.handle(), sink.data(), sink.size(), 0);
+    }
+    label_size(state, size);
+}
+
+// --- recv (sender: raw zmq_send) ---------------------------------------------
+
+struct recv_message {
+    static void recv(zmq::socket_t &socket, zmq::message_t &msg, std::vector<char> &) {
+        (void)socket.recv(msg, zmq::recv_flags::none);
+        benchmark::DoNotOptimize(msg.data());
+    }
+};
+
+struct recv_buffer {
+    static void recv(zmq::socket_t &socket, zmq::message_t &, std::vector<char> &buffer) {
+        auto received = socket.recv(zmq::buffer(buffer), zmq::recv_flags::none);
+        benchmark::DoNotOptimize(received);
+    }
+};
+
+struct raw_zmq_msg_recv {
+    static void recv(zmq::socket_t &socket, zmq::message_t &msg, std::vector<char> &) {
+        zmq_msg_recv(msg.handle(), socket.handle(), 0);
+        benchmark::DoNotOptimize(zmq_msg_data(msg.handle()));
+    }
+};
+
+struct raw_zmq_recv {
+    static void recv(zmq::socket_t &socket, zmq::message_t &, std::vector<char> &buffer) {
+        benchmark::DoNotOptimize(zmq_recv(socket.handle(), buffer.data(), buffer.size(), 0));
+    }
+};
+
+template <typename Receiver>
+void recv(benchmark::State &state) {
+    size_t size = static_cast<size_t>(state.range(0));
+    inproc_pair pair;
+    std::vector<char> payload(size, 'X');
+    std::vector<char> buffer(size);
+    zmq::message_t msg;
+    for (auto _ : state) {
+        zmq_send(pair.sender.handle(), payload.data(), payload.size(), 0);
+        Receiver::recv(pair.receiver, msg, buffer);
+    }
+    label_size(state, size);
+}
+
+// --- multipart (range(0) parts of range(1) bytes) -----------------------------
+
+void multipart_t_roundtrip(benchmark::State &state) {
+    size_t parts = static_cast<size_t>(state.range(0));
+    size_t size = static_cast<size_t>(state.range(1));
+    inproc_pair pair;
+    std::vector<char> payload(size, 'X');
+    zmq::multipart_t incoming;
+    for (auto _ : state) {
+        zmq::multipart_t outgoing;
+        for (size_t i = 0; i < parts; i++) {
+            outgoing.addmem(payload.data(), size);
+        }
+        outgoing.send(pair.sender);
+        incoming.recv(pair.receiver);
+    }
+    label_size(state, size, parts);
+}
+
+void send_recv_multipart(benchmark::State &state) {
+    size_t parts = static_cast<size_t>(state.range(0));
+    size_t size = static_cast<size_t>(state.range(1));
+    inproc_pair pair;
+    std::vector<char> payload(size, 'X');
+    std::vector<zmq::const_buffer> outgoing(parts, zmq::buffer(payload));
+    std::vector<zmq::message_t> incoming;
+    incoming.reserve(parts);
+    for (auto _ : state) {
+        zmq::send_multipart(pair.sender, outgoing);
+        incoming.clear();
+        zmq::recv_multipart(pair.receiver, std::back_inserter(incoming));
+    }
+    label_size(state, size, parts);
+}
+
+void raw_multipart(benchmark::State &state) {
+    size_t parts = static_cast<size_t>(state.range(0));
+    size_t size = static_cast<size_t>(state.range(1));
+    inproc_pair pair;
+    std::vector<char> payload(size, 'X');
+    zmq_msg_t msg;
+    zmq_msg_init(&msg);
+    for (auto _ : state) {
+        for (size_t i = 0; i < parts; i++) {
+            zmq_send(pair.sender.handle(), payload.data(), size, i + 1 < parts ? ZMQ_SNDMORE : 0);
+        }
+        do {
+            zmq_msg_recv(&msg, pair.receiver.handle(), 0);
+        } while (zmq_msg_more(&msg));
+    }
+    zmq_msg_close(&msg);
+    label_size(state, size, parts);
+}
+
+// 8 and 32 bytes stay inside zmq_msg_t; 64 and up are heap allocated
+void sizes(benchmark::internal::Benchmark *b) {
+    for (int size : {8, 32, 64, 256, 1500, 65536}) {
+        b->Arg(size);
+    }
+}
+
+void multipart_shapes(benchmark::internal::Benchmark *b) {
+    for (int parts : {1, 3, 8}) {
+        for (int size : {32, 1500}) {
+            b->Args({parts, size});
+        }
+    }
+}
+
+}  // namespace
+
+BENCHMARK(message_t_size)->Apply(sizes);
+BENCHMARK(message_t_copy)->Apply(sizes);
+BENCHMARK(message_t_zero_copy)->Apply(sizes);
+BENCHMARK(raw_zmq_msg_init_size)->Apply(sizes);
+
+BENCHMARK_TEMPLATE(send, send_buffer)->Apply(sizes);
+BENCHMARK_TEMPLATE(send, send_message)->Apply(sizes);
+BENCHMARK_TEMPLATE(send, raw_zmq_send)->Apply(sizes);
+BENCHMARK_TEMPLATE(send, raw_zmq_msg_send)->Apply(sizes);
+
+BENCHMARK_TEMPLATE(recv, recv_message)->Apply(sizes);
+BENCHMARK_TEMPLATE(recv, recv_buffer)->Apply(sizes);
+BENCHMARK_TEMPLATE(recv, raw_zmq_msg_recv)->Apply(sizes);
+BENCHMARK_TEMPLATE(recv, raw_zmq_recv)->Apply(sizes);
+
+BENCHMARK(multipart_t_roundtrip)->Apply(multipart_shapes);
+BENCHMARK(send_recv_multipart)->Apply(multipart_shapes);
+BENCHMARK(raw_multipart)->Apply(multipart_shapes);
+
+BENCHMARK_MAIN();
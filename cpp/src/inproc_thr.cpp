@@ -0,0 +1,150 @@
+/*
+ * ZeroMQ C++ Throughput Test - inproc
+ *
+ * PUSH and PULL in one process over the inproc transport: a sender thread
+ * pushes messages while the main thread receives and measures. The inproc
+ * transport cannot span processes, so this is the single-binary counterpart
+ * of local_thr/remote_thr.
+ * Pattern: PULL <- PUSH (unidirectional data flow, inproc)
+ *
+ * Usage: ./inproc_thr <message_size> <message_count>
+ * Example: ./inproc_thr 64 1000000
+ */
+
+#include "bench_output.hpp"
+
+#include <zmq.hpp>
+#include <cerrno>
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <message_size> <message_count>\n";
+        std::cerr << "Example: " << argv[0] << " 64 1000000\n";
+        return 1;
+    }
+
+    size_t message_size = std::atoi(argv[1]);
+    int message_count = std::atoi(argv[2]);
+
+    if (message_size <= 0 || message_count <= 0) {
+        std::cerr << "Error: message_size and message_count must be positive\n";
+        return 1;
+    }
+
+    const char *endpoint = "inproc://thr_test";
+
+    try {
+        // One context shared by both ends (required for inproc)
+        zmq::context_t context(1);
+        zmq::socket_t receiver(context, zmq::socket_type::pull);
+        receiver.bind(endpoint);
+
+        std::cout << "Endpoint: " << endpoint << "\n";
+        std::cout << "Message size: " << message_size << " bytes\n";
+        std::cout << "Message count: " << message_count << "\n";
+
+        std::thread sender_thread([&context, endpoint, message_size, message_count]() {
+            try {
+                zmq::socket_t sender(context, zmq::socket_type::push);
+                sender.connect(endpoint);
+
+                std::vector<char> buffer(message_size, 'X');
+                for (int i = 0; i < message_count; i++) {
+                    zmq::message_t message(buffer.data(), message_size);
+                    sender.send(message, zmq::send_flags::none);
+                }
+            } catch (const zmq::error_t &e) {
+                // ETERM: the receiver gave up and shut the context down
+                if (e.num() != ETERM) {
+                    std::cerr << "ZMQ Error (sender): " << e.what() << "\n";
+                }
+            }
+        });
+
+        // Every early exit (error return or exception) shuts the context down
+        // first, so a sender blocked at the high-water mark returns and the
+        // join cannot hang
+        struct sender_stop {
+            zmq::context_t &context;
+            std::thread &thread;
+            ~sender_stop() {
+                if (thread.joinable()) {
+                    context.shutdown();
+                    thread.join();
+                }
+            }
+        } stop{context, sender_thread};
+
+        // Receive first message (warm-up, start timing after first message)
+        zmq::message_t first_msg;
+        auto recv_result = receiver.recv(first_msg, zmq::recv_flags::none);
+        if (!recv_result || first_msg.size() != message_size) {
+            std::cerr << "Error: Failed to receive first message\n";
+            return 1;
+        }
+
+        // Start timing
+        auto start = std::chrono::high_resolution_clock::now();
+
+        // Receive remaining messages
+        for (int i = 1; i < message_count; i++) {
+            zmq::message_t message;
+            recv_result = receiver.recv(message, zmq::recv_flags::none);
+
+            if (!recv_result || message.size() != message_size) {
+                std::cerr << "Error: Failed to receive message " << i << "\n";
+                return 1;
+            }
+        }
+
+        // Stop timing
+        auto end = std::chrono::high_resolution_clock::now();
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+        sender_thread.join();
+
+        // Calculate throughput
+        double elapsed_sec = static_cast<double>(elapsed) / 1000000.0;
+        double throughput = static_cast<double>(message_count - 1) / elapsed_sec;
+        double megabits = (throughput * message_size * 8) / 1000000.0;
+
+        // Print results
+        std::cout << "\n=== Throughput Test Results ===\n";
+        std::cout << "Received: " << message_count << " messages\n";
+        std::cout << "Message size: " << message_size << " bytes\n";
+        std::cout << "Total data: " << (message_size * message_count / (1024.0 * 1024.0)) << " MB\n";
+        std::cout << "Elapsed time: " << elapsed_sec << " seconds\n";
+        std::cout << "Throughput: " << throughput << " msg/s\n";
+        std::cout << "Throughput: " << megabits << " Mb/s\n";
+
+        // Machine-readable record (appended to $ZMQ_BENCH_OUTPUT when set)
+        bench_output::record record;
+        record.benchmark = "thr";
+        record.role = "both";
+        record.transport = "inproc";
+        record.endpoint = endpoint;
+        record.size = message_size;
+        record.count = message_count;
+        record.messages = message_count - 1;
+        record.elapsed_us = static_cast<double>(elapsed);
+        record.msg_per_sec = throughput;
+        record.mbps = megabits;
+        auto [major, minor, patch] = zmq::version();
+        record.zmq_version = std::to_string(major) + "." + std::to_string(minor) + "." + std::to_string(patch);
+        bench_output::emit(record);
+
+    } catch (const zmq::error_t &e) {
+        std::cerr << "ZMQ Error: " << e.what() << "\n";
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
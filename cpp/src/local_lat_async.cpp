@@ -0,0 +1,81 @@
+/*
+ * ZeroMQ C++ Latency Test - Async (Local / Server)
+ *
+ * Echo server of remote_lat_async: the REP loop is a C++20 coroutine that
+ * co_awaits recv/send and is resumed by an edge-triggered epoll loop on
+ * ZMQ_FD (zmq_async.hpp).
+ * Pattern: REP -> REQ (synchronous request-reply)
+ *
+ * Usage: ./local_lat_async <bind_to> <message_size> <roundtrip_count>
+ * Example: ./local_lat_async tcp://*:5555 64 10000
+ */
+
+#include "zmq_async.hpp"
+
+#include <zmq.hpp>
+#include <iostream>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// Warm-up + measured roundtrips
+async_bench::task echo(async_bench::async_socket &socket, size_t message_size, int expected) {
+    zmq::message_t request;
+    for (int i = 0; i < expected; i++) {
+        size_t size = co_await socket.recv(request);
+        if (size != message_size) {
+            throw std::runtime_error("Message size mismatch. Expected " + std::to_string(message_size) +
+                                     ", got " + std::to_string(size));
+        }
+        co_await socket.send(request);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <bind_to> <message_size> <roundtrip_count>\n";
+        std::cerr << "Example: " << argv[0] << " tcp://*:5555 64 10000\n";
+        return 1;
+    }
+
+    const char *bind_to = argv[1];
+    int message_size = std::atoi(argv[2]);
+    int roundtrip_count = std::atoi(argv[3]);
+
+    if (message_size <= 0 || roundtrip_count <= 0) {
+        std::cerr << "Error: message_size and roundtrip_count must be positive\n";
+        return 1;
+    }
+
+    try {
+        zmq::context_t context(1);
+        zmq::socket_t socket(context, zmq::socket_type::rep);
+        socket.bind(bind_to);
+        // Flushed: scripts wait for this line before starting the client
+        std::cout << "Listening on " << bind_to << std::endl;
+        std::cout << "Message size: " << message_size << " bytes\n";
+        std::cout << "Roundtrip count: " << roundtrip_count << "\n";
+        std::cout << "Waiting for messages...\n";
+
+        async_bench::reactor loop;
+        async_bench::async_socket async(loop, socket);
+
+        async_bench::task work = echo(async, static_cast<size_t>(message_size), roundtrip_count + 1);
+        loop.run(work);
+
+        std::cout << "Completed " << roundtrip_count << " roundtrips.\n";
+
+    } catch (const zmq::error_t &e) {
+        std::cerr << "ZMQ Error: " << e.what() << "\n";
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+/*
+ * ZeroMQ C++ Latency Test - ZMQ_STREAM (Local / Server)
+ *
+ * Echo server over a ZMQ_STREAM socket. Requests are reassembled from the
+ * raw TCP byte stream using a 4-byte length prefix and answered with a reply
+ * of the same size, so the comparison with local_lat isolates ZMTP framing
+ * and REQ/REP envelope handling.
+ * Pattern: STREAM -> STREAM (request-reply, application-level framing)
+ *
+ * Usage: ./local_lat_stream <bind_to> <message_size> <roundtrip_count>
+ * Example: ./local_lat_stream tcp://*:5560 64 10000
+ */
+
+#include "stream_framing.hpp"
+
+#include <zmq.hpp>
+#include <iostream>
+#include <vector>
+#include <cstring>
+
+int main(int argc, char *argv[]) {
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <bind_to> <message_size> <roundtrip_count>\n";
+        std::cerr << "Example: " << argv[0] << " tcp://*:5560 64 10000\n";
+        return 1;
+    }
+
+    const char *bind_to = argv[1];
+    size_t message_size = std::atoi(argv[2]);
+    int roundtrip_count = std::atoi(argv[3]);
+
+    if (message_size <= 0 || roundtrip_count <= 0) {
+        std::cerr << "Error: message_size and roundtrip_count must be positive\n";
+        return 1;
+    }
+
+    try {
+        // Create context and STREAM socket
+        zmq::context_t context(1);
+        zmq::socket_t socket(context, zmq::socket_type::stream);
+
+        // Bind to endpoint
+        socket.bind(bind_to);
+        std::cout << "Listening on " << bind_to << "\n";
+        std::cout << "Message size: " << message_size << " bytes\n";
+        std::cout << "Roundtrip count: " << roundtrip_count << "\n";
+        std::cout << "Waiting for messages...\n";
+
+        // Connect notification: [routing id][empty]
+        zmq::message_t peer_id;
+        zmq::message_t notify;
+        socket.recv(peer_id, zmq::recv_flags::none);
+        socket.recv(notify, zmq::recv_flags::none);
+
+        // Reply frame is built once; the payload content is not inspected
+        std::vector<char> reply = stream_bench::encode_frame(message_size);
+
+        stream_bench::frame_decoder decoder;
+        int echoed = 0;
+        const int expected = roundtrip_count + 1;  // warm-up + measured
+        bool failed = false;
+
+        auto on_frame = [&](const char *, size_t len) {
+            if (failed) {
+                return;
+            }
+            if (len != message_size) {
+                std::cerr << "Error: Message size mismatch. Expected " << message_size
+                          << ", got " << len << "\n";
+                failed = true;
+                return;
+            }
+
+            // Echo back: [routing id][frame]
+            zmq::message_t id(peer_id.data(), peer_id.size());
+            zmq::message_t message(reply.data(), reply.size());
+            auto send_result = socket.send(id, zmq::send_flags::sndmore);
+            if (send_result) {
+                send_result = socket.send(message, zmq::send_flags::none);
+            }
+            if (!send_result) {
+                std::cerr << "Error: Failed to send message " << echoed << "\n";
+                failed = true;
+                return;
+            }
+            echoed++;
+        };
+
+        // Echo loop - reassemble requests and answer each one
+        while (echoed < expected && !failed) {
+            zmq::message_t id;
+            zmq::message_t chunk;
+            auto recv_result = socket.recv(id, zmq::recv_flags::none);
+            if (recv_result) {
+                recv_result = socket.recv(chunk, zmq::recv_flags::none);
+            }
+            if (!recv_result) {
+                std::cerr << "Error: Failed to receive message " << echoed << "\n";
+                return 1;
+            }
+
+            // Empty data frame means the peer disconnected
+            if (chunk.size() == 0) {
+                std::cerr << "Error: Peer disconnected after " << echoed << " messages\n";
+                return 1;
+            }
+
+            decoder.feed(static_cast<const char *>(chunk.data()), chunk.size(), on_frame);
+        }
+
+        if (failed) {
+            return 1;
+        }
+
+        std::cout << "\nCompleted " << roundtrip_count << " roundtrips.\n";
+
+    } catch (const zmq::error_t &e) {
+        std::cerr << "ZMQ Error: " << e.what() << "\n";
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
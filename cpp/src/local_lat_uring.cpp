@@ -0,0 +1,136 @@
+/*
+ * Raw TCP Latency Baseline - Local (Server), io_uring
+ *
+ * Echo server over a plain TCP socket: a multishot recv collects bytes and
+ * every completed message is answered with a same-sized send (zero-copy
+ * from a registered buffer for payloads of 16 KB and above).
+ * Pattern: raw TCP request-reply, counterpart of local_lat
+ *
+ * Usage: ./local_lat_uring <bind_to> <message_size> <roundtrip_count>
+ * Example: ./local_lat_uring tcp://*:5557 64 10000
+ */
+
+#include "uring.hpp"
+
+#include <iostream>
+#include <vector>
+#include <cstring>
+
+using namespace uring_bench;
+
+int main(int argc, char *argv[]) {
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <bind_to> <message_size> <roundtrip_count>\n";
+        std::cerr << "Example: " << argv[0] << " tcp://*:5557 64 10000\n";
+        return 1;
+    }
+
+    const char *bind_to = argv[1];
+    size_t message_size = std::atoi(argv[2]);
+    int roundtrip_count = std::atoi(argv[3]);
+
+    if (message_size <= 0 || roundtrip_count <= 0) {
+        std::cerr << "Error: message_size and roundtrip_count must be positive\n";
+        return 1;
+    }
+
+    try {
+        std::cout << "Listening on " << bind_to << "\n";
+        std::cout << "Message size: " << message_size << " bytes\n";
+        std::cout << "Roundtrip count: " << roundtrip_count << "\n";
+        std::cout << "Waiting for messages...\n";
+
+        int fd = tcp_listen_accept(bind_to);
+
+        uring ring(64);
+        buffer_ring buffers(ring, 0, RECV_BUFFER_COUNT, RECV_BUFFER_SIZE);
+
+        std::vector<char> reply(message_size, 'X');
+        iovec iov = {reply.data(), message_size};
+        ring.register_buffers(&iov, 1);
+        bool zerocopy = message_size >= ZEROCOPY_THRESHOLD && ring.supports_op(IORING_OP_SEND_ZC);
+
+        prep_recv_multishot(ring.get_sqe(), fd, buffers);
+
+        // One extra roundtrip for the warm-up message
+        const int expected = roundtrip_count + 1;
+        int echoed = 0;
+        int sends_pending = 0;
+        int notifications = 0;
+        size_t partial = 0;
+        int error = 0;
+
+        while ((echoed < expected || sends_pending > 0 || notifications > 0) && error == 0) {
+            ring.submit(1);
+            ring.drain([&](const io_uring_cqe &cqe) {
+                if ((cqe.user_data & TAG_MASK) == TAG_SEND) {
+                    if (cqe.flags & IORING_CQE_F_NOTIF) {
+                        notifications--;
+                        return;
+                    }
+                    if (cqe.flags & IORING_CQE_F_MORE) {
+                        notifications++;
+                    }
+                    if (cqe.res < 0) {
+                        error = -cqe.res;
+                        return;
+                    }
+                    size_t requested = static_cast<size_t>(cqe.user_data & ~TAG_MASK);
+                    if (static_cast<size_t>(cqe.res) < requested) {
+                        prep_send(ring.get_sqe(), fd, reply.data(), requested - cqe.res, zerocopy);
+                        return;
+                    }
+                    sends_pending--;
+                    return;
+                }
+
+                if (cqe.res < 0) {
+                    if (cqe.res == -ENOBUFS) {
+                        prep_recv_multishot(ring.get_sqe(), fd, buffers);
+                        return;
+                    }
+                    error = -cqe.res;
+                    return;
+                }
+                if (cqe.res == 0) {
+                    // Client hung up; only an error before the last roundtrip
+                    if (echoed < expected) {
+                        error = ECONNRESET;
+                    }
+                    return;
+                }
+
+                partial += static_cast<size_t>(cqe.res);
+                while (partial >= message_size) {
+                    partial -= message_size;
+                    prep_send(ring.get_sqe(), fd, reply.data(), message_size, zerocopy);
+                    sends_pending++;
+                    echoed++;
+                }
+
+                if (cqe.flags & IORING_CQE_F_BUFFER) {
+                    buffers.recycle(static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+                }
+                if (!(cqe.flags & IORING_CQE_F_MORE) && echoed < expected) {
+                    prep_recv_multishot(ring.get_sqe(), fd, buffers);
+                }
+            });
+        }
+
+        close(fd);
+
+        if (error != 0) {
+            std::cerr << "Error: I/O failed after " << echoed << " roundtrips: "
+                      << std::strerror(error) << "\n";
+            return 1;
+        }
+
+        std::cout << "\nCompleted " << roundtrip_count << " roundtrips.\n";
+
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+/*
+ * ZeroMQ C++ Throughput Test - Async (Local / Receiver)
+ *
+ * Same measurement as local_thr, with the receive loop written as a C++20
+ * coroutine that co_awaits recv on the PULL socket and is resumed by an
+ * edge-triggered epoll loop on ZMQ_FD (zmq_async.hpp). Timing starts after
+ * the first message (warm-up). The difference against local_thr is the cost
+ * of the async layer.
+ * Pattern: PULL <- PUSH (unidirectional data flow)
+ *
+ * Usage: ./local_thr_async <bind_to> <message_size> <message_count>
+ * Example: ./local_thr_async tcp://*:5556 64 1000000
+ */
+
+#include "bench_output.hpp"
+#include "zmq_async.hpp"
+
+#include <zmq.hpp>
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+using clock_type = std::chrono::high_resolution_clock;
+
+struct timing {
+    clock_type::time_point start;
+    clock_type::time_point end;
+};
+
+async_bench::task receive(async_bench::async_socket &socket, size_t message_size,
+                          int message_count, timing &t) {
+    zmq::message_t message;
+    for (int i = 0; i < message_count; i++) {
+        size_t size = co_await socket.recv(message);
+        if (size != message_size) {
+            throw std::runtime_error("Message size mismatch at message " + std::to_string(i) +
+                                     ". Expected " + std::to_string(message_size) + ", got " +
+                                     std::to_string(size));
+        }
+        if (i == 0) {
+            t.start = clock_type::now();
+        }
+    }
+    t.end = clock_type::now();
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <bind_to> <message_size> <message_count>\n";
+        std::cerr << "Example: " << argv[0] << " tcp://*:5556 64 1000000\n";
+        return 1;
+    }
+
+    const char *bind_to = argv[1];
+    int message_size = std::atoi(argv[2]);
+    int message_count = std::atoi(argv[3]);
+
+    if (message_size <= 0 || message_count <= 0) {
+        std::cerr << "Error: message_size and message_count must be positive\n";
+        return 1;
+    }
+
+    try {
+        zmq::context_t context(1);
+        zmq::socket_t socket(context, zmq::socket_type::pull);
+        socket.bind(bind_to);
+        // Flushed: scripts wait for this line before starting the client
+        std::cout << "Listening on " << bind_to << std::endl;
+        std::cout << "Message size: " << message_size << " bytes\n";
+        std::cout << "Message count: " << message_count << "\n";
+        std::cout << "Waiting for messages...\n";
+
+        async_bench::reactor loop;
+        async_bench::async_socket async(loop, socket);
+
+        timing t;
+        async_bench::task work = receive(async, static_cast<size_t>(message_size), message_count, t);
+        loop.run(work);
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(t.end - t.start).count();
+        double elapsed_sec = static_cast<double>(elapsed) / 1000000.0;
+        double throughput = static_cast<double>(message_count - 1) / elapsed_sec;
+        double megabits = (throughput * message_size * 8) / 1000000.0;
+        double wakeups = static_cast<double>(loop.wakeups()) / message_count;
+
+        std::cout << "\n=== Throughput Test Results ===\n";
+        std::cout << "Received: " << message_count << " messages\n";
+        std::cout << "Message size: " << message_size << " bytes\n";
+        std::cout << "Total data: " << (static_cast<double>(message_size) * message_count / (1024.0 * 1024.0)) << " MB\n";
+        std::cout << "Elapsed time: " << elapsed_sec << " seconds\n";
+        std::cout << "Throughput: " << throughput << " msg/s\n";
+        std::cout << "Throughput: " << megabits << " Mb/s\n";
+        std::cout << "Epoll wakeups: " << wakeups << " per message\n";
+
+        // Machine-readable record (appended to $ZMQ_BENCH_OUTPUT when set)
+        bench_output::record record;
+        record.benchmark = "thr_async";
+        record.role = "server";
+        record.transport = bench_output::transport_of(bind_to);
+        record.endpoint = bind_to;
+        record.size = static_cast<size_t>(message_size);
+        record.count = message_count;
+        record.messages = message_count - 1;
+        record.elapsed_us = static_cast<double>(elapsed);
+        record.msg_per_sec = throughput;
+        record.mbps = megabits;
+        record.config.emplace_back("epoll_wakeups_per_msg", bench_output::json_number(wakeups));
+        auto [major, minor, patch] = zmq::version();
+        record.zmq_version = std::to_string(major) + "." + std::to_string(minor) + "." + std::to_string(patch);
+        bench_output::emit(record);
+
+    } catch (const zmq::error_t &e) {
+        std::cerr << "ZMQ Error: " << e.what() << "\n";
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+/*
+ * Shared-Memory Throughput Baseline - Local (Consumer)
+ *
+ * Creates a single-producer/single-consumer ring in POSIX shared memory and
+ * copies every message out of it into a private buffer. No sockets and no
+ * ZeroMQ: this is the co-located ceiling the inproc/ipc/tcp numbers are
+ * compared against.
+ * Pattern: SPSC ring, same metrics as local_thr
+ *
+ * Usage: ./local_thr_shm <ring_name> <message_size> <message_count>
+ * Example: ./local_thr_shm /zmq_bench_thr 64 1000000
+ */
+
+#include "bench_output.hpp"
+#include "shm_ring.hpp"
+
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <cstring>
+
+int main(int argc, char *argv[]) {
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <ring_name> <message_size> <message_count>\n";
+        std::cerr << "Example: " << argv[0] << " /zmq_bench_thr 64 1000000\n";
+        return 1;
+    }
+
+    const char *ring_name = argv[1];
+    size_t message_size = std::atoi(argv[2]);
+    int message_count = std::atoi(argv[3]);
+
+    if (message_size <= 0 || message_count <= 0) {
+        std::cerr << "Error: message_size and message_count must be positive\n";
+        return 1;
+    }
+
+    try {
+        shm_bench::ring ring = shm_bench::ring::create(ring_name, message_size);
+        std::cout << "Created ring " << ring_name << " (" << ring.slot_count() << " slots)\n";
+        std::cout << "Message size: " << message_size << " bytes\n";
+        std::cout << "Message count: " << message_count << "\n";
+        std::cout << "Waiting for messages...\n";
+
+        std::vector<char> buffer(message_size);
+
+        // Receive first message (warm-up, start timing after first message)
+        size_t size = ring.pop(buffer.data());
+        if (size != message_size) {
+            std::cerr << "Error: Message size mismatch. Expected " << message_size
+                      << ", got " << size << "\n";
+            return 1;
+        }
+
+        // Producer is attached; drop the name so it cannot be reopened
+        ring.unlink();
+
+        std::cout << "First message received. Starting measurement...\n";
+
+        // Start timing
+        auto start = std::chrono::high_resolution_clock::now();
+
+        // Receive remaining messages
+        for (int i = 1; i < message_count; i++) {
+            size = ring.pop(buffer.data());
+
+            if (size != message_size) {
+                std::cerr << "Error: Message size mismatch at message " << i
+                          << ". Expected " << message_size << ", got " << size << "\n";
+                return 1;
+            }
+        }
+
+        // Stop timing
+        auto end = std::chrono::high_resolution_clock::now();
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+        // Calculate throughput
+        double elapsed_sec = static_cast<double>(elapsed) / 1000000.0;
+        double throughput = static_cast<double>(message_count - 1) / elapsed_sec;
+        double megabits = (throughput * message_size * 8) / 1000000.0;
+
+        // Print results
+        std::cout << "\n=== Throughput Test Results ===\n";
+        std::cout << "Received: " << message_count << " messages\n";
+        std::cout << "Message size: " << message_size << " bytes\n";
+        std::cout << "Total data: " << (message_size * message_count / (1024.0 * 1024.0)) << " MB\n";
+        std::cout << "Elapsed time: " << elapsed_sec << " seconds\n";
+        std::cout << "Throughput: " << throughput << " msg/s\n";
+        std::cout << "Throughput: " << megabits << " Mb/s\n";
+
+        // Machine-readable record (appended to $ZMQ_BENCH_OUTPUT when set)
+        bench_output::record record;
+        record.benchmark = "thr_shm";
+        record.role = "server";
+        record.transport = "shm";
+        record.endpoint = ring_name;
+        record.size = message_size;
+        record.count = message_count;
+        record.messages = message_count - 1;
+        record.elapsed_us = static_cast<double>(elapsed);
+        record.msg_per_sec = throughput;
+        record.mbps = megabits;
+        record.binding = "none";
+        bench_output::emit(record);
+
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
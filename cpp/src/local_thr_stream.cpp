@@ -0,0 +1,143 @@
+/*
+ * ZeroMQ C++ Throughput Test - ZMQ_STREAM (Local / Receiver)
+ *
+ * Same measurement as local_thr, but over ZMQ_STREAM sockets: no ZMTP
+ * greeting, framing or per-message flags on the wire, only raw TCP bytes.
+ * Messages carry a 4-byte length prefix and are reassembled here, so the
+ * difference against PUSH/PULL is the cost of the ZMTP protocol layer.
+ * Pattern: STREAM <- STREAM (unidirectional, application-level framing)
+ *
+ * Usage: ./local_thr_stream <bind_to> <message_size> <message_count>
+ * Example: ./local_thr_stream tcp://*:5559 64 1000000
+ */
+
+#include "bench_output.hpp"
+#include "stream_framing.hpp"
+
+#include <zmq.hpp>
+#include <iostream>
+#include <chrono>
+#include <cstring>
+
+int main(int argc, char *argv[]) {
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <bind_to> <message_size> <message_count>\n";
+        std::cerr << "Example: " << argv[0] << " tcp://*:5559 64 1000000\n";
+        return 1;
+    }
+
+    const char *bind_to = argv[1];
+    size_t message_size = std::atoi(argv[2]);
+    int message_count = std::atoi(argv[3]);
+
+    if (message_size <= 0 || message_count <= 0) {
+        std::cerr << "Error: message_size and message_count must be positive\n";
+        return 1;
+    }
+
+    try {
+        // Create context and STREAM socket
+        zmq::context_t context(1);
+        zmq::socket_t socket(context, zmq::socket_type::stream);
+
+        // Bind to endpoint
+        socket.bind(bind_to);
+        std::cout << "Listening on " << bind_to << "\n";
+        std::cout << "Message size: " << message_size << " bytes\n";
+        std::cout << "Message count: " << message_count << "\n";
+        std::cout << "Waiting for messages...\n";
+
+        // Connect notification: [routing id][empty]
+        zmq::message_t peer_id;
+        zmq::message_t notify;
+        socket.recv(peer_id, zmq::recv_flags::none);
+        socket.recv(notify, zmq::recv_flags::none);
+
+        stream_bench::frame_decoder decoder;
+        int received = 0;
+        bool size_mismatch = false;
+        std::chrono::high_resolution_clock::time_point start;
+
+        auto on_frame = [&](const char *, size_t len) {
+            if (len != message_size) {
+                size_mismatch = true;
+            }
+            // Start timing after the first message (warm-up)
+            if (received == 0) {
+                start = std::chrono::high_resolution_clock::now();
+            }
+            received++;
+        };
+
+        // Receive chunks until every message has been reassembled
+        while (received < message_count) {
+            zmq::message_t id;
+            zmq::message_t chunk;
+            auto recv_result = socket.recv(id, zmq::recv_flags::none);
+            if (recv_result) {
+                recv_result = socket.recv(chunk, zmq::recv_flags::none);
+            }
+            if (!recv_result) {
+                std::cerr << "Error: Failed to receive message " << received << "\n";
+                return 1;
+            }
+
+            // Empty data frame means the peer disconnected
+            if (chunk.size() == 0) {
+                std::cerr << "Error: Peer disconnected after " << received << " messages\n";
+                return 1;
+            }
+
+            decoder.feed(static_cast<const char *>(chunk.data()), chunk.size(), on_frame);
+
+            if (size_mismatch) {
+                std::cerr << "Error: Message size mismatch at message " << received
+                          << ". Expected " << message_size << "\n";
+                return 1;
+            }
+        }
+
+        // Stop timing
+        auto end = std::chrono::high_resolution_clock::now();
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+        // Calculate throughput
+        double elapsed_sec = static_cast<double>(elapsed) / 1000000.0;
+        double throughput = static_cast<double>(message_count - 1) / elapsed_sec;
+        double megabits = (throughput * message_size * 8) / 1000000.0;
+
+        // Print results
+        std::cout << "\n=== Throughput Test Results ===\n";
+        std::cout << "Received: " << message_count << " messages\n";
+        std::cout << "Message size: " << message_size << " bytes\n";
+        std::cout << "Total data: " << (message_size * message_count / (1024.0 * 1024.0)) << " MB\n";
+        std::cout << "Elapsed time: " << elapsed_sec << " seconds\n";
+        std::cout << "Throughput: " << throughput << " msg/s\n";
+        std::cout << "Throughput: " << megabits << " Mb/s\n";
+
+        // Machine-readable record (appended to $ZMQ_BENCH_OUTPUT when set)
+        bench_output::record record;
+        record.benchmark = "thr_stream";
+        record.role = "server";
+        record.transport = "tcp";
+        record.endpoint = bind_to;
+        record.size = message_size;
+        record.count = message_count;
+        record.messages = message_count - 1;
+        record.elapsed_us = static_cast<double>(elapsed);
+        record.msg_per_sec = throughput;
+        record.mbps = megabits;
+        auto [major, minor, patch] = zmq::version();
+        record.zmq_version = std::to_string(major) + "." + std::to_string(minor) + "." + std::to_string(patch);
+        bench_output::emit(record);
+
+    } catch (const zmq::error_t &e) {
+        std::cerr << "ZMQ Error: " << e.what() << "\n";
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,141 @@
+/*
+ * Raw TCP Throughput Baseline - Local (Receiver), io_uring
+ *
+ * Receives a fixed-size message stream over a plain TCP socket using a single
+ * multishot recv backed by a kernel-provided buffer ring. No ZeroMQ involved:
+ * this is the ceiling the libzmq tcp transport is compared against.
+ * Pattern: raw TCP stream, same metrics as local_thr
+ *
+ * Usage: ./local_thr_uring <bind_to> <message_size> <message_count>
+ * Example: ./local_thr_uring tcp://*:5558 64 1000000
+ */
+
+#include "bench_output.hpp"
+#include "uring.hpp"
+
+#include <iostream>
+#include <chrono>
+#include <cstring>
+
+using namespace uring_bench;
+
+int main(int argc, char *argv[]) {
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <bind_to> <message_size> <message_count>\n";
+        std::cerr << "Example: " << argv[0] << " tcp://*:5558 64 1000000\n";
+        return 1;
+    }
+
+    const char *bind_to = argv[1];
+    size_t message_size = std::atoi(argv[2]);
+    int message_count = std::atoi(argv[3]);
+
+    if (message_size <= 0 || message_count <= 0) {
+        std::cerr << "Error: message_size and message_count must be positive\n";
+        return 1;
+    }
+
+    try {
+        std::cout << "Listening on " << bind_to << "\n";
+        std::cout << "Message size: " << message_size << " bytes\n";
+        std::cout << "Message count: " << message_count << "\n";
+        std::cout << "Waiting for messages...\n";
+
+        int fd = tcp_listen_accept(bind_to);
+
+        uring ring(256);
+        buffer_ring buffers(ring, 0, RECV_BUFFER_COUNT, RECV_BUFFER_SIZE);
+
+        prep_recv_multishot(ring.get_sqe(), fd, buffers);
+
+        const uint64_t total_bytes = static_cast<uint64_t>(message_size) * message_count;
+        uint64_t received = 0;
+        bool started = false;
+        std::chrono::high_resolution_clock::time_point start;
+        int error = 0;
+
+        while (received < total_bytes && error == 0) {
+            ring.submit(1);
+            ring.drain([&](const io_uring_cqe &cqe) {
+                if (cqe.res < 0) {
+                    if (cqe.res == -ENOBUFS) {
+                        // All provided buffers in flight; re-arm after recycling
+                        prep_recv_multishot(ring.get_sqe(), fd, buffers);
+                        return;
+                    }
+                    error = -cqe.res;
+                    return;
+                }
+                if (cqe.res == 0) {
+                    // Sender closed; only an error before the last message
+                    if (received < total_bytes) {
+                        error = ECONNRESET;
+                    }
+                    return;
+                }
+
+                received += static_cast<uint64_t>(cqe.res);
+
+                // Start timing once the first full message has arrived (matches local_thr)
+                if (!started && received >= message_size) {
+                    started = true;
+                    start = std::chrono::high_resolution_clock::now();
+                    std::cout << "First message received. Starting measurement...\n";
+                }
+
+                if (cqe.flags & IORING_CQE_F_BUFFER) {
+                    buffers.recycle(static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+                }
+                if (!(cqe.flags & IORING_CQE_F_MORE) && received < total_bytes) {
+                    prep_recv_multishot(ring.get_sqe(), fd, buffers);
+                }
+            });
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+        close(fd);
+
+        if (error != 0) {
+            std::cerr << "Error: recv failed after " << received << " bytes: "
+                      << std::strerror(error) << "\n";
+            return 1;
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+        // Calculate throughput
+        double elapsed_sec = static_cast<double>(elapsed) / 1000000.0;
+        double throughput = static_cast<double>(message_count - 1) / elapsed_sec;
+        double megabits = (throughput * message_size * 8) / 1000000.0;
+
+        // Print results
+        std::cout << "\n=== Throughput Test Results ===\n";
+        std::cout << "Received: " << message_count << " messages\n";
+        std::cout << "Message size: " << message_size << " bytes\n";
+        std::cout << "Total data: " << (message_size * message_count / (1024.0 * 1024.0)) << " MB\n";
+        std::cout << "Elapsed time: " << elapsed_sec << " seconds\n";
+        std::cout << "Throughput: " << throughput << " msg/s\n";
+        std::cout << "Throughput: " << megabits << " Mb/s\n";
+
+        // Machine-readable record (appended to $ZMQ_BENCH_OUTPUT when set)
+        bench_output::record record;
+        record.benchmark = "thr_uring";
+        record.role = "server";
+        record.transport = "tcp";
+        record.endpoint = bind_to;
+        record.size = message_size;
+        record.count = message_count;
+        record.messages = message_count - 1;
+        record.elapsed_us = static_cast<double>(elapsed);
+        record.msg_per_sec = throughput;
+        record.mbps = megabits;
+        record.binding = "none";
+        bench_output::emit(record);
+
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
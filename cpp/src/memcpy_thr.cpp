@@ -0,0 +1,93 @@
+/*
+ * memcpy Bandwidth Ceiling
+ *
+ * Copies each message from a private buffer into consecutive slots of an
+ * arena laid out exactly like the shared-memory ring, in one process and one
+ * thread. One memcpy per message is the upper bound for any transport that
+ * has to move the payload at least once.
+ * Pattern: plain memcpy, same metrics as local_thr
+ *
+ * Usage: ./memcpy_thr <message_size> <message_count>
+ * Example: ./memcpy_thr 64 1000000
+ */
+
+#include "bench_output.hpp"
+#include "shm_ring.hpp"
+
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <cstring>
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <message_size> <message_count>\n";
+        std::cerr << "Example: " << argv[0] << " 64 1000000\n";
+        return 1;
+    }
+
+    size_t message_size = std::atoi(argv[1]);
+    int message_count = std::atoi(argv[2]);
+
+    if (message_size <= 0 || message_count <= 0) {
+        std::cerr << "Error: message_size and message_count must be positive\n";
+        return 1;
+    }
+
+    size_t stride = shm_bench::slot_stride_for(message_size);
+    uint64_t slots = shm_bench::slot_count_for(stride);
+    uint64_t mask = slots - 1;
+
+    std::vector<char> source(message_size, 'X');
+    std::vector<char> arena(slots * stride, 0);
+
+    std::cout << "Message size: " << message_size << " bytes\n";
+    std::cout << "Message count: " << message_count << "\n";
+    std::cout << "Arena: " << slots << " slots x " << stride << " bytes\n";
+
+    // Warm-up: touch the whole arena once
+    for (uint64_t i = 0; i < slots; i++) {
+        std::memcpy(arena.data() + i * stride, source.data(), message_size);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (int i = 1; i < message_count; i++) {
+        char *slot = arena.data() + (static_cast<uint64_t>(i) & mask) * stride;
+        std::memcpy(slot, source.data(), message_size);
+        // Keep the compiler from eliding or merging the copies
+        asm volatile("" : : "r"(slot) : "memory");
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+    // Calculate throughput (message_count - 1 to match local_thr)
+    double elapsed_sec = static_cast<double>(elapsed) / 1000000000.0;
+    double throughput = static_cast<double>(message_count - 1) / elapsed_sec;
+    double megabits = (throughput * message_size * 8) / 1000000.0;
+
+    // Print results
+    std::cout << "\n=== Throughput Test Results ===\n";
+    std::cout << "Copied: " << message_count << " messages\n";
+    std::cout << "Message size: " << message_size << " bytes\n";
+    std::cout << "Elapsed time: " << elapsed_sec << " seconds\n";
+    std::cout << "Throughput: " << throughput << " msg/s\n";
+    std::cout << "Throughput: " << megabits << " Mb/s\n";
+
+    // Machine-readable record (appended to $ZMQ_BENCH_OUTPUT when set)
+    bench_output::record record;
+    record.benchmark = "thr_memcpy";
+    record.role = "both";
+    record.transport = "memory";
+    record.size = message_size;
+    record.count = message_count;
+    record.messages = message_count - 1;
+    record.elapsed_us = static_cast<double>(elapsed) / 1000.0;
+    record.msg_per_sec = throughput;
+    record.mbps = megabits;
+    record.binding = "none";
+    bench_output::emit(record);
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+/*
+ * ZeroMQ C++ Latency Test - Async (Remote / Client)
+ *
+ * Same measurement as remote_lat, with the roundtrip loop written as a C++20
+ * coroutine that co_awaits send/recv on the REQ socket and is resumed by an
+ * edge-triggered epoll loop on ZMQ_FD (zmq_async.hpp). The difference against
+ * remote_lat is the cost of the async layer.
+ * Pattern: REQ -> REP (synchronous request-reply)
+ *
+ * Usage: ./remote_lat_async <connect_to> <message_size> <roundtrip_count>
+ * Example: ./remote_lat_async tcp://localhost:5555 64 10000
+ */
+
+#include "bench_output.hpp"
+#include "zmq_async.hpp"
+
+#include <zmq.hpp>
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+using clock_type = std::chrono::high_resolution_clock;
+
+struct timing {
+    clock_type::time_point start;
+    clock_type::time_point end;
+};
+
+// Warm-up roundtrip, then roundtrip_count timed ones
+async_bench::task roundtrips(async_bench::async_socket &socket, size_t message_size,
+                             int roundtrip_count, timing &t) {
+    std::vector<char> payload(message_size, 'X');
+    zmq::message_t reply;
+    for (int i = -1; i < roundtrip_count; i++) {
+        if (i == 0) {
+            t.start = clock_type::now();
+        }
+        zmq::message_t request(payload.data(), payload.size());
+        co_await socket.send(request);
+        size_t size = co_await socket.recv(reply);
+        if (size != message_size) {
+            throw std::runtime_error("Message size mismatch. Expected " + std::to_string(message_size) +
+                                     ", got " + std::to_string(size));
+        }
+    }
+    t.end = clock_type::now();
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <connect_to> <message_size> <roundtrip_count>\n";
+        std::cerr << "Example: " << argv[0] << " tcp://localhost:5555 64 10000\n";
+        return 1;
+    }
+
+    const char *connect_to = argv[1];
+    int message_size = std::atoi(argv[2]);
+    int roundtrip_count = std::atoi(argv[3]);
+
+    if (message_size <= 0 || roundtrip_count <= 0) {
+        std::cerr << "Error: message_size and roundtrip_count must be positive\n";
+        return 1;
+    }
+
+    try {
+        zmq::context_t context(1);
+        zmq::socket_t socket(context, zmq::socket_type::req);
+        socket.connect(connect_to);
+        std::cout << "Connected to " << connect_to << "\n";
+        std::cout << "Message size: " << message_size << " bytes\n";
+        std::cout << "Roundtrip count: " << roundtrip_count << "\n";
+
+        async_bench::reactor loop;
+        async_bench::async_socket async(loop, socket);
+
+        timing t;
+        async_bench::task work = roundtrips(async, static_cast<size_t>(message_size), roundtrip_count, t);
+        loop.run(work);
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(t.end - t.start).count();
+
+        // Calculate latency (divide by 2 for one-way, not round-trip)
+        double latency = static_cast<double>(elapsed) / static_cast<double>(roundtrip_count * 2);
+        double wakeups = static_cast<double>(loop.wakeups()) / (roundtrip_count + 1);
+
+        std::cout << "\n=== Latency Test Results ===\n";
+        std::cout << "Message size: " << message_size << " bytes\n";
+        std::cout << "Average latency: " << latency << " us\n";
+        std::cout << "Total elapsed time: " << elapsed << " us\n";
+        std::cout << "Message rate: " << (roundtrip_count * 1000000.0 / elapsed) << " msg/s\n";
+        std::cout << "Epoll wakeups: " << wakeups << " per roundtrip\n";
+
+        // Machine-readable record (appended to $ZMQ_BENCH_OUTPUT when set)
+        bench_output::record record;
+        record.benchmark = "lat_async";
+        record.role = "client";
+        record.transport = bench_output::transport_of(connect_to);
+        record.endpoint = connect_to;
+        record.size = static_cast<size_t>(message_size);
+        record.count = roundtrip_count;
+        record.messages = roundtrip_count;
+        record.elapsed_us = static_cast<double>(elapsed);
+        record.latency_us = latency;
+        record.config.emplace_back("epoll_wakeups_per_msg", bench_output::json_number(wakeups));
+        auto [major, minor, patch] = zmq::version();
+        record.zmq_version = std::to_string(major) + "." + std::to_string(minor) + "." + std::to_string(patch);
+        bench_output::emit(record);
+
+    } catch (const zmq::error_t &e) {
+        std::cerr << "ZMQ Error: " << e.what() << "\n";
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,154 @@
+/*
+ * ZeroMQ C++ Latency Test - ZMQ_STREAM (Remote / Client)
+ *
+ * Measures round-trip latency over a ZMQ_STREAM socket with a 4-byte length
+ * prefix per message. Counterpart of remote_lat with the ZMTP protocol layer
+ * removed.
+ * Pattern: STREAM -> STREAM (request-reply, application-level framing)
+ *
+ * Usage: ./remote_lat_stream <connect_to> <message_size> <roundtrip_count>
+ * Example: ./remote_lat_stream tcp://localhost:5560 64 10000
+ */
+
+#include "bench_output.hpp"
+#include "stream_framing.hpp"
+
+#include <zmq.hpp>
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstring>
+
+int main(int argc, char *argv[]) {
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <connect_to> <message_size> <roundtrip_count>\n";
+        std::cerr << "Example: " << argv[0] << " tcp://localhost:5560 64 10000\n";
+        return 1;
+    }
+
+    const char *connect_to = argv[1];
+    size_t message_size = std::atoi(argv[2]);
+    int roundtrip_count = std::atoi(argv[3]);
+
+    if (message_size <= 0 || roundtrip_count <= 0) {
+        std::cerr << "Error: message_size and roundtrip_count must be positive\n";
+        return 1;
+    }
+
+    try {
+        // Create context and STREAM socket
+        zmq::context_t context(1);
+        zmq::socket_t socket(context, zmq::socket_type::stream);
+
+        // Connect to server
+        socket.connect(connect_to);
+        std::cout << "Connected to " << connect_to << "\n";
+        std::cout << "Message size: " << message_size << " bytes\n";
+        std::cout << "Roundtrip count: " << roundtrip_count << "\n";
+
+        // Connect notification carries the routing id of the server
+        zmq::message_t peer_id;
+        zmq::message_t notify;
+        socket.recv(peer_id, zmq::recv_flags::none);
+        socket.recv(notify, zmq::recv_flags::none);
+
+        // Prepare [length][payload] frame
+        std::vector<char> frame = stream_bench::encode_frame(message_size);
+        stream_bench::frame_decoder decoder;
+
+        // One roundtrip: send a request, read chunks until the reply is complete
+        auto roundtrip = [&](int i) -> bool {
+            zmq::message_t id(peer_id.data(), peer_id.size());
+            zmq::message_t request(frame.data(), frame.size());
+            auto send_result = socket.send(id, zmq::send_flags::sndmore);
+            if (send_result) {
+                send_result = socket.send(request, zmq::send_flags::none);
+            }
+            if (!send_result) {
+                std::cerr << "Error: Failed to send message " << i << "\n";
+                return false;
+            }
+
+            size_t reply_size = 0;
+            bool replied = false;
+            while (!replied) {
+                zmq::message_t reply_id;
+                zmq::message_t chunk;
+                auto recv_result = socket.recv(reply_id, zmq::recv_flags::none);
+                if (recv_result) {
+                    recv_result = socket.recv(chunk, zmq::recv_flags::none);
+                }
+                if (!recv_result || chunk.size() == 0) {
+                    std::cerr << "Error: Failed to receive message " << i << "\n";
+                    return false;
+                }
+
+                decoder.feed(static_cast<const char *>(chunk.data()), chunk.size(),
+                             [&](const char *, size_t len) {
+                                 reply_size = len;
+                                 replied = true;
+                             });
+            }
+
+            // Verify message size
+            if (reply_size != message_size) {
+                std::cerr << "Error: Message size mismatch. Expected " << message_size
+                          << ", got " << reply_size << "\n";
+                return false;
+            }
+            return true;
+        };
+
+        // Warm-up
+        if (!roundtrip(-1)) {
+            return 1;
+        }
+
+        // Start timing
+        auto start = std::chrono::high_resolution_clock::now();
+
+        // Perform roundtrips
+        for (int i = 0; i < roundtrip_count; i++) {
+            if (!roundtrip(i)) {
+                return 1;
+            }
+        }
+
+        // Stop timing
+        auto end = std::chrono::high_resolution_clock::now();
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+        // Calculate latency (divide by 2 for one-way, not round-trip)
+        double latency = static_cast<double>(elapsed) / static_cast<double>(roundtrip_count * 2);
+
+        // Print results
+        std::cout << "\n=== Latency Test Results ===\n";
+        std::cout << "Average latency: " << latency << " us\n";
+        std::cout << "Total elapsed time: " << elapsed << " us\n";
+        std::cout << "Message rate: " << (roundtrip_count * 1000000.0 / elapsed) << " msg/s\n";
+
+        // Machine-readable record (appended to $ZMQ_BENCH_OUTPUT when set)
+        bench_output::record record;
+        record.benchmark = "lat_stream";
+        record.role = "client";
+        record.transport = "tcp";
+        record.endpoint = connect_to;
+        record.size = message_size;
+        record.count = roundtrip_count;
+        record.messages = roundtrip_count;
+        record.elapsed_us = static_cast<double>(elapsed);
+        record.latency_us = latency;
+        auto [major, minor, patch] = zmq::version();
+        record.zmq_version = std::to_string(major) + "." + std::to_string(minor) + "." + std::to_string(patch);
+        bench_output::emit(record);
+
+    } catch (const zmq::error_t &e) {
+        std::cerr << "ZMQ Error: " << e.what() << "\n";
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
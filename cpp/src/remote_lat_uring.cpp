@@ -0,0 +1,188 @@
+/*
+ * Raw TCP Latency Baseline - Remote (Client), io_uring
+ *
+ * Measures round-trip latency over a plain TCP socket. Each roundtrip submits
+ * one send (zero-copy from a registered buffer for payloads of 16 KB and
+ * above, a plain copying send below) and reaps the reply from an
+ * always-armed multishot recv.
+ * Pattern: raw TCP request-reply, counterpart of remote_lat
+ *
+ * Usage: ./remote_lat_uring <connect_to> <message_size> <roundtrip_count>
+ * Example: ./remote_lat_uring tcp://localhost:5557 64 10000
+ */
+
+#include "bench_output.hpp"
+#include "uring.hpp"
+
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <cstring>
+
+using namespace uring_bench;
+
+namespace {
+
+// Drives one request/reply exchange; returns 0 or an errno value
+int roundtrip(uring &ring, buffer_ring &buffers, int fd, const std::vector<char> &payload,
+              bool zerocopy, int &notifications) {
+    const size_t message_size = payload.size();
+    bool sent = false;
+    size_t received = 0;
+    int error = 0;
+
+    prep_send(ring.get_sqe(), fd, payload.data(), message_size, zerocopy);
+
+    while ((!sent || received < message_size) && error == 0) {
+        ring.submit(1);
+        ring.drain([&](const io_uring_cqe &cqe) {
+            if ((cqe.user_data & TAG_MASK) == TAG_SEND) {
+                if (cqe.flags & IORING_CQE_F_NOTIF) {
+                    notifications--;
+                    return;
+                }
+                if (cqe.flags & IORING_CQE_F_MORE) {
+                    notifications++;
+                }
+                if (cqe.res < 0) {
+                    error = -cqe.res;
+                    return;
+                }
+                size_t requested = static_cast<size_t>(cqe.user_data & ~TAG_MASK);
+                if (static_cast<size_t>(cqe.res) < requested) {
+                    prep_send(ring.get_sqe(), fd, payload.data(), requested - cqe.res, zerocopy);
+                    return;
+                }
+                sent = true;
+                return;
+            }
+
+            if (cqe.res < 0) {
+                if (cqe.res == -ENOBUFS) {
+                    prep_recv_multishot(ring.get_sqe(), fd, buffers);
+                    return;
+                }
+                error = -cqe.res;
+                return;
+            }
+            if (cqe.res == 0) {
+                error = ECONNRESET;
+                return;
+            }
+
+            received += static_cast<size_t>(cqe.res);
+            if (cqe.flags & IORING_CQE_F_BUFFER) {
+                buffers.recycle(static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+            }
+            if (!(cqe.flags & IORING_CQE_F_MORE)) {
+                prep_recv_multishot(ring.get_sqe(), fd, buffers);
+            }
+        });
+    }
+
+    if (error == 0 && received != message_size) {
+        error = EPROTO;
+    }
+    return error;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <connect_to> <message_size> <roundtrip_count>\n";
+        std::cerr << "Example: " << argv[0] << " tcp://localhost:5557 64 10000\n";
+        return 1;
+    }
+
+    const char *connect_to = argv[1];
+    size_t message_size = std::atoi(argv[2]);
+    int roundtrip_count = std::atoi(argv[3]);
+
+    if (message_size <= 0 || roundtrip_count <= 0) {
+        std::cerr << "Error: message_size and roundtrip_count must be positive\n";
+        return 1;
+    }
+
+    try {
+        int fd = tcp_connect(connect_to);
+        std::cout << "Connected to " << connect_to << "\n";
+        std::cout << "Message size: " << message_size << " bytes\n";
+        std::cout << "Roundtrip count: " << roundtrip_count << "\n";
+
+        uring ring(64);
+        buffer_ring buffers(ring, 0, RECV_BUFFER_COUNT, RECV_BUFFER_SIZE);
+
+        std::vector<char> send_buf(message_size, 'X');
+        iovec iov = {send_buf.data(), message_size};
+        ring.register_buffers(&iov, 1);
+        bool zerocopy = message_size >= ZEROCOPY_THRESHOLD && ring.supports_op(IORING_OP_SEND_ZC);
+        std::cout << "Send path: " << (zerocopy ? "IORING_OP_SEND_ZC" : "IORING_OP_SEND") << "\n";
+
+        prep_recv_multishot(ring.get_sqe(), fd, buffers);
+        int notifications = 0;
+
+        // Warm-up
+        int error = roundtrip(ring, buffers, fd, send_buf, zerocopy, notifications);
+        if (error != 0) {
+            std::cerr << "Error: warm-up roundtrip failed: " << std::strerror(error) << "\n";
+            return 1;
+        }
+
+        // Start timing
+        auto start = std::chrono::high_resolution_clock::now();
+
+        // Perform roundtrips
+        for (int i = 0; i < roundtrip_count; i++) {
+            error = roundtrip(ring, buffers, fd, send_buf, zerocopy, notifications);
+            if (error != 0) {
+                std::cerr << "Error: roundtrip " << i << " failed: " << std::strerror(error) << "\n";
+                return 1;
+            }
+        }
+
+        // Stop timing
+        auto end = std::chrono::high_resolution_clock::now();
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+        // Outstanding zero-copy notifications must be reaped before closing
+        while (notifications > 0) {
+            ring.submit(1);
+            ring.drain([&](const io_uring_cqe &cqe) {
+                if (cqe.flags & IORING_CQE_F_NOTIF) {
+                    notifications--;
+                }
+            });
+        }
+        close(fd);
+
+        // Calculate latency (divide by 2 for one-way, not round-trip)
+        double latency = static_cast<double>(elapsed) / static_cast<double>(roundtrip_count * 2);
+
+        // Print results
+        std::cout << "\n=== Latency Test Results ===\n";
+        std::cout << "Average latency: " << latency << " us\n";
+        std::cout << "Total elapsed time: " << elapsed << " us\n";
+        std::cout << "Message rate: " << (roundtrip_count * 1000000.0 / elapsed) << " msg/s\n";
+
+        // Machine-readable record (appended to $ZMQ_BENCH_OUTPUT when set)
+        bench_output::record record;
+        record.benchmark = "lat_uring";
+        record.role = "client";
+        record.transport = "tcp";
+        record.endpoint = connect_to;
+        record.size = message_size;
+        record.count = roundtrip_count;
+        record.messages = roundtrip_count;
+        record.elapsed_us = static_cast<double>(elapsed);
+        record.latency_us = latency;
+        record.binding = "none";
+        bench_output::emit(record);
+
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
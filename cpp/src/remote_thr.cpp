@@ -4,26 +4,31 @@
  * Sends messages using PUSH socket for throughput measurement.
  * Pattern: PUSH -> PULL (unidirectional data flow)
  *
- * Usage: ./remote_thr <connect_to> <message_size> <message_count>
+ * Thin wrapper over `zmqbench thr --role client`, kept so existing scripts
+ * and the cross-language runners can keep calling it by name.
+ *
+ * With the CURVE public key printed by `local_thr ... curve`, the connection
+ * is encrypted (client keypair generated at startup).
+ *
+ * Usage: ./remote_thr <connect_to> <message_size> <message_count> [curve_server_key]
  * Example: ./remote_thr tcp://localhost:5556 64 1000000
  */
 
-#include <zmq.hpp>
+#include "bench_output.hpp"
+#include "zmqbench/commands.hpp"
+
 #include <iostream>
-#include <vector>
-#include <cstring>
-#include <thread>
-#include <chrono>
+#include <cstdlib>
+#include <string>
 
 int main(int argc, char *argv[]) {
-    if (argc != 4) {
-        std::cerr << "Usage: " << argv[0] << " <connect_to> <message_size> <message_count>\n";
+    if (argc != 4 && argc != 5) {
+        std::cerr << "Usage: " << argv[0] << " <connect_to> <message_size> <message_count> [curve_server_key]\n";
         std::cerr << "Example: " << argv[0] << " tcp://localhost:5556 64 1000000\n";
         return 1;
     }
 
-    const char *connect_to = argv[1];
-    size_t message_size = std::atoi(argv[2]);
+    int message_size = std::atoi(argv[2]);
     int message_count = std::atoi(argv[3]);
 
     if (message_size <= 0 || message_count <= 0) {
@@ -31,55 +36,21 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    try {
-        // Create context and PUSH socket
-        zmq::context_t context(1);
-        zmq::socket_t socket(context, zmq::socket_type::push);
-
-        // Connect to receiver
-        socket.connect(connect_to);
-        std::cout << "Connected to " << connect_to << "\n";
-        std::cout << "Message size: " << message_size << " bytes\n";
-        std::cout << "Message count: " << message_count << "\n";
-
-        // Wait for connection to establish
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-
-        // Prepare message buffer
-        std::vector<char> buffer(message_size, 'X');
-
-        std::cout << "Sending messages...\n";
-
-        // Send messages
-        for (int i = 0; i < message_count; i++) {
-            zmq::message_t message(buffer.data(), message_size);
-            auto result = socket.send(message, zmq::send_flags::none);
-
-            if (!result) {
-                std::cerr << "Error: Failed to send message " << i << "\n";
-                return 1;
-            }
-
-            // Progress indicator (every 10%)
-            if (message_count > 100 && (i + 1) % (message_count / 10) == 0) {
-                int progress = ((i + 1) * 100) / message_count;
-                std::cout << "Progress: " << progress << "% (" << (i + 1) << "/" << message_count << ")\n";
-            }
+    zmqbench::options opt;
+    opt.command = "thr";
+    opt.role = zmqbench::role::client;
+    opt.endpoint = argv[1];
+    opt.sizes = {static_cast<size_t>(message_size)};
+    opt.count = message_count;
+    opt.output = bench_output::output_path_from_env();
+    if (argc == 5) {
+        opt.mechanisms = {"curve"};
+        opt.curve_serverkey = argv[4];
+        if (opt.curve_serverkey.size() != 40) {
+            std::cerr << "Error: curve_server_key must be the 40-character Z85 key printed by local_thr\n";
+            return 1;
         }
-
-        std::cout << "\nSent " << message_count << " messages successfully.\n";
-        std::cout << "Total data sent: " << (message_size * message_count / (1024.0 * 1024.0)) << " MB\n";
-
-        // Give time for messages to be delivered
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-
-    } catch (const zmq::error_t &e) {
-        std::cerr << "ZMQ Error: " << e.what() << "\n";
-        return 1;
-    } catch (const std::exception &e) {
-        std::cerr << "Error: " << e.what() << "\n";
-        return 1;
     }
 
-    return 0;
+    return zmqbench::run(opt);
 }
@@ -0,0 +1,76 @@
+/*
+ * ZeroMQ C++ Throughput Test - Async (Remote / Sender)
+ *
+ * Sender of local_thr_async: the send loop is a C++20 coroutine that
+ * co_awaits send on the PUSH socket and only suspends at the high-water
+ * mark, resumed by an edge-triggered epoll loop on ZMQ_FD (zmq_async.hpp).
+ * Pattern: PUSH -> PULL (unidirectional data flow)
+ *
+ * Usage: ./remote_thr_async <connect_to> <message_size> <message_count>
+ * Example: ./remote_thr_async tcp://localhost:5556 64 1000000
+ */
+
+#include "zmq_async.hpp"
+
+#include <zmq.hpp>
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+
+namespace {
+
+async_bench::task send_all(async_bench::async_socket &socket, size_t message_size, int message_count) {
+    std::vector<char> payload(message_size, 'X');
+    for (int i = 0; i < message_count; i++) {
+        zmq::message_t message(payload.data(), payload.size());
+        co_await socket.send(message);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <connect_to> <message_size> <message_count>\n";
+        std::cerr << "Example: " << argv[0] << " tcp://localhost:5556 64 1000000\n";
+        return 1;
+    }
+
+    const char *connect_to = argv[1];
+    int message_size = std::atoi(argv[2]);
+    int message_count = std::atoi(argv[3]);
+
+    if (message_size <= 0 || message_count <= 0) {
+        std::cerr << "Error: message_size and message_count must be positive\n";
+        return 1;
+    }
+
+    try {
+        zmq::context_t context(1);
+        zmq::socket_t socket(context, zmq::socket_type::push);
+        socket.connect(connect_to);
+        std::cout << "Connected to " << connect_to << "\n";
+        std::cout << "Message size: " << message_size << " bytes\n";
+        std::cout << "Message count: " << message_count << "\n";
+
+        async_bench::reactor loop;
+        async_bench::async_socket async(loop, socket);
+
+        async_bench::task work = send_all(async, static_cast<size_t>(message_size), message_count);
+        loop.run(work);
+
+        // The context's default linger flushes the queue before exit
+        std::cout << "Sent " << message_count << " messages.\n";
+        std::cout << "Epoll wakeups: " << (static_cast<double>(loop.wakeups()) / message_count)
+                  << " per message\n";
+
+    } catch (const zmq::error_t &e) {
+        std::cerr << "ZMQ Error: " << e.what() << "\n";
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
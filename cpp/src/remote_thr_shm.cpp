@@ -0,0 +1,72 @@
+/*
+ * Shared-Memory Throughput Baseline - Remote (Producer)
+ *
+ * Opens the ring created by local_thr_shm and copies messages into it as fast
+ * as the consumer drains them.
+ * Pattern: SPSC ring, counterpart of remote_thr
+ *
+ * Usage: ./remote_thr_shm <ring_name> <message_size> <message_count>
+ * Example: ./remote_thr_shm /zmq_bench_thr 64 1000000
+ */
+
+#include "shm_ring.hpp"
+
+#include <iostream>
+#include <vector>
+#include <cstring>
+
+int main(int argc, char *argv[]) {
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <ring_name> <message_size> <message_count>\n";
+        std::cerr << "Example: " << argv[0] << " /zmq_bench_thr 64 1000000\n";
+        return 1;
+    }
+
+    const char *ring_name = argv[1];
+    size_t message_size = std::atoi(argv[2]);
+    int message_count = std::atoi(argv[3]);
+
+    if (message_size <= 0 || message_count <= 0) {
+        std::cerr << "Error: message_size and message_count must be positive\n";
+        return 1;
+    }
+
+    try {
+        // Waits for the consumer to create the ring
+        shm_bench::ring ring = shm_bench::ring::open(ring_name);
+        if (ring.max_payload() < message_size) {
+            std::cerr << "Error: ring slots hold " << ring.max_payload()
+                      << " bytes, message size is " << message_size << "\n";
+            return 1;
+        }
+
+        std::cout << "Opened ring " << ring_name << " (" << ring.slot_count() << " slots)\n";
+        std::cout << "Message size: " << message_size << " bytes\n";
+        std::cout << "Message count: " << message_count << "\n";
+
+        // Prepare message buffer
+        std::vector<char> buffer(message_size, 'X');
+
+        std::cout << "Sending messages...\n";
+
+        // Send messages
+        for (int i = 0; i < message_count; i++) {
+            ring.push(buffer.data(), message_size);
+
+            // Progress indicator (every 10%)
+            if (message_count > 100 && (i + 1) % (message_count / 10) == 0) {
+                int progress = ((i + 1) * 100) / message_count;
+                std::cout << "Progress: " << progress << "% (" << (i + 1) << "/" << message_count << ")\n";
+            }
+        }
+
+        std::cout << "\nSent " << message_count << " messages successfully.\n";
+        std::cout << "Total data sent: " << (message_size * message_count / (1024.0 * 1024.0)) << " MB\n";
+
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,92 @@
+/*
+ * ZeroMQ C++ Throughput Test - ZMQ_STREAM (Remote / Sender)
+ *
+ * Sends length-prefixed messages as raw TCP data over a ZMQ_STREAM socket.
+ * Counterpart of remote_thr with the ZMTP protocol layer removed.
+ * Pattern: STREAM -> STREAM (unidirectional, application-level framing)
+ *
+ * Usage: ./remote_thr_stream <connect_to> <message_size> <message_count>
+ * Example: ./remote_thr_stream tcp://localhost:5559 64 1000000
+ */
+
+#include "stream_framing.hpp"
+
+#include <zmq.hpp>
+#include <iostream>
+#include <vector>
+#include <cstring>
+
+int main(int argc, char *argv[]) {
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <connect_to> <message_size> <message_count>\n";
+        std::cerr << "Example: " << argv[0] << " tcp://localhost:5559 64 1000000\n";
+        return 1;
+    }
+
+    const char *connect_to = argv[1];
+    size_t message_size = std::atoi(argv[2]);
+    int message_count = std::atoi(argv[3]);
+
+    if (message_size <= 0 || message_count <= 0) {
+        std::cerr << "Error: message_size and message_count must be positive\n";
+        return 1;
+    }
+
+    try {
+        // Create context and STREAM socket
+        zmq::context_t context(1);
+        zmq::socket_t socket(context, zmq::socket_type::stream);
+
+        // Connect to receiver
+        socket.connect(connect_to);
+        std::cout << "Connected to " << connect_to << "\n";
+        std::cout << "Message size: " << message_size << " bytes\n";
+        std::cout << "Message count: " << message_count << "\n";
+
+        // Connect notification carries the routing id of the receiver;
+        // replaces the fixed sleep of remote_thr
+        zmq::message_t peer_id;
+        zmq::message_t notify;
+        socket.recv(peer_id, zmq::recv_flags::none);
+        socket.recv(notify, zmq::recv_flags::none);
+
+        // Prepare [length][payload] frame
+        std::vector<char> frame = stream_bench::encode_frame(message_size);
+
+        std::cout << "Sending messages...\n";
+
+        // Send messages: [routing id][frame]
+        for (int i = 0; i < message_count; i++) {
+            zmq::message_t id(peer_id.data(), peer_id.size());
+            zmq::message_t message(frame.data(), frame.size());
+            auto result = socket.send(id, zmq::send_flags::sndmore);
+            if (result) {
+                result = socket.send(message, zmq::send_flags::none);
+            }
+
+            if (!result) {
+                std::cerr << "Error: Failed to send message " << i << "\n";
+                return 1;
+            }
+
+            // Progress indicator (every 10%)
+            if (message_count > 100 && (i + 1) % (message_count / 10) == 0) {
+                int progress = ((i + 1) * 100) / message_count;
+                std::cout << "Progress: " << progress << "% (" << (i + 1) << "/" << message_count << ")\n";
+            }
+        }
+
+        std::cout << "\nSent " << message_count << " messages successfully.\n";
+        std::cout << "Total data sent: " << (message_size * message_count / (1024.0 * 1024.0)) << " MB\n";
+        // Default linger: closing the context flushes what is still queued
+
+    } catch (const zmq::error_t &e) {
+        std::cerr << "ZMQ Error: " << e.what() << "\n";
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,261 @@
+/*
+ * Cross-process single-producer/single-consumer ring in POSIX shared memory.
+ *
+ * The ring lives in a shm_open() segment (/dev/shm/<name> on Linux). Head and
+ * tail each sit on their own cache line, and each side keeps a private copy of
+ * the other side's index so the shared line is only re-read when the ring
+ * looks full (producer) or empty (consumer).
+ *
+ * Slot layout: [uint32_t size][payload], stride rounded up to a cache line.
+ */
+
+#ifndef ZMQ_BENCHMARK_SHM_RING_HPP
+#define ZMQ_BENCHMARK_SHM_RING_HPP
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+
+namespace shm_bench {
+
+constexpr size_t CACHE_LINE = 64;
+constexpr uint64_t RING_MAGIC = 0x7a6d71726e673031ULL;  // "zmqrng01"
+
+// Target footprint of the slot array; small messages get more slots
+constexpr size_t RING_BYTES = 4 * 1024 * 1024;
+constexpr uint64_t MIN_SLOTS = 16;
+
+// Spin iterations before a waiting side gives up its time slice; keeps the
+// ring usable when producer and consumer share a core
+constexpr unsigned SPINS_BEFORE_YIELD = 1024;
+
+inline void cpu_relax(unsigned &spins) {
+    if (++spins < SPINS_BEFORE_YIELD) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield" ::: "memory");
+#endif
+    } else {
+        spins = 0;
+        std::this_thread::yield();
+    }
+}
+
+struct alignas(CACHE_LINE) padded_index {
+    std::atomic<uint64_t> value;
+    char pad[CACHE_LINE - sizeof(std::atomic<uint64_t>)];
+};
+
+struct ring_header {
+    std::atomic<uint64_t> magic;  // published last by the creator
+    uint64_t slot_count;          // power of two
+    uint64_t slot_stride;
+    uint64_t max_payload;
+    char pad[CACHE_LINE - 4 * sizeof(uint64_t)];
+
+    padded_index head;  // next slot the consumer reads
+    padded_index tail;  // next slot the producer writes
+};
+
+static_assert(sizeof(ring_header) == 3 * CACHE_LINE, "ring header must be cache-line padded");
+
+inline size_t slot_stride_for(size_t max_payload) {
+    size_t raw = sizeof(uint32_t) + max_payload;
+    return (raw + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+}
+
+inline uint64_t slot_count_for(size_t stride) {
+    uint64_t count = MIN_SLOTS;
+    while ((count * 2) * stride <= RING_BYTES) {
+        count *= 2;
+    }
+    return count;
+}
+
+class ring {
+public:
+    // Consumer side: creates (or replaces) the segment and initialises the ring
+    static ring create(const std::string &name, size_t max_payload) {
+        shm_unlink(name.c_str());
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "shm_open(" + name + ")");
+        }
+
+        size_t stride = slot_stride_for(max_payload);
+        uint64_t slots = slot_count_for(stride);
+        size_t size = sizeof(ring_header) + slots * stride;
+        if (ftruncate(fd, static_cast<off_t>(size)) < 0) {
+            int err = errno;
+            close(fd);
+            shm_unlink(name.c_str());
+            throw std::system_error(err, std::generic_category(), "ftruncate");
+        }
+
+        ring r(name, fd, size, true);
+        r.header_->slot_count = slots;
+        r.header_->slot_stride = stride;
+        r.header_->max_payload = max_payload;
+        r.header_->head.value.store(0, std::memory_order_relaxed);
+        r.header_->tail.value.store(0, std::memory_order_relaxed);
+        r.header_->magic.store(RING_MAGIC, std::memory_order_release);
+        r.init_geometry();
+        return r;
+    }
+
+    // Producer side: waits until the consumer has created the ring
+    static ring open(const std::string &name, std::chrono::milliseconds timeout = std::chrono::seconds(10)) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (true) {
+            int fd = shm_open(name.c_str(), O_RDWR, 0600);
+            if (fd >= 0) {
+                struct stat st;
+                if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(ring_header)) {
+                    ring r(name, fd, static_cast<size_t>(st.st_size), false);
+                    if (r.header_->magic.load(std::memory_order_acquire) == RING_MAGIC) {
+                        r.init_geometry();
+                        return r;
+                    }
+                } else {
+                    close(fd);
+                }
+            } else if (errno != ENOENT) {
+                throw std::system_error(errno, std::generic_category(), "shm_open(" + name + ")");
+            }
+
+            if (std::chrono::steady_clock::now() > deadline) {
+                throw std::runtime_error("timed out waiting for shared-memory ring " + name);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    ring(ring &&other) noexcept
+        : name_(std::move(other.name_)), size_(other.size_), owner_(other.owner_),
+          base_(other.base_), header_(other.header_), slots_(other.slots_),
+          mask_(other.mask_), stride_(other.stride_), max_payload_(other.max_payload_) {
+        other.base_ = nullptr;
+        other.owner_ = false;
+    }
+
+    ~ring() {
+        if (base_ != nullptr) {
+            munmap(base_, size_);
+        }
+        if (owner_) {
+            shm_unlink(name_.c_str());
+        }
+    }
+
+    ring(const ring &) = delete;
+    ring &operator=(const ring &) = delete;
+    ring &operator=(ring &&) = delete;
+
+    // Removes the name from /dev/shm; the mapping stays valid for both sides.
+    // The consumer calls this once the producer is attached so a later run
+    // can never pick up this segment.
+    void unlink() {
+        if (owner_) {
+            shm_unlink(name_.c_str());
+            owner_ = false;
+        }
+    }
+
+    size_t max_payload() const { return max_payload_; }
+    uint64_t slot_count() const { return mask_ + 1; }
+
+    // Producer: copies one message into the next slot, spinning while full
+    void push(const void *data, size_t size) {
+        if (size > max_payload_) {
+            throw std::length_error("message of " + std::to_string(size) + " bytes exceeds the ring's " +
+                                    std::to_string(max_payload_) + "-byte slots");
+        }
+        uint64_t tail = header_->tail.value.load(std::memory_order_relaxed);
+        unsigned spins = 0;
+        while (tail - cached_head_ > mask_) {
+            cached_head_ = header_->head.value.load(std::memory_order_acquire);
+            if (tail - cached_head_ > mask_) {
+                cpu_relax(spins);
+            }
+        }
+
+        char *slot = slots_ + (tail & mask_) * stride_;
+        uint32_t len = static_cast<uint32_t>(size);
+        std::memcpy(slot, &len, sizeof(len));
+        std::memcpy(slot + sizeof(len), data, size);
+        header_->tail.value.store(tail + 1, std::memory_order_release);
+    }
+
+    // Consumer: copies the next message out, spinning while empty; returns its size
+    size_t pop(void *data) {
+        uint64_t head = header_->head.value.load(std::memory_order_relaxed);
+        unsigned spins = 0;
+        while (head == cached_tail_) {
+            cached_tail_ = header_->tail.value.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                cpu_relax(spins);
+            }
+        }
+
+        const char *slot = slots_ + (head & mask_) * stride_;
+        uint32_t len;
+        std::memcpy(&len, slot, sizeof(len));
+        std::memcpy(data, slot + sizeof(len), len);
+        header_->head.value.store(head + 1, std::memory_order_release);
+        return len;
+    }
+
+private:
+    ring(std::string name, int fd, size_t size, bool owner)
+        : name_(std::move(name)), size_(size), owner_(owner) {
+        base_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        int err = errno;
+        close(fd);
+        if (base_ == MAP_FAILED) {
+            base_ = nullptr;
+            // No destructor runs for a half-built ring; create() would leave the name behind
+            if (owner_) {
+                shm_unlink(name_.c_str());
+            }
+            throw std::system_error(err, std::generic_category(), "mmap shared ring");
+        }
+        header_ = static_cast<ring_header *>(base_);
+    }
+
+    void init_geometry() {
+        slots_ = static_cast<char *>(base_) + sizeof(ring_header);
+        mask_ = header_->slot_count - 1;
+        stride_ = header_->slot_stride;
+        max_payload_ = header_->max_payload;
+    }
+
+    std::string name_;
+    size_t size_ = 0;
+    bool owner_ = false;
+    void *base_ = nullptr;
+    ring_header *header_ = nullptr;
+    char *slots_ = nullptr;
+    uint64_t mask_ = 0;
+    size_t stride_ = 0;
+    size_t max_payload_ = 0;
+
+    // Private snapshots of the other side's index
+    uint64_t cached_head_ = 0;
+    uint64_t cached_tail_ = 0;
+};
+
+}  // namespace shm_bench
+
+#endif  // ZMQ_BENCHMARK_SHM_RING_HPP
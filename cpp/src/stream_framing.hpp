@@ -0,0 +1,89 @@
+/*
+ * Application-level framing for the ZMQ_STREAM benchmarks.
+ *
+ * ZMQ_STREAM hands the application raw TCP bytes in arbitrary chunks, so the
+ * benchmarks carry their own framing: a 4-byte big-endian length followed by
+ * the payload. encode_frame() builds one frame; frame_decoder reassembles
+ * frames from the chunk stream, copying only when a frame spans chunks.
+ */
+
+#ifndef ZMQ_BENCHMARK_STREAM_FRAMING_HPP
+#define ZMQ_BENCHMARK_STREAM_FRAMING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace stream_bench {
+
+constexpr size_t HEADER_SIZE = 4;
+
+// Builds a [length][payload] frame filled with 'X'
+inline std::vector<char> encode_frame(size_t payload_size) {
+    std::vector<char> frame(HEADER_SIZE + payload_size, 'X');
+    uint32_t len = static_cast<uint32_t>(payload_size);
+    frame[0] = static_cast<char>((len >> 24) & 0xFF);
+    frame[1] = static_cast<char>((len >> 16) & 0xFF);
+    frame[2] = static_cast<char>((len >> 8) & 0xFF);
+    frame[3] = static_cast<char>(len & 0xFF);
+    return frame;
+}
+
+inline uint32_t decode_length(const char *header) {
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(header);
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+class frame_decoder {
+public:
+    // Feeds one chunk; calls on_frame(payload, length) for every completed frame
+    template <typename Fn>
+    void feed(const char *data, size_t size, Fn &&on_frame) {
+        // Finish a frame left over from the previous chunk first
+        while (!pending_.empty() && size > 0) {
+            size_t need = pending_need();
+            size_t take = need < size ? need : size;
+            pending_.insert(pending_.end(), data, data + take);
+            data += take;
+            size -= take;
+
+            if (pending_.size() >= HEADER_SIZE &&
+                pending_.size() == HEADER_SIZE + decode_length(pending_.data())) {
+                on_frame(pending_.data() + HEADER_SIZE, pending_.size() - HEADER_SIZE);
+                pending_.clear();
+            }
+        }
+
+        // Whole frames inside this chunk are handed out without copying
+        while (size >= HEADER_SIZE) {
+            uint32_t len = decode_length(data);
+            if (size < HEADER_SIZE + len) {
+                break;
+            }
+            on_frame(data + HEADER_SIZE, len);
+            data += HEADER_SIZE + len;
+            size -= HEADER_SIZE + len;
+        }
+
+        if (size > 0) {
+            pending_.assign(data, data + size);
+        }
+    }
+
+private:
+    // Bytes still missing from the pending header, or from the pending frame
+    size_t pending_need() const {
+        if (pending_.size() < HEADER_SIZE) {
+            return HEADER_SIZE - pending_.size();
+        }
+        return HEADER_SIZE + decode_length(pending_.data()) - pending_.size();
+    }
+
+    std::vector<char> pending_;
+};
+
+}  // namespace stream_bench
+
+#endif  // ZMQ_BENCHMARK_STREAM_FRAMING_HPP
@@ -0,0 +1,404 @@
+/*
+ * Minimal io_uring and TCP helpers for the raw-socket baseline.
+ *
+ * Talks to the kernel directly through io_uring_setup/io_uring_enter so the
+ * baseline needs nothing beyond the Linux UAPI headers (no liburing).
+ * Provides:
+ *   - uring          SQ/CQ ring mapping, batched submit, CQE draining
+ *   - buffer_ring    provided-buffer ring for multishot recv
+ *   - tcp_listen / tcp_connect taking the same "tcp://host:port" endpoints
+ *     as the ZeroMQ benchmarks
+ */
+
+#ifndef ZMQ_BENCHMARK_URING_HPP
+#define ZMQ_BENCHMARK_URING_HPP
+
+#include <linux/io_uring.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace uring_bench {
+
+// user_data tags, kept in the top byte so the low bits can carry a length
+constexpr uint64_t TAG_RECV = 1ULL << 56;
+constexpr uint64_t TAG_SEND = 2ULL << 56;
+constexpr uint64_t TAG_MASK = 0xFFULL << 56;
+
+// Payloads at or above this size use IORING_OP_SEND_ZC when available
+constexpr size_t ZEROCOPY_THRESHOLD = 16384;
+
+// Provided buffers for multishot recv
+constexpr unsigned RECV_BUFFER_COUNT = 64;
+constexpr unsigned RECV_BUFFER_SIZE = 65536;
+
+inline std::system_error errno_error(int err, const char *what) {
+    return std::system_error(err, std::generic_category(), what);
+}
+
+class uring {
+public:
+    explicit uring(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        params.flags = IORING_SETUP_CQSIZE;
+        params.cq_entries = entries * 4;  // multishot recv can outpace submissions
+
+        fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd_ < 0) {
+            throw errno_error(errno, "io_uring_setup");
+        }
+
+        sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        single_mmap_ = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap_) {
+            sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+        }
+
+        sq_ring_ = map(sq_ring_size_, IORING_OFF_SQ_RING);
+        cq_ring_ = single_mmap_ ? sq_ring_ : map(cq_ring_size_, IORING_OFF_CQ_RING);
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe *>(map(sqes_size_, IORING_OFF_SQES));
+
+        auto *sq = static_cast<char *>(sq_ring_);
+        sq_head_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        sq_entries_ = params.sq_entries;
+
+        // SQEs are always filled in ring order, so the index array is the identity
+        auto *array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        for (unsigned i = 0; i < sq_entries_; i++) {
+            array[i] = i;
+        }
+
+        auto *cq = static_cast<char *>(cq_ring_);
+        cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+        sqe_tail_ = *sq_tail_;
+    }
+
+    ~uring() {
+        munmap(sqes_, sqes_size_);
+        if (!single_mmap_) {
+            munmap(cq_ring_, cq_ring_size_);
+        }
+        munmap(sq_ring_, sq_ring_size_);
+        close(fd_);
+    }
+
+    uring(const uring &) = delete;
+    uring &operator=(const uring &) = delete;
+
+    int fd() const { return fd_; }
+
+    // Returns a zeroed SQE, flushing the submission queue first if it is full
+    io_uring_sqe *get_sqe() {
+        if (sqe_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+            submit();
+        }
+        io_uring_sqe *sqe = &sqes_[sqe_tail_ & sq_mask_];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe_tail_++;
+        return sqe;
+    }
+
+    // Publishes all queued SQEs in one io_uring_enter and optionally waits
+    // for at least wait_nr completions
+    int submit(unsigned wait_nr = 0) {
+        __atomic_store_n(sq_tail_, sqe_tail_, __ATOMIC_RELEASE);
+        unsigned to_submit = sqe_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+
+        if (to_submit == 0 && wait_nr == 0) {
+            return 0;
+        }
+
+        unsigned flags = wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0;
+        int ret;
+        do {
+            ret = static_cast<int>(syscall(__NR_io_uring_enter, fd_, to_submit, wait_nr,
+                                           flags, nullptr, 0));
+        } while (ret < 0 && errno == EINTR);
+
+        if (ret < 0) {
+            throw errno_error(errno, "io_uring_enter");
+        }
+        return ret;
+    }
+
+    // Calls fn(cqe) for every available completion, then retires them at once
+    template <typename Fn>
+    unsigned drain(Fn &&fn) {
+        unsigned head = *cq_head_;
+        unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        unsigned count = 0;
+        for (; head != tail; head++, count++) {
+            fn(cqes_[head & cq_mask_]);
+        }
+        if (count > 0) {
+            __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+        }
+        return count;
+    }
+
+    void register_buffers(const iovec *iovecs, unsigned count) {
+        if (syscall(__NR_io_uring_register, fd_, IORING_REGISTER_BUFFERS, iovecs, count) < 0) {
+            throw errno_error(errno, "IORING_REGISTER_BUFFERS");
+        }
+    }
+
+    bool supports_op(unsigned op) const {
+        constexpr unsigned PROBE_OPS = 256;
+        std::vector<char> storage(sizeof(io_uring_probe) + PROBE_OPS * sizeof(io_uring_probe_op), 0);
+        auto *probe = reinterpret_cast<io_uring_probe *>(storage.data());
+        if (syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PROBE, probe, PROBE_OPS) < 0) {
+            return false;
+        }
+        return op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED) != 0;
+    }
+
+private:
+    void *map(size_t size, uint64_t offset) {
+        void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         fd_, static_cast<off_t>(offset));
+        if (ptr == MAP_FAILED) {
+            throw errno_error(errno, "mmap io_uring");
+        }
+        return ptr;
+    }
+
+    int fd_ = -1;
+    bool single_mmap_ = false;
+
+    void *sq_ring_ = nullptr;
+    void *cq_ring_ = nullptr;
+    size_t sq_ring_size_ = 0;
+    size_t cq_ring_size_ = 0;
+    io_uring_sqe *sqes_ = nullptr;
+    size_t sqes_size_ = 0;
+
+    unsigned *sq_head_ = nullptr;
+    unsigned *sq_tail_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    unsigned sqe_tail_ = 0;
+
+    unsigned *cq_head_ = nullptr;
+    unsigned *cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe *cqes_ = nullptr;
+};
+
+// Kernel-provided buffer ring (IORING_REGISTER_PBUF_RING) for multishot recv.
+// Buffers are handed back to the kernel with recycle() once consumed.
+class buffer_ring {
+public:
+    buffer_ring(uring &ring, uint16_t group_id, unsigned count, unsigned buffer_size)
+        : count_(count), buffer_size_(buffer_size), group_id_(group_id) {
+        ring_size_ = count_ * sizeof(io_uring_buf);
+        void *mem = mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE,
+                         MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+        if (mem == MAP_FAILED) {
+            throw errno_error(errno, "mmap buffer ring");
+        }
+        std::memset(mem, 0, ring_size_);  // tail starts at zero
+        br_ = static_cast<io_uring_buf_ring *>(mem);
+        storage_.resize(static_cast<size_t>(count_) * buffer_size_);
+
+        io_uring_buf_reg reg;
+        std::memset(&reg, 0, sizeof(reg));
+        reg.ring_addr = reinterpret_cast<uint64_t>(br_);
+        reg.ring_entries = count_;
+        reg.bgid = group_id_;
+        if (syscall(__NR_io_uring_register, ring.fd(), IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+            int err = errno;
+            munmap(br_, ring_size_);
+            throw errno_error(err, "IORING_REGISTER_PBUF_RING (kernel 5.19+ required)");
+        }
+
+        for (unsigned i = 0; i < count_; i++) {
+            add(static_cast<uint16_t>(i), i);
+        }
+        publish(count_);
+    }
+
+    ~buffer_ring() { munmap(br_, ring_size_); }
+
+    buffer_ring(const buffer_ring &) = delete;
+    buffer_ring &operator=(const buffer_ring &) = delete;
+
+    uint16_t group_id() const { return group_id_; }
+    const char *data(uint16_t bid) const { return storage_.data() + static_cast<size_t>(bid) * buffer_size_; }
+
+    void recycle(uint16_t bid) {
+        add(bid, 0);
+        publish(1);
+    }
+
+private:
+    void add(uint16_t bid, unsigned offset) {
+        // Index from the ring base: in C++ the UAPI flex-array wrapper puts
+        // br_->bufs one empty struct (padded to 8 bytes) past where the kernel reads
+        io_uring_buf &buf = reinterpret_cast<io_uring_buf *>(br_)[(tail_ + offset) & (count_ - 1)];
+        buf.addr = reinterpret_cast<uint64_t>(storage_.data() + static_cast<size_t>(bid) * buffer_size_);
+        buf.len = buffer_size_;
+        buf.bid = bid;
+    }
+
+    void publish(unsigned added) {
+        tail_ = static_cast<uint16_t>(tail_ + added);
+        __atomic_store_n(&br_->tail, tail_, __ATOMIC_RELEASE);
+    }
+
+    unsigned count_;
+    unsigned buffer_size_;
+    uint16_t group_id_;
+    uint16_t tail_ = 0;
+    size_t ring_size_ = 0;
+    io_uring_buf_ring *br_ = nullptr;
+    std::vector<char> storage_;
+};
+
+inline void prep_recv_multishot(io_uring_sqe *sqe, int fd, const buffer_ring &buffers) {
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = buffers.group_id();
+    sqe->user_data = TAG_RECV;
+}
+
+// Plain sends copy from buf by address. Zero-copy sends use registered
+// buffer 0 (IORING_RECVSEND_FIXED_BUF; buf must point into it) and post an
+// extra IORING_CQE_F_NOTIF completion once the kernel releases the pages
+inline void prep_send(io_uring_sqe *sqe, int fd, const char *buf, size_t len, bool zerocopy) {
+    sqe->opcode = zerocopy ? IORING_OP_SEND_ZC : IORING_OP_SEND;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(buf);
+    sqe->len = static_cast<uint32_t>(len);
+    if (zerocopy) {
+        sqe->ioprio = IORING_RECVSEND_FIXED_BUF;
+        sqe->buf_index = 0;
+    }
+    sqe->user_data = TAG_SEND | len;
+}
+
+// Splits "tcp://host:port" into host and port; "*" binds all interfaces
+inline void parse_endpoint(const std::string &endpoint, std::string &host, std::string &port) {
+    const std::string prefix = "tcp://";
+    if (endpoint.compare(0, prefix.size(), prefix) != 0) {
+        throw std::invalid_argument("only tcp:// endpoints are supported: " + endpoint);
+    }
+    std::string rest = endpoint.substr(prefix.size());
+    size_t colon = rest.rfind(':');
+    if (colon == std::string::npos) {
+        throw std::invalid_argument("missing port in endpoint: " + endpoint);
+    }
+    host = rest.substr(0, colon);
+    port = rest.substr(colon + 1);
+}
+
+inline addrinfo *resolve(const std::string &endpoint, bool passive) {
+    std::string host, port;
+    parse_endpoint(endpoint, host, port);
+
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+
+    addrinfo *result = nullptr;
+    const char *node = (passive && host == "*") ? nullptr : host.c_str();
+    int rc = getaddrinfo(node, port.c_str(), &hints, &result);
+    if (rc != 0) {
+        throw std::runtime_error("getaddrinfo(" + endpoint + "): " + gai_strerror(rc));
+    }
+    return result;
+}
+
+inline void set_nodelay(int fd) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+// Binds, listens and blocks until exactly one peer connects
+inline int tcp_listen_accept(const std::string &endpoint) {
+    addrinfo *ai = resolve(endpoint, true);
+    int listener = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+    if (listener < 0) {
+        freeaddrinfo(ai);
+        throw errno_error(errno, "socket");
+    }
+
+    int one = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(listener, ai->ai_addr, ai->ai_addrlen) < 0 || listen(listener, 1) < 0) {
+        int err = errno;
+        freeaddrinfo(ai);
+        close(listener);
+        throw errno_error(err, "bind/listen");
+    }
+    freeaddrinfo(ai);
+
+    int fd = accept(listener, nullptr, nullptr);
+    int err = errno;
+    close(listener);
+    if (fd < 0) {
+        throw errno_error(err, "accept");
+    }
+    set_nodelay(fd);
+    return fd;
+}
+
+// Connects, retrying while the peer is not listening yet (ZeroMQ's connect
+// does the same implicitly)
+inline int tcp_connect(const std::string &endpoint) {
+    addrinfo *ai = resolve(endpoint, false);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+    while (true) {
+        int fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) {
+            freeaddrinfo(ai);
+            throw errno_error(errno, "socket");
+        }
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+            freeaddrinfo(ai);
+            set_nodelay(fd);
+            return fd;
+        }
+
+        int err = errno;
+        close(fd);
+        if (err != ECONNREFUSED || std::chrono::steady_clock::now() > deadline) {
+            freeaddrinfo(ai);
+            throw errno_error(err, "connect");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+}  // namespace uring_bench
+
+#endif  // ZMQ_BENCHMARK_URING_HPP
@@ -0,0 +1,246 @@
+/*
+ * Asynchronous ZeroMQ I/O for the *_async benchmarks: an edge-triggered epoll
+ * loop on ZMQ_FD and C++20 coroutine awaitables for send/recv.
+ *
+ * Provides:
+ *   - task           lazily started coroutine, run to completion by a reactor
+ *   - reactor        epoll on each socket's ZMQ_FD (EPOLLET); resumes the
+ *                    coroutine parked on a socket once ZMQ_EVENTS allows it
+ *   - async_socket   co_await sock.recv(msg) / co_await sock.send(msg)
+ *
+ * ZMQ_FD is edge-triggered and only signals again after ZMQ_EVENTS has been
+ * read, so every operation first tries a non-blocking send/recv and only
+ * parks the coroutine when that fails with EAGAIN; the reactor re-reads
+ * ZMQ_EVENTS for parked sockets before each epoll_wait. Same structure as the
+ * event loops behind the .NET and Node.js bindings. Linux only (epoll).
+ */
+
+#ifndef ZMQ_BENCHMARK_ZMQ_ASYNC_HPP
+#define ZMQ_BENCHMARK_ZMQ_ASYNC_HPP
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <zmq.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <coroutine>
+#include <exception>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace async_bench {
+
+class task {
+public:
+    struct promise_type {
+        std::exception_ptr error;
+
+        task get_return_object() {
+            return task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { error = std::current_exception(); }
+    };
+
+    explicit task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+    task(task &&other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    ~task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+    task(const task &) = delete;
+    task &operator=(const task &) = delete;
+    task &operator=(task &&) = delete;
+
+    bool done() const { return handle_.done(); }
+    void resume() { handle_.resume(); }
+
+    // Rethrows what escaped the coroutine body, if anything
+    void rethrow() const {
+        if (handle_.promise().error) {
+            std::rethrow_exception(handle_.promise().error);
+        }
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+class async_socket;
+
+class reactor {
+public:
+    reactor() : epoll_(epoll_create1(EPOLL_CLOEXEC)) {
+        if (epoll_ < 0) {
+            throw std::system_error(errno, std::generic_category(), "epoll_create1");
+        }
+    }
+    ~reactor() { close(epoll_); }
+    reactor(const reactor &) = delete;
+    reactor &operator=(const reactor &) = delete;
+
+    // Resumes work until it finishes; rethrows its exception
+    void run(task &work);
+
+    // epoll_wait calls that returned events; waits per message is the
+    // share of operations the non-blocking fast path could not complete
+    unsigned long long wakeups() const { return wakeups_; }
+
+private:
+    friend class async_socket;
+
+    void add(async_socket *socket, int fd) {
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLET;
+        event.data.ptr = socket;
+        if (epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &event) != 0) {
+            throw std::system_error(errno, std::generic_category(), "epoll_ctl");
+        }
+        sockets_.push_back(socket);
+    }
+
+    void remove(async_socket *socket, int fd) {
+        epoll_ctl(epoll_, EPOLL_CTL_DEL, fd, nullptr);
+        sockets_.erase(std::remove(sockets_.begin(), sockets_.end(), socket), sockets_.end());
+    }
+
+    bool dispatch_ready();
+
+    int epoll_;
+    std::vector<async_socket *> sockets_;
+    unsigned long long wakeups_ = 0;
+};
+
+// A ZeroMQ socket driven by a reactor; one coroutine per direction may wait
+class async_socket {
+public:
+    async_socket(reactor &loop, zmq::socket_t &socket)
+        : loop_(loop), socket_(socket), fd_(static_cast<int>(socket.get(zmq::sockopt::fd))) {
+        loop_.add(this, fd_);
+    }
+    ~async_socket() { loop_.remove(this, fd_); }
+    async_socket(const async_socket &) = delete;
+    async_socket &operator=(const async_socket &) = delete;
+
+    struct recv_awaitable {
+        async_socket &socket;
+        zmq::message_t &msg;
+        zmq::recv_result_t result;
+
+        bool await_ready() {
+            result = socket.socket_.recv(msg, zmq::recv_flags::dontwait);
+            return result.has_value();
+        }
+        bool await_suspend(std::coroutine_handle<> waiter) {
+            if (socket.pending(ZMQ_POLLIN)) {
+                return false;
+            }
+            socket.reader_ = waiter;
+            return true;
+        }
+        size_t await_resume() {
+            if (!result) {
+                result = socket.socket_.recv(msg, zmq::recv_flags::dontwait);
+                if (!result) {
+                    throw std::runtime_error("recv would block after ZMQ_POLLIN");
+                }
+            }
+            return *result;
+        }
+    };
+
+    struct send_awaitable {
+        async_socket &socket;
+        zmq::message_t &msg;
+        zmq::send_flags flags;
+        zmq::send_result_t result;
+
+        bool await_ready() {
+            result = socket.socket_.send(msg, flags | zmq::send_flags::dontwait);
+            return result.has_value();
+        }
+        bool await_suspend(std::coroutine_handle<> waiter) {
+            if (socket.pending(ZMQ_POLLOUT)) {
+                return false;
+            }
+            socket.writer_ = waiter;
+            return true;
+        }
+        size_t await_resume() {
+            if (!result) {
+                result = socket.socket_.send(msg, flags | zmq::send_flags::dontwait);
+                if (!result) {
+                    throw std::runtime_error("send would block after ZMQ_POLLOUT");
+                }
+            }
+            return *result;
+        }
+    };
+
+    // co_await: received size; the coroutine only suspends when nothing is queued
+    recv_awaitable recv(zmq::message_t &msg) { return {*this, msg, {}}; }
+
+    // co_await: sent size; the coroutine only suspends at the high-water mark
+    send_awaitable send(zmq::message_t &msg, zmq::send_flags flags = zmq::send_flags::none) {
+        return {*this, msg, flags, {}};
+    }
+
+private:
+    friend class reactor;
+
+    bool pending(int event) const { return (socket_.get(zmq::sockopt::events) & event) != 0; }
+
+    reactor &loop_;
+    zmq::socket_t &socket_;
+    int fd_;
+    std::coroutine_handle<> reader_;
+    std::coroutine_handle<> writer_;
+};
+
+// Resumes parked coroutines whose event is now pending. Reading ZMQ_EVENTS
+// re-arms the ZMQ_FD edge, so this must run before every epoll_wait.
+inline bool reactor::dispatch_ready() {
+    bool resumed = false;
+    for (size_t i = 0; i < sockets_.size(); i++) {
+        async_socket *socket = sockets_[i];
+        if (socket->reader_ && socket->pending(ZMQ_POLLIN)) {
+            std::exchange(socket->reader_, {}).resume();
+            resumed = true;
+        }
+        if (socket->writer_ && socket->pending(ZMQ_POLLOUT)) {
+            std::exchange(socket->writer_, {}).resume();
+            resumed = true;
+        }
+    }
+    return resumed;
+}
+
+inline void reactor::run(task &work) {
+    epoll_event events[16];
+    work.resume();
+    while (!work.done()) {
+        if (dispatch_ready()) {
+            continue;
+        }
+        int ready = epoll_wait(epoll_, events, 16, -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "epoll_wait");
+        }
+        wakeups_++;
+    }
+    work.rethrow();
+}
+
+}  // namespace async_bench
+
+#endif  // ZMQ_BENCHMARK_ZMQ_ASYNC_HPP
@@ -0,0 +1,167 @@
+/*
+ * zmqbench ab - interleaved A/B comparison of two configurations.
+ *
+ * Runs short trials of the lat or thr kernel with option sets A and B in
+ * ABBA order (AB, BA, AB, ...), so thermal and frequency drift hit both
+ * configurations alike instead of whichever ran second. Each pair gives one
+ * paired difference B - A; the median difference is reported with a 95%
+ * bootstrap CI, absolute and relative to A. A CI that excludes zero is a
+ * real difference.
+ *
+ * Trials run both roles in this process, or against a persistent server
+ * with --role client --control. Default counts are a tenth of the kernel's.
+ */
+
+#include "zmqbench/commands.hpp"
+#include "zmqbench/data_path.hpp"
+#include "zmqbench/report.hpp"
+#include "zmqbench/stats.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace zmqbench {
+
+namespace {
+
+std::vector<std::string> split_arguments(const std::string &text) {
+    std::vector<std::string> args;
+    std::istringstream in(text);
+    std::string arg;
+    while (in >> arg) {
+        args.push_back(arg);
+    }
+    return args;
+}
+
+options variant(const options &base, const std::string &args) {
+    options opt = base;
+    opt.command = base.ab_test;
+    parse_arguments(opt, split_arguments(args));
+    // One short trial per run; only ab itself reports
+    opt.trials = 1;
+    opt.target_ci = 0.0;
+    opt.output.clear();
+    opt.quiet = true;
+    return opt;
+}
+
+double run_trial(const command &cmd, options opt, size_t size) {
+    opt.sizes = {size};
+    result_capture capture;
+    cmd.run(opt);
+    if (capture.results().size() != 1) {
+        throw std::runtime_error("ab: expected one result per trial, got " +
+                                 std::to_string(capture.results().size()));
+    }
+    return headline(capture.results().front());
+}
+
+}  // namespace
+
+void run_ab(const options &opt) {
+    if (opt.role == role::server || (opt.role == role::client && opt.control.empty())) {
+        throw usage_error("ab runs both roles, or a client against `zmqbench serve` (--control)");
+    }
+    if (opt.variant_a == opt.variant_b) {
+        throw usage_error("ab needs two different configurations (--a and --b)");
+    }
+
+    const command *cmd = find_command(opt.ab_test);
+    options base = opt;
+    if (base.count == 0) {
+        base.count = cmd->default_count / 10;
+    }
+    options a = variant(base, opt.variant_a);
+    options b = variant(base, opt.variant_b);
+
+    bool latency = opt.ab_test == "lat";
+    const char *unit = latency ? "us" : "msg/s";
+
+    for (size_t size : opt.sizes) {
+        std::vector<double> a_values;
+        std::vector<double> b_values;
+        std::vector<double> diffs;
+        std::vector<double> relative;
+
+        for (int pair = 0; pair < opt.pairs; pair++) {
+            double va, vb;
+            if (pair % 2 == 0) {
+                va = run_trial(*cmd, a, size);
+                vb = run_trial(*cmd, b, size);
+            } else {
+                vb = run_trial(*cmd, b, size);
+                va = run_trial(*cmd, a, size);
+            }
+            a_values.push_back(va);
+            b_values.push_back(vb);
+            diffs.push_back(vb - va);
+            relative.push_back((vb - va) / va * 100.0);
+
+            if (chatty(opt)) {
+                std::cout << "Pair " << (pair + 1) << (pair % 2 == 0 ? " (AB)" : " (BA)") << ": A "
+                          << va << " " << unit << ", B " << vb << " " << unit << "\n";
+            }
+        }
+
+        trial_summary a_summary = summarize_trials(a_values);
+        trial_summary b_summary = summarize_trials(b_values);
+        trial_summary diff = summarize_trials(diffs);
+        trial_summary rel = summarize_trials(relative);
+
+        // Lower latency / higher throughput wins
+        bool significant = rel.ci_low > 0.0 || rel.ci_high < 0.0;
+        bool b_better = latency ? rel.median < 0.0 : rel.median > 0.0;
+
+        if (opt.format == "text") {
+            std::cout << "\n=== A/B Comparison (" << opt.ab_test << ") ===\n";
+            std::cout << "A: " << (opt.variant_a.empty() ? "(defaults)" : opt.variant_a) << "\n";
+            std::cout << "B: " << (opt.variant_b.empty() ? "(defaults)" : opt.variant_b) << "\n";
+            std::cout << "Message size: " << size << " bytes\n";
+            std::cout << "Pairs: " << opt.pairs << " (ABBA order, " << base.count
+                      << (latency ? " roundtrips" : " messages") << " per trial)\n";
+            std::cout << "A median: " << a_summary.median << " " << unit << "\n";
+            std::cout << "B median: " << b_summary.median << " " << unit << "\n";
+            std::cout << "Paired difference (B - A): " << diff.median << " " << unit << ", 95% CI ["
+                      << diff.ci_low << ", " << diff.ci_high << "]\n";
+            std::cout << "Relative difference: " << rel.median << "%, 95% CI [" << rel.ci_low
+                      << ", " << rel.ci_high << "]\n";
+            std::cout << "Verdict: "
+                      << (!significant ? "no significant difference (CI includes 0)"
+                                       : (b_better ? "B is better" : "A is better"))
+                      << "\n";
+        }
+
+        bench_output::record rec;
+        rec.benchmark = "ab_" + opt.ab_test;
+        rec.role = role_name(opt.role);
+        rec.transport = transport_of(opt.endpoint);
+        rec.endpoint = opt.endpoint;
+        rec.size = size;
+        rec.count = base.count;
+        rec.binding = data_path::binding;
+        rec.zmq_version = zmq_version_string();
+        // Trials block: relative difference (B - A) / A in percent, per pair
+        rec.trials = opt.pairs;
+        rec.rejected_trials = static_cast<long long>(rel.rejected);
+        rec.ci_low = rel.ci_low;
+        rec.ci_high = rel.ci_high;
+        rec.confidence = rel.confidence;
+        rec.trial_values = relative;
+        rec.set("variant_a", opt.variant_a);
+        rec.set("variant_b", opt.variant_b);
+        rec.set("metric", latency ? "latency_us" : "msg_per_sec");
+        rec.config.emplace_back("a_median", bench_output::json_number(a_summary.median));
+        rec.config.emplace_back("b_median", bench_output::json_number(b_summary.median));
+        rec.config.emplace_back("diff_median", bench_output::json_number(diff.median));
+        rec.config.emplace_back("diff_ci_low", bench_output::json_number(diff.ci_low));
+        rec.config.emplace_back("diff_ci_high", bench_output::json_number(diff.ci_high));
+        rec.config.emplace_back("relative_pct", bench_output::json_number(rel.median));
+        write_record(opt, rec);
+    }
+}
+
+}  // namespace zmqbench
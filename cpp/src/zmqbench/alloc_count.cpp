@@ -0,0 +1,41 @@
+#include "zmqbench/alloc_count.hpp"
+
+#include <atomic>
+
+namespace zmqbench {
+namespace alloc_count {
+
+namespace {
+
+// Set during static initialization, before main()
+bool installed = false;
+
+std::atomic<bool> counting{false};
+std::atomic<unsigned long long> allocations{0};
+
+}  // namespace
+
+bool available() {
+    return installed;
+}
+
+void enable() {
+    counting.store(true, std::memory_order_relaxed);
+}
+
+unsigned long long total() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+void install() {
+    installed = true;
+}
+
+void count() {
+    if (counting.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+}  // namespace alloc_count
+}  // namespace zmqbench
@@ -0,0 +1,37 @@
+/*
+ * zmqbench - process-wide heap allocation counter.
+ *
+ * The counting itself lives in alloc_hooks.cpp, which only the executables
+ * that count link (zmqbench and local_thr; see CMakeLists.txt). On glibc it
+ * defines malloc, calloc and realloc and forwards them to glibc's __libc_*
+ * entry points, so allocations made inside libzmq and libstdc++ (operator
+ * new) are counted too, on every thread. posix_memalign, aligned_alloc and
+ * memalign are not replaced, so aligned allocations are not counted.
+ * Counting is off until enable() is called; while off, each allocation
+ * costs one relaxed atomic load. Without the hooks available() is false and
+ * the count stays 0.
+ */
+
+#ifndef ZMQBENCH_ALLOC_COUNT_HPP
+#define ZMQBENCH_ALLOC_COUNT_HPP
+
+namespace zmqbench {
+namespace alloc_count {
+
+bool available();
+
+// Starts counting; there is no way back, the counter only grows
+void enable();
+
+// Allocations since enable(), all threads
+unsigned long long total();
+
+// For alloc_hooks.cpp: marks the hooks as linked in, and counts one
+// allocation while counting is on
+void install();
+void count();
+
+}  // namespace alloc_count
+}  // namespace zmqbench
+
+#endif  // ZMQBENCH_ALLOC_COUNT_HPP
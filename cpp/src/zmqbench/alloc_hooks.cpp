@@ -0,0 +1,38 @@
+#include "zmqbench/alloc_count.hpp"
+
+#include <cstddef>
+
+// Sanitizers bring their own allocator; leave it alone
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+
+extern "C" {
+
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size) noexcept {
+    zmqbench::alloc_count::count();
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) noexcept {
+    zmqbench::alloc_count::count();
+    return __libc_calloc(count, size);
+}
+
+// Growing or shrinking in place still goes through the allocator
+void *realloc(void *ptr, size_t size) noexcept {
+    zmqbench::alloc_count::count();
+    return __libc_realloc(ptr, size);
+}
+
+}  // extern "C"
+
+namespace {
+
+const bool hooks_installed = (zmqbench::alloc_count::install(), true);
+
+}  // namespace
+
+#endif
@@ -0,0 +1,519 @@
+/*
+ * zmqbench chain - a pipeline of N forwarding stages.
+ *
+ *   source (PUSH) -> stage 1 (PULL, work, PUSH) -> ... -> stage N -> sink (PULL)
+ *
+ * The source sends like remote_thr and the sink receives and times like
+ * local_thr (first message is the warm-up). Each downstream element binds its
+ * PULL and its upstream neighbour connects to it: hop k (into stage k, or
+ * into the sink for k = N + 1) is sibling_endpoint(endpoint, k - 1).
+ *
+ * With --role both everything runs as threads of one process sharing one
+ * context, over inproc, ipc or tcp. Over tcp the elements can be separate
+ * processes instead: --role server is the sink, --role client the source and
+ * --stage K runs stage K alone; start them with the same --stages, --size
+ * and --count.
+ *
+ * Every message carries two steady_clock timestamps in its first 16 bytes:
+ * when the source sent it and when the previous element forwarded it. Each
+ * receiver turns them into that message's hop latency and, at the sink, its
+ * end-to-end latency. Across processes that relies on steady_clock being the
+ * host-wide monotonic clock (Linux), so run them on one host.
+ *
+ * An element is busy when it is neither waiting in recv (starved by its
+ * upstream) nor in send (held back by its downstream at the high-water
+ * mark). The element that is busy for the largest share of its window is the
+ * bottleneck; the queue in front of it also shows as the largest hop latency.
+ * --stage-work gives stages a fixed spin per message to model real work.
+ *
+ * After the data messages the source sends one control_message frame; each
+ * stage adds its own figures and forwards it, so the sink reports for the
+ * whole chain whether the stages are threads or processes.
+ */
+
+#include "zmqbench/commands.hpp"
+#include "zmqbench/control.hpp"
+#include "zmqbench/report.hpp"
+#include "zmqbench/stats.hpp"
+
+#include <zmq.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace zmqbench {
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// The two timestamps at the front of every message
+const size_t stamp_bytes = 2 * sizeof(int64_t);
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now().time_since_epoch())
+        .count();
+}
+
+int64_t read_stamp(const zmq::message_t &message, int slot) {
+    int64_t stamp;
+    std::memcpy(&stamp, static_cast<const char *>(message.data()) + slot * sizeof(int64_t),
+                sizeof(stamp));
+    return stamp;
+}
+
+void write_stamp(zmq::message_t &message, int slot, int64_t stamp) {
+    std::memcpy(static_cast<char *>(message.data()) + slot * sizeof(int64_t), &stamp, sizeof(stamp));
+}
+
+std::string element_name(int index, int stages) {
+    if (index == 0) {
+        return "source";
+    }
+    if (index > stages) {
+        return "sink";
+    }
+    return "stage" + std::to_string(index);
+}
+
+double stage_work_us(const options &opt, int stage) {
+    if (opt.stage_work.size() == 1) {
+        return opt.stage_work.front();
+    }
+    return static_cast<size_t>(stage) <= opt.stage_work.size() ? opt.stage_work[stage - 1] : 0.0;
+}
+
+void spin_for(double us) {
+    if (us <= 0.0) {
+        return;
+    }
+    auto until = clock_type::now() + std::chrono::duration<double, std::micro>(us);
+    while (clock_type::now() < until) {
+    }
+}
+
+// One element's side of one size: how long it waited on either neighbour
+// and what the hop into it cost
+class element_stats {
+public:
+    void recv(zmq::socket_t &socket, zmq::message_t &message) {
+        if (socket.recv(message, zmq::recv_flags::dontwait)) {
+            return;
+        }
+        int64_t start = now_ns();
+        if (!socket.recv(message, zmq::recv_flags::none)) {
+            throw std::runtime_error("Failed to receive");
+        }
+        starved_ns_ += now_ns() - start;
+    }
+
+    void send(zmq::socket_t &socket, zmq::message_t &message) {
+        if (socket.send(message, zmq::send_flags::dontwait)) {
+            return;
+        }
+        int64_t start = now_ns();
+        if (!socket.send(message, zmq::send_flags::none)) {
+            throw std::runtime_error("Failed to send");
+        }
+        blocked_ns_ += now_ns() - start;
+    }
+
+    // Marks the start of the measured window (after the warm-up message)
+    void start() {
+        start_ns_ = now_ns();
+        starved_ns_ = 0;
+        blocked_ns_ = 0;
+    }
+
+    void finish(long long messages) {
+        window_ns_ = now_ns() - start_ns_;
+        messages_ = messages;
+    }
+
+    void hop(int64_t sent_ns, int64_t received_ns) { hops_.push_back((received_ns - sent_ns) / 1000.0); }
+
+    void reserve(int count) { hops_.reserve(static_cast<size_t>(count)); }
+
+    // Adds this element's fields to the chain's control frame
+    void add_to(control_message &msg, const std::string &name, double work_us) const {
+        double window = static_cast<double>(window_ns_);
+        double busy = window > 0 ? 100.0 * (window - starved_ns_ - blocked_ns_) / window : 0.0;
+        msg.fields[name + ".busy_pct"] = std::to_string(std::max(busy, 0.0));
+        msg.fields[name + ".starved_pct"] = std::to_string(window > 0 ? 100.0 * starved_ns_ / window : 0.0);
+        msg.fields[name + ".blocked_pct"] = std::to_string(window > 0 ? 100.0 * blocked_ns_ / window : 0.0);
+        msg.fields[name + ".msg_per_sec"] =
+            std::to_string(window > 0 ? messages_ / (window / 1000000000.0) : 0.0);
+        msg.fields[name + ".work_us"] = std::to_string(work_us);
+        if (!hops_.empty()) {
+            latency_summary hop = summarize(hops_);
+            msg.fields[name + ".hop_p50_us"] = std::to_string(hop.p50);
+            msg.fields[name + ".hop_p99_us"] = std::to_string(hop.p99);
+        }
+    }
+
+private:
+    int64_t start_ns_ = 0;
+    int64_t window_ns_ = 0;
+    int64_t starved_ns_ = 0;
+    int64_t blocked_ns_ = 0;
+    long long messages_ = 0;
+    std::vector<double> hops_;
+};
+
+void check_size(const zmq::message_t &message, size_t size) {
+    if (message.size() != size) {
+        throw std::runtime_error("Message size mismatch. Expected " + std::to_string(size) + ", got " +
+                                 std::to_string(message.size()));
+    }
+}
+
+void run_source(zmq::context_t &context, const options &opt, int stages) {
+    zmq::socket_t socket(context, zmq::socket_type::push);
+    configure(socket, opt.sockopts);
+    socket.connect(sibling_endpoint(opt.endpoint, 0));
+
+    for (size_t size : opt.sizes) {
+        element_stats stats;
+        std::vector<char> payload(size, 'X');
+        for (int i = 0; i < opt.count; i++) {
+            if (i == 1) {
+                stats.start();
+            }
+            zmq::message_t message(payload.data(), size);
+            int64_t stamp = now_ns();
+            write_stamp(message, 0, stamp);
+            write_stamp(message, 1, stamp);
+            stats.send(socket, message);
+        }
+        stats.finish(opt.count - 1);
+
+        control_message figures("chain");
+        figures.fields["stages"] = std::to_string(stages);
+        stats.add_to(figures, element_name(0, stages), 0.0);
+        zmq::message_t frame(encode(figures));
+        stats.send(socket, frame);
+    }
+}
+
+void run_stage(zmq::context_t &context, const options &opt, int stage, int stages) {
+    zmq::socket_t input(context, zmq::socket_type::pull);
+    configure(input, opt.sockopts);
+    bind_with_retry(input, sibling_endpoint(opt.endpoint, stage - 1));
+    zmq::socket_t output(context, zmq::socket_type::push);
+    configure(output, opt.sockopts);
+    output.connect(sibling_endpoint(opt.endpoint, stage));
+    double work_us = stage_work_us(opt, stage);
+
+    for (size_t size : opt.sizes) {
+        element_stats stats;
+        stats.reserve(opt.count);
+        zmq::message_t message;
+        for (int i = 0; i < opt.count; i++) {
+            stats.recv(input, message);
+            int64_t received = now_ns();
+            check_size(message, size);
+            if (i == 0) {
+                stats.start();
+            } else {
+                stats.hop(read_stamp(message, 1), received);
+            }
+            spin_for(work_us);
+            write_stamp(message, 1, now_ns());
+            stats.send(output, message);
+        }
+        stats.finish(opt.count - 1);
+
+        stats.recv(input, message);
+        control_message figures = decode(message.to_string());
+        stats.add_to(figures, element_name(stage, stages), work_us);
+        zmq::message_t frame(encode(figures));
+        stats.send(output, frame);
+    }
+}
+
+struct element_row {
+    std::string name;
+    double work_us = 0.0;
+    double busy_pct = 0.0;
+    double starved_pct = 0.0;
+    double blocked_pct = 0.0;
+    double msg_per_sec = 0.0;
+    bool has_hop = false;
+    double hop_p50_us = 0.0;
+    double hop_p99_us = 0.0;
+};
+
+struct chain_result {
+    int stages = 0;
+    result end_to_end;  // sink throughput and end-to-end latency
+    std::vector<element_row> elements;
+    size_t bottleneck = 0;
+};
+
+chain_result collect(const control_message &figures, int stages, const result &end_to_end) {
+    if (figures.verb != "chain" || static_cast<int>(figures.number("stages")) != stages) {
+        throw std::runtime_error("The chain's figures do not match " + std::to_string(stages) +
+                                 " stages (started with different --stages?)");
+    }
+    chain_result r;
+    r.stages = stages;
+    r.end_to_end = end_to_end;
+    for (int index = 0; index <= stages + 1; index++) {
+        std::string name = element_name(index, stages);
+        element_row row;
+        row.name = name;
+        row.work_us = figures.number(name + ".work_us");
+        row.busy_pct = figures.number(name + ".busy_pct");
+        row.starved_pct = figures.number(name + ".starved_pct");
+        row.blocked_pct = figures.number(name + ".blocked_pct");
+        row.msg_per_sec = figures.number(name + ".msg_per_sec");
+        if (index > 0) {
+            row.has_hop = true;
+            row.hop_p50_us = figures.number(name + ".hop_p50_us");
+            row.hop_p99_us = figures.number(name + ".hop_p99_us");
+        }
+        if (row.busy_pct > (r.elements.empty() ? -1.0 : r.elements[r.bottleneck].busy_pct)) {
+            r.bottleneck = r.elements.size();
+        }
+        r.elements.push_back(row);
+    }
+    return r;
+}
+
+chain_result run_sink(zmq::socket_t &socket, const options &opt, size_t size, int stages) {
+    element_stats stats;
+    stats.reserve(opt.count);
+    std::vector<double> end_to_end;
+    end_to_end.reserve(static_cast<size_t>(opt.count));
+    zmq::message_t message;
+
+    for (int i = 0; i < opt.count; i++) {
+        stats.recv(socket, message);
+        int64_t received = now_ns();
+        check_size(message, size);
+        if (i == 0) {
+            stats.start();
+            continue;
+        }
+        stats.hop(read_stamp(message, 1), received);
+        end_to_end.push_back((received - read_stamp(message, 0)) / 1000.0);
+    }
+    stats.finish(opt.count - 1);
+
+    result e2e;
+    e2e.command = "chain";
+    e2e.transport = transport_of(opt.endpoint);
+    e2e.message_size = size;
+    e2e.message_count = opt.count;
+    e2e.latency = summarize(end_to_end);
+
+    stats.recv(socket, message);
+    control_message figures = decode(message.to_string());
+    stats.add_to(figures, element_name(stages + 1, stages), 0.0);
+    chain_result r = collect(figures, stages, e2e);
+    r.end_to_end.msg_per_sec = r.elements.back().msg_per_sec;
+    r.end_to_end.elapsed_us = (opt.count - 1) / r.end_to_end.msg_per_sec * 1000000.0;
+    r.end_to_end.megabits = r.end_to_end.msg_per_sec * size * 8 / 1000000.0;
+    return r;
+}
+
+void print(std::ostream &out, const options &opt, const chain_result &r) {
+    const result &e2e = r.end_to_end;
+    out << "\n=== Pipeline Chain Results ===\n";
+    out << "Stages: " << r.stages << " ("
+        << (opt.role == role::both ? "threads" : "processes") << ", " << e2e.transport << ")\n";
+    out << "Message size: " << e2e.message_size << " bytes\n";
+    out << "Messages: " << e2e.message_count << "\n";
+    out << "End-to-end throughput: " << e2e.msg_per_sec << " msg/s\n";
+    out << "End-to-end latency: p50 " << e2e.latency.p50 << " us, p99 " << e2e.latency.p99 << " us\n";
+
+    out << std::left << std::setw(10) << "Element" << std::right << std::setw(11) << "Work (us)"
+        << std::setw(14) << "Hop p50 (us)" << std::setw(14) << "Hop p99 (us)" << std::setw(9)
+        << "Busy %" << std::setw(11) << "Starved %" << std::setw(11) << "Blocked %" << std::setw(14)
+        << "msg/s" << "\n";
+    out << std::fixed << std::setprecision(2);
+    for (const element_row &row : r.elements) {
+        bool stage = row.name.rfind("stage", 0) == 0;
+        std::ostringstream work;
+        std::ostringstream p50;
+        std::ostringstream p99;
+        work << std::fixed << std::setprecision(2);
+        p50 << std::fixed << std::setprecision(2);
+        p99 << std::fixed << std::setprecision(2);
+        if (stage) {
+            work << row.work_us;
+        } else {
+            work << "-";
+        }
+        if (row.has_hop) {
+            p50 << row.hop_p50_us;
+            p99 << row.hop_p99_us;
+        } else {
+            p50 << "-";
+            p99 << "-";
+        }
+        out << std::left << std::setw(10) << row.name << std::right << std::setw(11) << work.str()
+            << std::setw(14) << p50.str() << std::setw(14) << p99.str() << std::setw(9)
+            << std::setprecision(1) << row.busy_pct << std::setw(11) << row.starved_pct << std::setw(11)
+            << row.blocked_pct << std::setw(14) << std::setprecision(0) << row.msg_per_sec
+            << std::setprecision(2) << "\n";
+    }
+    const element_row &slowest = r.elements[r.bottleneck];
+    out << std::setprecision(1) << "Bottleneck: " << slowest.name << " (busy " << slowest.busy_pct
+        << "% of its window)\n";
+    out << std::defaultfloat << std::setprecision(6);
+}
+
+bench_output::record chain_record(const options &opt, const chain_result &r) {
+    const result &e2e = r.end_to_end;
+    bench_output::record rec;
+    rec.benchmark = "chain";
+    rec.role = role_name(opt.role);
+    rec.transport = e2e.transport;
+    rec.endpoint = opt.endpoint;
+    rec.size = e2e.message_size;
+    rec.count = opt.count;
+    rec.messages = opt.count - 1;
+    rec.elapsed_us = e2e.elapsed_us;
+    rec.msg_per_sec = e2e.msg_per_sec;
+    rec.mbps = e2e.megabits;
+    rec.min_us = e2e.latency.min;
+    rec.p50_us = e2e.latency.p50;
+    rec.p90_us = e2e.latency.p90;
+    rec.p99_us = e2e.latency.p99;
+    rec.p999_us = e2e.latency.p999;
+    rec.max_us = e2e.latency.max;
+    rec.samples = static_cast<long long>(e2e.latency.samples);
+    rec.zmq_version = zmq_version_string();
+    rec.set("stages", r.stages);
+    rec.set("io_threads", opt.io_threads);
+    rec.set("bottleneck", r.elements[r.bottleneck].name);
+    for (const element_row &row : r.elements) {
+        rec.config.emplace_back(row.name + "_busy_pct", bench_output::json_number(row.busy_pct));
+        if (row.has_hop) {
+            rec.config.emplace_back(row.name + "_hop_p50_us", bench_output::json_number(row.hop_p50_us));
+        }
+        if (row.work_us > 0.0) {
+            rec.config.emplace_back(row.name + "_work_us", bench_output::json_number(row.work_us));
+        }
+    }
+    return rec;
+}
+
+void report_chain(const options &opt, const chain_result &r) {
+    if (opt.format == "text") {
+        print(std::cout, opt, r);
+    }
+    write_record(opt, chain_record(opt, r));
+}
+
+// Binds the sink, then runs the source and stages 1..stages on threads of
+// one context; any failure shuts the context down so the others return
+void run_threads(const options &opt, int stages) {
+    zmq::context_t context(opt.io_threads);
+    zmq::socket_t sink(context, zmq::socket_type::pull);
+    configure(sink, opt.sockopts);
+    bind_with_retry(sink, sibling_endpoint(opt.endpoint, stages));
+
+    first_error errors(context);
+
+    std::vector<std::thread> threads;
+    for (int stage = stages; stage >= 1; stage--) {
+        threads.emplace_back(errors.guarded([&, stage]() { run_stage(context, opt, stage, stages); }));
+    }
+    threads.emplace_back(errors.guarded([&]() { run_source(context, opt, stages); }));
+
+    std::vector<chain_result> results;
+    errors.guarded([&]() {
+        for (size_t size : opt.sizes) {
+            results.push_back(run_sink(sink, opt, size, stages));
+        }
+    })();
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    errors.rethrow();
+    for (const chain_result &r : results) {
+        report_chain(opt, r);
+    }
+}
+
+}  // namespace
+
+void run_chain(const options &opt) {
+    if (!opt.control.empty()) {
+        throw usage_error("chain has no persistent server: run its elements with --role and --stage");
+    }
+    if (*std::min_element(opt.sizes.begin(), opt.sizes.end()) < stamp_bytes) {
+        throw usage_error("chain embeds two timestamps per message: --size must be at least " +
+                          std::to_string(stamp_bytes));
+    }
+    if (opt.count < 2) {
+        throw usage_error("chain needs --count of at least 2 (the first message is the warm-up)");
+    }
+    bool own_process = opt.role != role::both || opt.chain_stage > 0;
+    if (own_process && opt.chain_stages.size() != 1) {
+        throw usage_error("an element in its own process needs a single --stages value");
+    }
+    if (own_process && transport_of(opt.endpoint) != "tcp") {
+        throw usage_error("chain elements in separate processes run over tcp");
+    }
+
+    if (opt.chain_stage > 0) {
+        int stages = static_cast<int>(opt.chain_stages.front());
+        if (opt.role != role::both || opt.chain_stage > stages) {
+            throw usage_error("--stage K runs stage K of --stages alone (1 <= K <= stages, no --role)");
+        }
+        if (chatty(opt)) {
+            std::cout << "Stage " << opt.chain_stage << " of " << stages << ": "
+                      << sibling_endpoint(opt.endpoint, opt.chain_stage - 1) << " -> "
+                      << sibling_endpoint(opt.endpoint, opt.chain_stage) << "\n";
+        }
+        zmq::context_t context(opt.io_threads);
+        run_stage(context, opt, opt.chain_stage, stages);
+        return;
+    }
+
+    if (opt.role == role::both) {
+        for (size_t stages : opt.chain_stages) {
+            if (chatty(opt)) {
+                std::cout << "Running a chain of " << stages << " stages...\n";
+            }
+            run_threads(opt, static_cast<int>(stages));
+        }
+        return;
+    }
+
+    int stages = static_cast<int>(opt.chain_stages.front());
+    zmq::context_t context(opt.io_threads);
+    if (opt.role == role::client) {
+        if (chatty(opt)) {
+            std::cout << "Source: sending to " << sibling_endpoint(opt.endpoint, 0) << "\n";
+        }
+        run_source(context, opt, stages);
+        return;
+    }
+
+    zmq::socket_t sink(context, zmq::socket_type::pull);
+    configure(sink, opt.sockopts);
+    std::string endpoint = sibling_endpoint(opt.endpoint, stages);
+    bind_with_retry(sink, endpoint);
+    if (chatty(opt)) {
+        std::cout << "Sink: listening on " << endpoint << "\n";
+        std::cout << "Message count: " << opt.count << "\n";
+    }
+    for (size_t size : opt.sizes) {
+        report_chain(opt, run_sink(sink, opt, size, stages));
+    }
+}
+
+}  // namespace zmqbench
@@ -0,0 +1,243 @@
+#include "zmqbench/commands.hpp"
+
+#include <zmq_addon.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+namespace zmqbench {
+
+const std::vector<command> &commands() {
+    static const std::vector<command> table = {
+        {"lat", "REQ/REP roundtrip latency", 10000, run_lat, &lat_session},
+        {"thr", "PUSH/PULL one-way throughput", 1000000, run_thr, &thr_session},
+        {"ab", "interleaved A/B comparison of two configurations", 0, run_ab, nullptr},
+        {"poll", "one thread polling N sockets (zmq_poll, poller_t)", 20000, run_poll, nullptr},
+        {"conns", "N DEALER/REQ connections to one ROUTER echo", 100000, run_conns, nullptr},
+        {"connect", "connect rate and time to first roundtrip (NULL/PLAIN/CURVE, ZAP)", 1000, run_connect, nullptr},
+        {"patterns", "lat and thr over PAIR, DEALER, ROUTER and PUB/SUB patterns", 50000, run_patterns, nullptr},
+        {"duplex", "full-duplex DEALER/PAIR throughput over one connection", 1000000, run_duplex, nullptr},
+        {"proxy", "lat and thr through zmq::proxy / zmq_proxy_steerable vs direct", 100000, run_proxy, nullptr},
+        {"chain", "PULL -> work -> PUSH pipeline of N stages: throughput, hop latency, bottleneck", 200000, run_chain, nullptr},
+        {"mdp", "RPC through a Majordomo broker: workers x services x heartbeat interval", 20000, run_mdp, nullptr},
+        {"pirate", "Lazy / Paranoid Pirate RPC with dropped and delayed requests", 5000, run_pirate, nullptr},
+        {"scatter", "scatter-gather to K echo servers: end-to-end percentiles as K grows", 5000, run_scatter, nullptr},
+        {"serve", "persistent server driven over --control", 0, run_serve, nullptr},
+        {"stop", "ask a persistent server to exit", 0, run_stop, nullptr},
+    };
+    return table;
+}
+
+const command *find_command(const std::string &name) {
+    for (const command &cmd : commands()) {
+        if (name == cmd.name) {
+            return &cmd;
+        }
+    }
+    return nullptr;
+}
+
+test_spec spec_for(const options &opt, size_t message_size) {
+    test_spec spec;
+    spec.command = opt.command;
+    spec.message_size = message_size;
+    spec.message_count = opt.count;
+    spec.sockopts = opt.sockopts;
+    spec.recv = opt.recv;
+    spec.count_allocs = opt.count_allocs;
+    spec.mechanism = opt.mechanisms.empty() ? "null" : opt.mechanisms.front();
+    spec.zap = opt.zap == "on";
+    return spec;
+}
+
+void configure(zmq::socket_t &socket, const socket_options &sockopts) {
+    if (sockopts.sndhwm >= 0) {
+        socket.set(zmq::sockopt::sndhwm, sockopts.sndhwm);
+    }
+    if (sockopts.rcvhwm >= 0) {
+        socket.set(zmq::sockopt::rcvhwm, sockopts.rcvhwm);
+    }
+    if (sockopts.sndbuf > 0) {
+        socket.set(zmq::sockopt::sndbuf, sockopts.sndbuf);
+    }
+    if (sockopts.rcvbuf > 0) {
+        socket.set(zmq::sockopt::rcvbuf, sockopts.rcvbuf);
+    }
+}
+
+void bind_with_retry(zmq::socket_t &socket, const std::string &endpoint) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (true) {
+        try {
+            socket.bind(endpoint);
+            return;
+        } catch (const zmq::error_t &e) {
+            if (e.num() != EADDRINUSE || std::chrono::steady_clock::now() > deadline) {
+                throw;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+std::string sibling_endpoint(const std::string &endpoint, int offset) {
+    if (transport_of(endpoint) == "tcp") {
+        size_t colon = endpoint.rfind(':');
+        int port = std::atoi(endpoint.c_str() + colon + 1);
+        return endpoint.substr(0, colon + 1) + std::to_string(port + offset);
+    }
+    return endpoint + "-" + std::to_string(offset);
+}
+
+// Best effort: a hard limit of RLIM_INFINITY is refused on some systems, and
+// then the soft limit stays as it was
+void raise_fd_limit() {
+#ifndef _WIN32
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+#endif
+}
+
+frames recv_frames(zmq::socket_t &socket) {
+    frames msg;
+    if (!zmq::recv_multipart(socket, std::back_inserter(msg))) {
+        throw std::runtime_error("Failed to receive");
+    }
+    return msg;
+}
+
+void send_frames(zmq::socket_t &socket, frames &msg) {
+    if (!zmq::send_multipart(socket, msg)) {
+        throw std::runtime_error("Failed to send");
+    }
+}
+
+void check_control_role(const options &opt) {
+    if (!opt.control.empty() && opt.role != role::client) {
+        throw usage_error("--control needs --role client (the server side is `zmqbench serve`)");
+    }
+}
+
+namespace {
+
+thread_local zmq::context_t *active_context = nullptr;
+
+}  // namespace
+
+context_override::context_override(zmq::context_t &context) : previous_(active_context) {
+    active_context = &context;
+}
+
+context_override::~context_override() {
+    active_context = previous_;
+}
+
+zmq::context_t *context_override::current() {
+    return active_context;
+}
+
+void first_error::record() {
+    std::lock_guard<std::mutex> guard(lock_);
+    if (!error_) {
+        error_ = std::current_exception();
+    }
+    context_.shutdown();
+}
+
+void first_error::rethrow() const {
+    std::lock_guard<std::mutex> guard(lock_);
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+}
+
+result repeat_trials(const options &opt, const std::function<result()> &trial) {
+    bool adaptive = opt.target_ci > 0.0;
+    if (opt.trials == 1 && !adaptive) {
+        return trial();
+    }
+
+    // A CI from fewer than three trials says nothing about the noise
+    int min_trials = adaptive ? std::min(std::max(opt.trials, 3), opt.max_trials) : opt.trials;
+
+    std::vector<result> results;
+    std::vector<double> values;
+    trial_summary summary;
+    while (true) {
+        results.push_back(trial());
+        values.push_back(headline(results.back()));
+        if (chatty(opt)) {
+            std::cout << "Trial " << results.size() << ": " << values.back()
+                      << (results.back().has_latency ? " us" : " msg/s") << "\n";
+        }
+
+        int done = static_cast<int>(results.size());
+        if (done < min_trials) {
+            continue;
+        }
+        summary = summarize_trials(values);
+        if (!adaptive || summary.relative_width() <= opt.target_ci || done >= opt.max_trials) {
+            break;
+        }
+    }
+
+    if (adaptive && summary.relative_width() > opt.target_ci && chatty(opt)) {
+        std::cout << "CI target of " << opt.target_ci << "% not reached after " << opt.max_trials
+                  << " trials\n";
+    }
+
+    size_t nearest = 0;
+    for (size_t i = 1; i < values.size(); i++) {
+        if (std::fabs(values[i] - summary.median) < std::fabs(values[nearest] - summary.median)) {
+            nearest = i;
+        }
+    }
+
+    result r = results[nearest];
+    if (r.has_latency) {
+        r.latency_us = summary.median;
+    } else {
+        r.msg_per_sec = summary.median;
+        r.megabits = r.msg_per_sec * r.message_size * 8 / 1000000.0;
+    }
+    r.trials = summary;
+    return r;
+}
+
+int run(options opt) {
+    const command *cmd = find_command(opt.command);
+    if (cmd == nullptr) {
+        std::cerr << "Error: unknown command '" << opt.command << "'\n";
+        return 1;
+    }
+    if (opt.count == 0) {
+        opt.count = cmd->default_count;
+    }
+
+    try {
+        cmd->run(opt);
+    } catch (const zmq::error_t &e) {
+        std::cerr << "ZMQ Error: " << e.what() << "\n";
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
+
+}  // namespace zmqbench
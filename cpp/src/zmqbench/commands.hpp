@@ -0,0 +1,221 @@
+/*
+ * zmqbench - subcommand table and the shared runner.
+ *
+ * A subcommand is one function taking the parsed options. It handles every
+ * role; run_roles() below starts the server side, the client side, or both
+ * (server on a second thread, one shared context). Commands that can run
+ * inside a persistent server (`zmqbench serve`) also export a session.
+ */
+
+#ifndef ZMQBENCH_COMMANDS_HPP
+#define ZMQBENCH_COMMANDS_HPP
+
+#include "zmqbench/options.hpp"
+#include "zmqbench/report.hpp"
+
+#include <zmq.hpp>
+
+#include <cerrno>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace zmqbench {
+
+// One test as the server sees it: what the client sends in a "spec" request
+struct test_spec {
+    std::string command;
+    size_t message_size = 0;
+    int message_count = 0;
+    socket_options sockopts;
+    std::string recv = "message";
+    bool count_allocs = false;
+    std::string mechanism = "null";
+    bool zap = false;
+};
+
+// What the server side of one test did
+struct served {
+    int received = 0;                // messages handled, warm-up included
+    std::optional<result> measured;  // set when the server side is the one timing
+};
+
+// Server side of a command inside `zmqbench serve`. The data socket is
+// created and bound by the server loop; serve() must call primed() exactly
+// once, when the client may start its measured phase.
+struct session {
+    zmq::socket_type server_type;
+    served (*serve)(zmq::socket_t &socket, const test_spec &spec,
+                    const std::function<void()> &primed);
+};
+
+struct command {
+    const char *name;
+    const char *summary;
+    int default_count;
+    void (*run)(const options &opt);
+    const session *persistent;  // nullptr: not available through `serve`
+};
+
+const std::vector<command> &commands();
+const command *find_command(const std::string &name);
+
+// Fills in command defaults, runs the command and reports errors the way the
+// standalone executables always have; returns the process exit code
+int run(options opt);
+
+// Subcommands
+void run_lat(const options &opt);
+void run_thr(const options &opt);
+void run_ab(const options &opt);
+void run_poll(const options &opt);
+void run_conns(const options &opt);
+void run_connect(const options &opt);
+void run_patterns(const options &opt);
+void run_duplex(const options &opt);
+void run_proxy(const options &opt);
+void run_chain(const options &opt);
+void run_mdp(const options &opt);
+void run_pirate(const options &opt);
+void run_scatter(const options &opt);
+void run_serve(const options &opt);
+void run_stop(const options &opt);
+
+extern const session lat_session;
+extern const session thr_session;
+
+test_spec spec_for(const options &opt, size_t message_size);
+
+// Applies the non-default socket options; call before bind/connect
+void configure(zmq::socket_t &socket, const socket_options &sockopts);
+
+// Binds, retrying briefly while a just-closed socket still holds the address
+void bind_with_retry(zmq::socket_t &socket, const std::string &endpoint);
+
+// A second endpoint next to `endpoint` for commands that bind more than
+// one: the port `offset` above for tcp, "-<offset>" appended otherwise
+std::string sibling_endpoint(const std::string &endpoint, int offset);
+
+// Raises the soft open file limit to the hard limit. Every socket holds a
+// mailbox fd and every TCP connection one more; 10,000 of either need more
+// than the usual soft limit of 1024.
+void raise_fd_limit();
+
+// One multipart message, for the commands that route by envelope
+using frames = std::vector<zmq::message_t>;
+
+// Whole multipart messages; both throw when the socket returns nothing
+frames recv_frames(zmq::socket_t &socket);
+void send_frames(zmq::socket_t &socket, frames &msg);
+
+// --control only makes sense for a client talking to `zmqbench serve`
+void check_control_role(const options &opt);
+
+// Runs trial() opt.trials times, or with --target-ci until the median's CI
+// is narrow enough, and returns the trial closest to the median with its
+// headline value replaced by the median. One trial is returned unchanged.
+result repeat_trials(const options &opt, const std::function<result()> &trial);
+
+// While alive, run_roles on this thread uses `context` instead of creating
+// its own; lets a caller running a command on another thread shutdown() it
+class context_override {
+public:
+    explicit context_override(zmq::context_t &context);
+    ~context_override();
+    context_override(const context_override &) = delete;
+    context_override &operator=(const context_override &) = delete;
+
+    // nullptr when no override is active on this thread
+    static zmq::context_t *current();
+
+private:
+    zmq::context_t *previous_;
+};
+
+// Runs server(context, verbose) and/or client(context, verbose) per opt.role.
+// With role::both only the measuring side should print, so verbose is false.
+template <typename Server, typename Client>
+void run_roles(const options &opt, Server server, Client client) {
+    std::unique_ptr<zmq::context_t> own;
+    if (context_override::current() == nullptr) {
+        own = std::make_unique<zmq::context_t>(opt.io_threads);
+    }
+    zmq::context_t &context = own ? *own : *context_override::current();
+
+    if (opt.role == role::server) {
+        server(context, true);
+        return;
+    }
+    if (opt.role == role::client) {
+        client(context, true);
+        return;
+    }
+
+    std::exception_ptr server_error;
+    std::thread server_thread([&]() {
+        try {
+            server(context, false);
+        } catch (...) {
+            server_error = std::current_exception();
+        }
+    });
+
+    try {
+        client(context, false);
+    } catch (...) {
+        // Unblock the server before joining
+        context.shutdown();
+        server_thread.join();
+        throw;
+    }
+
+    server_thread.join();
+    if (server_error) {
+        std::rethrow_exception(server_error);
+    }
+}
+
+// For commands that run several threads on one context: guarded(body) wraps
+// a thread body so its first failure is kept and the context shut down,
+// which makes the other threads return with ETERM (not a failure)
+class first_error {
+public:
+    explicit first_error(zmq::context_t &context) : context_(context) {}
+    first_error(const first_error &) = delete;
+    first_error &operator=(const first_error &) = delete;
+
+    template <typename Body>
+    auto guarded(Body body) {
+        return [this, body]() {
+            try {
+                body();
+            } catch (const zmq::error_t &e) {
+                if (e.num() != ETERM) {
+                    record();
+                }
+            } catch (...) {
+                record();
+            }
+        };
+    }
+
+    // Rethrows the first failure, if any
+    void rethrow() const;
+
+private:
+    // Call from a catch block
+    void record();
+
+    zmq::context_t &context_;
+    mutable std::mutex lock_;
+    std::exception_ptr error_;
+};
+
+}  // namespace zmqbench
+
+#endif  // ZMQBENCH_COMMANDS_HPP
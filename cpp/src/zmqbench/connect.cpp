@@ -0,0 +1,346 @@
+/*
+ * zmqbench connect - connection establishment rate and time to first
+ * roundtrip.
+ *
+ * Client: each cycle opens a new DEALER socket, applies the security
+ * options, connects, sends one request, waits for its echo and closes the
+ * socket (linger 0). The sample is the time from connect() to the reply:
+ * TCP or IPC connect, ZMTP greeting, security handshake, ZAP exchange when
+ * a handler runs, and one roundtrip; warm-up excluded, this is what
+ * remote_lat never sees. The connect rate is cycles per second over the
+ * whole loop, socket creation and close included.
+ *
+ * Server: a ROUTER echo (router_echo.hpp), bound anew for each
+ * configuration (mechanism x ZAP off/on), with a ZAP handler in its context
+ * for the "on" runs. PLAIN only runs with the handler: libzmq checks PLAIN
+ * credentials over ZAP and fails the handshake without one. Both sides step
+ * through the configurations in the same order and the client ends each one
+ * with "stop". The server's CURVE keypair is generated once; a client in
+ * another process takes the public key from --curve-serverkey.
+ */
+
+#include "zmqbench/commands.hpp"
+#include "zmqbench/report.hpp"
+#include "zmqbench/router_echo.hpp"
+#include "zmqbench/security.hpp"
+#include "zmqbench/stats.hpp"
+
+#include <zmq.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace zmqbench {
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// A handshake that has not completed by then is failing (wrong CURVE key,
+// nothing listening), not slow; libzmq would retry it forever
+constexpr int reply_timeout_ms = 5000;
+
+// Warm-up attempts that reach the previous configuration's socket, still
+// closing, get no reply; they are retried on a new socket
+constexpr int warm_up_timeout_ms = 1000;
+constexpr int warm_up_attempts = 10;
+
+struct configuration {
+    std::string mechanism;
+    bool zap = false;
+};
+
+std::vector<configuration> configurations(const options &opt) {
+    std::vector<std::string> mechanisms =
+        opt.mechanisms.empty() ? available_mechanisms() : opt.mechanisms;
+    std::string zap = opt.zap.empty() ? "both" : opt.zap;
+
+    // libzmq leaves checking PLAIN credentials to ZAP: without a handler
+    // every PLAIN handshake fails
+    std::vector<configuration> configs;
+    for (const std::string &mechanism : mechanisms) {
+        if (mechanism == "plain" && zap == "off") {
+            throw usage_error("plain needs a ZAP handler (--zap on or both)");
+        }
+        if (zap != "on" && mechanism != "plain") {
+            configs.push_back({mechanism, false});
+        }
+        if (zap != "off") {
+            configs.push_back({mechanism, true});
+        }
+    }
+    return configs;
+}
+
+bool uses_curve(const std::vector<configuration> &configs) {
+    return std::any_of(configs.begin(), configs.end(),
+                       [](const configuration &c) { return c.mechanism == "curve"; });
+}
+
+std::string describe(const configuration &c) {
+    return c.mechanism + (c.zap ? " + ZAP" : "");
+}
+
+// Power-of-two buckets: bucket i counts samples in [2^(first+i), 2^(first+i+1)) us
+struct histogram {
+    int first = 0;
+    std::vector<size_t> counts;
+};
+
+histogram make_histogram(const std::vector<double> &samples) {
+    histogram h;
+    if (samples.empty()) {
+        return h;
+    }
+    auto bucket = [](double us) { return static_cast<int>(std::floor(std::log2(std::max(us, 1.0)))); };
+    auto [low, high] = std::minmax_element(samples.begin(), samples.end());
+    h.first = bucket(*low);
+    h.counts.assign(static_cast<size_t>(bucket(*high) - h.first + 1), 0);
+    for (double us : samples) {
+        h.counts[static_cast<size_t>(bucket(us) - h.first)]++;
+    }
+    return h;
+}
+
+struct connect_result {
+    configuration config;
+    size_t cycles = 0;
+    double elapsed_us = 0.0;
+    latency_summary latency;
+    histogram spread;
+
+    double connects_per_sec() const { return cycles / (elapsed_us / 1000000.0); }
+};
+
+class connector {
+public:
+    connector(zmq::context_t &context, const options &opt, const std::string &server_key)
+        : context_(context), opt_(opt), server_key_(server_key) {
+        if (curve_available()) {
+            keys_ = make_curve_keypair();
+        }
+    }
+
+    zmq::socket_t open(const configuration &c, int timeout_ms) {
+        zmq::socket_t socket(context_, zmq::socket_type::dealer);
+        configure(socket, opt_.sockopts);
+        secure_client(socket, c.mechanism, server_key_, keys_);
+        socket.set(zmq::sockopt::linger, 0);
+        socket.set(zmq::sockopt::rcvtimeo, timeout_ms);
+        return socket;
+    }
+
+    // One request on a connected socket; false when no reply came in time
+    bool roundtrip(zmq::socket_t &socket, std::vector<char> &payload, zmq::message_t &reply) {
+        if (!socket.send(zmq::buffer(payload), zmq::send_flags::none)) {
+            throw std::runtime_error("Failed to send request");
+        }
+        if (!socket.recv(reply, zmq::recv_flags::none)) {
+            return false;
+        }
+        if (reply.size() != payload.size()) {
+            throw std::runtime_error("Message size mismatch. Expected " + std::to_string(payload.size()) +
+                                     ", got " + std::to_string(reply.size()));
+        }
+        return true;
+    }
+
+    // Returns once the server of this configuration has answered
+    void warm_up(const configuration &c, std::vector<char> &payload) {
+        zmq::message_t reply;
+        for (int attempt = 0; attempt < warm_up_attempts; attempt++) {
+            zmq::socket_t socket = open(c, warm_up_timeout_ms);
+            socket.connect(opt_.endpoint);
+            if (roundtrip(socket, payload, reply)) {
+                return;
+            }
+        }
+        throw std::runtime_error("no reply from " + opt_.endpoint + " with " + describe(c) +
+                                 " (server not running, or a wrong --curve-serverkey)");
+    }
+
+    connect_result measure(const configuration &c, size_t message_size, int cycles) {
+        std::vector<char> payload(message_size, 'X');
+        warm_up(c, payload);
+
+        std::vector<double> samples;
+        samples.reserve(static_cast<size_t>(cycles));
+        zmq::message_t reply;
+        auto start = clock_type::now();
+        for (int i = 0; i < cycles; i++) {
+            zmq::socket_t socket = open(c, reply_timeout_ms);
+            auto connect_start = clock_type::now();
+            socket.connect(opt_.endpoint);
+            if (!roundtrip(socket, payload, reply)) {
+                throw std::runtime_error("no reply on connection " + std::to_string(i) + " within " +
+                                         std::to_string(reply_timeout_ms) + " ms");
+            }
+            samples.push_back(
+                std::chrono::duration<double, std::micro>(clock_type::now() - connect_start).count());
+        }
+        auto elapsed = clock_type::now() - start;
+
+        connect_result r;
+        r.config = c;
+        r.cycles = samples.size();
+        r.elapsed_us = std::chrono::duration<double, std::micro>(elapsed).count();
+        r.spread = make_histogram(samples);
+        r.latency = summarize(std::move(samples));
+        return r;
+    }
+
+    void stop(const configuration &c) {
+        zmq::socket_t socket = open(c, reply_timeout_ms);
+        socket.connect(opt_.endpoint);
+        ask(socket, "stop", "bye");
+    }
+
+private:
+    zmq::context_t &context_;
+    const options &opt_;
+    std::string server_key_;
+    curve_keypair keys_;
+};
+
+void print(std::ostream &out, const options &opt, size_t size, const connect_result &r) {
+    out << "\n=== Connection Setup Results ===\n";
+    out << "Transport: " << transport_of(opt.endpoint) << "\n";
+    out << "Mechanism: " << r.config.mechanism << (r.config.zap ? " (ZAP handler)" : "") << "\n";
+    out << "Message size: " << size << " bytes\n";
+    out << "Connections: " << r.cycles << "\n";
+    out << "Connect rate: " << r.connects_per_sec() << " connects/s\n";
+    out << "Time to first roundtrip: mean " << r.latency.mean << " us, p50 " << r.latency.p50
+        << " us, p90 " << r.latency.p90 << " us, p99 " << r.latency.p99 << " us, p99.9 "
+        << r.latency.p999 << " us, max " << r.latency.max << " us\n";
+
+    size_t widest = *std::max_element(r.spread.counts.begin(), r.spread.counts.end());
+    out << "Histogram (time to first roundtrip):\n";
+    for (size_t i = 0; i < r.spread.counts.size(); i++) {
+        long long low = 1LL << (r.spread.first + static_cast<int>(i));
+        size_t count = r.spread.counts[i];
+        out << "  " << std::setw(8) << low << " - " << std::setw(8) << (low * 2) << " us "
+            << std::setw(8) << count << " " << std::string(count * 40 / widest, '#') << "\n";
+    }
+}
+
+bench_output::record connect_record(const options &opt, size_t size, const connect_result &r) {
+    bench_output::record rec;
+    rec.benchmark = "connect";
+    rec.role = role_name(opt.role);
+    rec.transport = transport_of(opt.endpoint);
+    rec.endpoint = opt.endpoint;
+    rec.size = size;
+    rec.count = opt.count;
+    rec.messages = static_cast<long long>(r.cycles);
+    rec.elapsed_us = r.elapsed_us;
+    rec.msg_per_sec = r.connects_per_sec();
+    rec.latency_us = r.latency.mean;
+    rec.min_us = r.latency.min;
+    rec.p50_us = r.latency.p50;
+    rec.p90_us = r.latency.p90;
+    rec.p99_us = r.latency.p99;
+    rec.p999_us = r.latency.p999;
+    rec.max_us = r.latency.max;
+    rec.samples = static_cast<long long>(r.latency.samples);
+    rec.zmq_version = zmq_version_string();
+    rec.set("mechanism", r.config.mechanism);
+    rec.set("zap", r.config.zap ? 1LL : 0LL);
+
+    // {"lower bound in us": count, ...}
+    std::string buckets = "{";
+    for (size_t i = 0; i < r.spread.counts.size(); i++) {
+        long long low = 1LL << (r.spread.first + static_cast<int>(i));
+        buckets += (i == 0 ? "\"" : ",\"") + std::to_string(low) + "\":" +
+                   std::to_string(r.spread.counts[i]);
+    }
+    rec.config.emplace_back("histogram_us", buckets + "}");
+    return rec;
+}
+
+}  // namespace
+
+void run_connect(const options &opt) {
+    if (!opt.control.empty()) {
+        throw usage_error("connect runs its own server (--role server), not through --control");
+    }
+    for (size_t size : opt.sizes) {
+        if (size < sizeof(std::int64_t)) {
+            throw usage_error("connect needs messages of at least 8 bytes (shorter ones are "
+                              "control verbs)");
+        }
+    }
+
+    std::vector<configuration> configs = configurations(opt);
+    bool curve = uses_curve(configs);
+    curve_keypair server_keys;
+    if (curve && opt.role != role::client) {
+        server_keys = make_curve_keypair();
+    }
+    std::string server_key = opt.role == role::client ? opt.curve_serverkey : server_keys.public_key;
+    if (curve && server_key.empty()) {
+        throw usage_error("curve needs --curve-serverkey (printed by the server at startup)");
+    }
+
+    auto server = [&](zmq::context_t &context, bool verbose) {
+        if (verbose && chatty(opt)) {
+            std::cout << "Listening on " << opt.endpoint << "\n";
+            if (curve) {
+                // Flushed now: a client in another process needs it to connect
+                std::cout << "CURVE server key: " << server_keys.public_key << std::endl;
+            }
+        }
+
+        for (size_t size : opt.sizes) {
+            for (const configuration &c : configs) {
+                std::unique_ptr<zap_handler> zap;
+                if (c.zap) {
+                    zap = std::make_unique<zap_handler>(context);
+                }
+                zmq::socket_t socket(context, zmq::socket_type::router);
+                configure(socket, opt.sockopts);
+                secure_server(socket, c.mechanism, server_keys, c.zap);
+                bind_with_retry(socket, opt.endpoint);
+
+                long long echoed = router_echo(socket);
+                if (verbose && chatty(opt)) {
+                    std::cout << "Served " << echoed << " connections of " << size << " bytes with "
+                              << describe(c) << ".\n";
+                }
+            }
+        }
+    };
+
+    auto client = [&](zmq::context_t &context, bool verbose) {
+        connector peer(context, opt, server_key);
+        if (verbose && chatty(opt)) {
+            std::cout << "Connecting to " << opt.endpoint << "\n";
+        }
+
+        for (size_t size : opt.sizes) {
+            for (const configuration &c : configs) {
+                if (chatty(opt)) {
+                    std::cout << "Opening " << opt.count << " connections with " << describe(c)
+                              << "...\n";
+                }
+                connect_result r = peer.measure(c, size, opt.count);
+                peer.stop(c);
+                if (opt.format == "text") {
+                    print(std::cout, opt, size, r);
+                }
+                write_record(opt, connect_record(opt, size, r));
+            }
+        }
+    };
+
+    run_roles(opt, server, client);
+}
+
+}  // namespace zmqbench
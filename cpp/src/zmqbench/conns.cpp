@@ -0,0 +1,347 @@
+/*
+ * zmqbench conns - connection-count scaling against one ROUTER echo.
+ *
+ * Server: one ROUTER socket echoes every request to its sender
+ * (router_echo.hpp). Client: for each
+ * N in --sockets, N DEALER (or REQ, --peer) sockets each hold one
+ * connection; --threads client threads share them. After a warm-up round
+ * that proves every connection is up, each round sends one timestamped
+ * request on every connection and waits until each one has its reply.
+ *
+ * Throughput is replies per second over all connections. Latency is request
+ * to reply (a roundtrip, not halved), so it includes the time spent behind
+ * the other N-1 requests of the same round. Once per N the client asks the
+ * server for its RSS and open fds; the growth over the server's idle
+ * baseline, divided by N, is the per-connection cost (routing table, pipes,
+ * session and engine buffers). With --role both the server shares the
+ * process with the clients and the figures cover both sides.
+ */
+
+#include "zmqbench/commands.hpp"
+#include "zmqbench/report.hpp"
+#include "zmqbench/router_echo.hpp"
+#include "zmqbench/stats.hpp"
+
+#include <zmq.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace zmqbench {
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// The kernel caps the accept queue at net.core.somaxconn; libzmq's default
+// of 100 makes thousands of simultaneous connects retry their SYNs
+constexpr int server_backlog = 4096;
+
+std::int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now().time_since_epoch())
+        .count();
+}
+
+// Runs `rounds` rounds on sockets [begin, end): one request on each, then
+// zmq_poll over the connections still waiting until each has its reply.
+// Roundtrip samples (us) are kept when samples is not null.
+void run_rounds(std::vector<zmq::socket_t> &sockets, size_t begin, size_t end, size_t message_size,
+                int rounds, std::vector<double> *samples) {
+    std::vector<char> payload(message_size, 'X');
+    std::vector<char> reply(message_size);
+    std::vector<zmq_pollitem_t> items;
+    std::vector<size_t> waiting;
+    items.reserve(end - begin);
+    waiting.reserve(end - begin);
+
+    for (int round = 0; round < rounds; round++) {
+        waiting.clear();
+        for (size_t i = begin; i < end; i++) {
+            std::int64_t sent_ns = now_ns();
+            std::memcpy(payload.data(), &sent_ns, sizeof(sent_ns));
+            if (!sockets[i].send(zmq::buffer(payload), zmq::send_flags::none)) {
+                throw std::runtime_error("Failed to send on connection " + std::to_string(i));
+            }
+            waiting.push_back(i);
+        }
+
+        while (!waiting.empty()) {
+            items.clear();
+            for (size_t i : waiting) {
+                items.push_back({sockets[i].handle(), 0, ZMQ_POLLIN, 0});
+            }
+            if (zmq_poll(items.data(), static_cast<int>(items.size()), -1) < 0) {
+                throw zmq::error_t();
+            }
+
+            // Keep the connections without a reply for the next wait
+            size_t kept = 0;
+            for (size_t j = 0; j < items.size(); j++) {
+                size_t i = waiting[j];
+                if ((items[j].revents & ZMQ_POLLIN) == 0) {
+                    waiting[kept++] = i;
+                    continue;
+                }
+                auto received = sockets[i].recv(zmq::buffer(reply), zmq::recv_flags::dontwait);
+                if (!received) {
+                    waiting[kept++] = i;
+                    continue;
+                }
+                if (received->truncated() || received->size != message_size) {
+                    throw std::runtime_error("Message size mismatch. Expected " +
+                                             std::to_string(message_size) + ", got " +
+                                             std::to_string(received->untruncated_size));
+                }
+                if (samples != nullptr) {
+                    std::int64_t sent_ns;
+                    std::memcpy(&sent_ns, reply.data(), sizeof(sent_ns));
+                    samples->push_back(static_cast<double>(now_ns() - sent_ns) / 1000.0);
+                }
+            }
+            waiting.resize(kept);
+        }
+    }
+}
+
+struct conns_result {
+    size_t connections = 0;
+    size_t threads = 0;
+    size_t requests = 0;
+    double setup_ms = 0.0;    // connects and the warm-up round
+    double elapsed_us = 0.0;  // timed rounds, all threads
+    latency_summary latency;
+
+    usage server;  // at the end of the timed rounds
+    usage baseline;  // before the first connection
+
+    double msg_per_sec() const { return requests / (elapsed_us / 1000000.0); }
+    double rss_per_connection_kb() const {
+        return static_cast<double>(server.rss_kb - baseline.rss_kb) / connections;
+    }
+    double fds_per_connection() const {
+        return static_cast<double>(server.fds - baseline.fds) / connections;
+    }
+};
+
+// Why connection `index` could not be opened. zmq_socket() reports both a
+// full socket table (ZMQ_MAX_SOCKETS) and running out of fds as EMFILE.
+std::string open_failure(const zmq::error_t &e, size_t index, size_t connections,
+                         size_t open_sockets, int max_sockets) {
+    std::string message = "could not open connection " + std::to_string(index + 1) + " of " +
+                          std::to_string(connections) + ": " + e.what() + " (errno " +
+                          std::to_string(e.num());
+    if (e.num() == EMFILE || e.num() == ENFILE) {
+        if (open_sockets >= static_cast<size_t>(max_sockets)) {
+            message += ", libzmq socket limit ZMQ_MAX_SOCKETS=" + std::to_string(max_sockets);
+        } else {
+            message += ", raise the open file limit, ulimit -n";
+        }
+    }
+    return message + ")";
+}
+
+conns_result measure(const options &opt, size_t connections, size_t message_size) {
+    // A context per N, as in poll: the socket limit has to be set before the
+    // first socket, and closing the context waits until libzmq has reaped
+    // every socket, so the next N starts with an empty socket table
+    zmq::context_t context(opt.io_threads);
+    int max_sockets = static_cast<int>(connections) + 16;
+    context.set(zmq::ctxopt::max_sockets, max_sockets);
+
+    zmq::socket_type type = opt.peer == "req" ? zmq::socket_type::req : zmq::socket_type::dealer;
+    size_t threads = std::min(static_cast<size_t>(opt.client_threads), connections);
+    int rounds = std::max(1, opt.count / static_cast<int>(connections));
+
+    conns_result r;
+    r.connections = connections;
+    r.threads = threads;
+
+    auto setup_start = clock_type::now();
+    std::vector<zmq::socket_t> sockets;
+    sockets.reserve(connections);
+    for (size_t i = 0; i < connections; i++) {
+        try {
+            sockets.emplace_back(context, type);
+            configure(sockets.back(), opt.sockopts);
+            sockets.back().set(zmq::sockopt::linger, 0);
+            sockets.back().connect(opt.endpoint);
+        } catch (const zmq::error_t &e) {
+            throw std::runtime_error(open_failure(e, i, connections, sockets.size(), max_sockets));
+        }
+    }
+
+    // Every connection answered once: all peers are known to the ROUTER
+    run_rounds(sockets, 0, connections, message_size, 1, nullptr);
+    r.setup_ms = std::chrono::duration<double, std::milli>(clock_type::now() - setup_start).count();
+
+    std::vector<std::vector<double>> samples(threads);
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    auto start = clock_type::now();
+    for (size_t t = 0; t < threads; t++) {
+        samples[t].reserve(static_cast<size_t>(rounds) * (connections / threads + 1));
+        workers.emplace_back([&, t]() {
+            try {
+                run_rounds(sockets, t * connections / threads, (t + 1) * connections / threads,
+                           message_size, rounds, &samples[t]);
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    r.elapsed_us = std::chrono::duration<double, std::micro>(clock_type::now() - start).count();
+    for (const std::exception_ptr &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::vector<double> all;
+    for (const std::vector<double> &part : samples) {
+        all.insert(all.end(), part.begin(), part.end());
+    }
+    r.requests = all.size();
+    r.latency = summarize(std::move(all));
+
+    control_message stats = ask(sockets[0], "stats", "usage");
+    r.server.available = r.baseline.available = stats.get("available") == "1";
+    r.server.rss_kb = static_cast<long long>(stats.number("rss_kb"));
+    r.server.fds = static_cast<long long>(stats.number("fds"));
+    r.baseline.rss_kb = static_cast<long long>(stats.number("base_rss_kb"));
+    r.baseline.fds = static_cast<long long>(stats.number("base_fds"));
+    return r;
+}
+
+void print(std::ostream &out, const options &opt, size_t size, const conns_result &r) {
+    // With --role both the usage is the whole process, clients included
+    std::string scope = opt.role == role::both ? "Process (server + clients)" : "Server";
+
+    out << "\n=== Connection Scaling Results ===\n";
+    out << "Peer: " << opt.peer << "\n";
+    out << "Connections: " << r.connections << " (" << r.threads << " client threads)\n";
+    out << "Message size: " << size << " bytes\n";
+    out << "Requests: " << r.requests << "\n";
+    out << "Setup (connect + first roundtrip): " << r.setup_ms << " ms\n";
+    out << "Throughput: " << r.msg_per_sec() << " msg/s\n";
+    out << "Latency (request to reply): mean " << r.latency.mean << " us, p50 " << r.latency.p50
+        << " us, p99 " << r.latency.p99 << " us, p99.9 " << r.latency.p999 << " us, max "
+        << r.latency.max << " us\n";
+    if (r.server.available) {
+        out << scope << " RSS: " << r.server.rss_kb << " KiB (" << r.rss_per_connection_kb()
+            << " KiB per connection)\n";
+        out << scope << " fds: " << r.server.fds << " (" << r.fds_per_connection()
+            << " per connection)\n";
+    } else {
+        out << scope << " RSS and fds: not available on this platform\n";
+    }
+}
+
+bench_output::record conns_record(const options &opt, size_t size, const conns_result &r) {
+    bench_output::record rec;
+    rec.benchmark = "conns";
+    rec.role = role_name(opt.role);
+    rec.transport = transport_of(opt.endpoint);
+    rec.endpoint = opt.endpoint;
+    rec.size = size;
+    rec.count = opt.count;
+    rec.messages = static_cast<long long>(r.requests);
+    rec.elapsed_us = r.elapsed_us;
+    rec.msg_per_sec = r.msg_per_sec();
+    rec.mbps = r.msg_per_sec() * size * 8 / 1000000.0;
+    rec.latency_us = r.latency.mean;
+    rec.min_us = r.latency.min;
+    rec.p50_us = r.latency.p50;
+    rec.p90_us = r.latency.p90;
+    rec.p99_us = r.latency.p99;
+    rec.p999_us = r.latency.p999;
+    rec.max_us = r.latency.max;
+    rec.samples = static_cast<long long>(r.latency.samples);
+    rec.zmq_version = zmq_version_string();
+    rec.set("peer", opt.peer);
+    rec.set("connections", static_cast<long long>(r.connections));
+    rec.set("threads", static_cast<long long>(r.threads));
+    rec.config.emplace_back("setup_ms", bench_output::json_number(r.setup_ms));
+    if (r.server.available) {
+        rec.set("usage_scope", opt.role == role::both ? "process" : "server");
+        rec.set("rss_kb", r.server.rss_kb);
+        rec.config.emplace_back("rss_per_conn_kb", bench_output::json_number(r.rss_per_connection_kb()));
+        rec.set("fds", r.server.fds);
+        rec.config.emplace_back("fds_per_conn", bench_output::json_number(r.fds_per_connection()));
+    }
+    return rec;
+}
+
+}  // namespace
+
+void run_conns(const options &opt) {
+    if (!opt.control.empty()) {
+        throw usage_error("conns runs its own server (--role server), not through --control");
+    }
+    if (opt.peer == "pair") {
+        throw usage_error("conns needs a peer a ROUTER can serve: --peer dealer or req");
+    }
+    raise_fd_limit();
+
+    auto server = [&](zmq::context_t &context, bool verbose) {
+        zmq::socket_t socket(context, zmq::socket_type::router);
+        configure(socket, opt.sockopts);
+        socket.set(zmq::sockopt::backlog, server_backlog);
+        bind_with_retry(socket, opt.endpoint);
+        if (verbose && chatty(opt)) {
+            std::cout << "Listening on " << opt.endpoint << "\n";
+            std::cout << "Waiting for connections...\n";
+        }
+
+        long long echoed = router_echo(socket);
+        if (verbose && chatty(opt)) {
+            std::cout << "Echoed " << echoed << " requests.\n";
+        }
+    };
+
+    auto client = [&](zmq::context_t &context, bool verbose) {
+        for (size_t size : opt.sizes) {
+            if (size < sizeof(std::int64_t)) {
+                throw usage_error("conns needs messages of at least 8 bytes (send timestamp)");
+            }
+        }
+
+        if (verbose && chatty(opt)) {
+            std::cout << "Connecting to " << opt.endpoint << "\n";
+        }
+
+        for (size_t size : opt.sizes) {
+            for (size_t connections : opt.sockets) {
+                if (chatty(opt)) {
+                    std::cout << "Opening " << connections << " " << opt.peer << " connections...\n";
+                }
+                conns_result r = measure(opt, connections, size);
+                if (opt.format == "text") {
+                    print(std::cout, opt, size, r);
+                }
+                write_record(opt, conns_record(opt, size, r));
+            }
+        }
+
+        zmq::socket_t stopper(context, opt.peer == "req" ? zmq::socket_type::req
+                                                         : zmq::socket_type::dealer);
+        stopper.set(zmq::sockopt::linger, 0);
+        stopper.connect(opt.endpoint);
+        ask(stopper, "stop", "bye");
+    };
+
+    run_roles(opt, server, client);
+}
+
+}  // namespace zmqbench
@@ -0,0 +1,195 @@
+#include "zmqbench/control.hpp"
+#include "zmqbench/alloc_count.hpp"
+#include "zmqbench/security.hpp"
+
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
+namespace zmqbench {
+
+const std::string &control_message::get(const std::string &key) const {
+    auto it = fields.find(key);
+    if (it == fields.end()) {
+        throw std::runtime_error("control message '" + verb + "' has no field '" + key + "'");
+    }
+    return it->second;
+}
+
+double control_message::number(const std::string &key) const {
+    return std::atof(get(key).c_str());
+}
+
+std::string encode(const control_message &msg) {
+    std::string text = msg.verb;
+    if (msg.verb == "error") {
+        auto it = msg.fields.find("message");
+        if (it != msg.fields.end()) {
+            text += " " + it->second;
+        }
+        return text;
+    }
+    for (const auto &field : msg.fields) {
+        text += " " + field.first + "=" + field.second;
+    }
+    return text;
+}
+
+control_message decode(const std::string &text) {
+    control_message msg;
+    std::istringstream in(text);
+    in >> msg.verb;
+
+    // Error text is free-form: everything after the verb
+    if (msg.verb == "error") {
+        std::string rest;
+        std::getline(in, rest);
+        msg.fields["message"] = rest.empty() ? rest : rest.substr(1);
+        return msg;
+    }
+
+    std::string token;
+    while (in >> token) {
+        size_t eq = token.find('=');
+        if (eq == std::string::npos) {
+            throw std::runtime_error("malformed control field '" + token + "'");
+        }
+        msg.fields[token.substr(0, eq)] = token.substr(eq + 1);
+    }
+    return msg;
+}
+
+control_message encode_spec(const test_spec &spec) {
+    control_message msg("spec");
+    msg.fields["command"] = spec.command;
+    msg.fields["size"] = std::to_string(spec.message_size);
+    msg.fields["count"] = std::to_string(spec.message_count);
+    msg.fields["sndhwm"] = std::to_string(spec.sockopts.sndhwm);
+    msg.fields["rcvhwm"] = std::to_string(spec.sockopts.rcvhwm);
+    msg.fields["sndbuf"] = std::to_string(spec.sockopts.sndbuf);
+    msg.fields["rcvbuf"] = std::to_string(spec.sockopts.rcvbuf);
+    msg.fields["recv"] = spec.recv;
+    msg.fields["allocs"] = spec.count_allocs ? "1" : "0";
+    msg.fields["mechanism"] = spec.mechanism;
+    msg.fields["zap"] = spec.zap ? "1" : "0";
+    return msg;
+}
+
+test_spec decode_spec(const control_message &msg) {
+    test_spec spec;
+    spec.command = msg.get("command");
+    spec.message_size = static_cast<size_t>(msg.number("size"));
+    spec.message_count = static_cast<int>(msg.number("count"));
+    spec.sockopts.sndhwm = static_cast<int>(msg.number("sndhwm"));
+    spec.sockopts.rcvhwm = static_cast<int>(msg.number("rcvhwm"));
+    spec.sockopts.sndbuf = static_cast<int>(msg.number("sndbuf"));
+    spec.sockopts.rcvbuf = static_cast<int>(msg.number("rcvbuf"));
+    spec.recv = msg.get("recv");
+    spec.count_allocs = msg.number("allocs") != 0.0;
+    spec.mechanism = msg.get("mechanism");
+    spec.zap = msg.number("zap") != 0.0;
+    if (spec.recv != "message" && spec.recv != "buffer") {
+        throw std::runtime_error("unknown receive mode '" + spec.recv + "'");
+    }
+    if (spec.mechanism != "null" && spec.mechanism != "plain" && spec.mechanism != "curve") {
+        throw std::runtime_error("unknown mechanism '" + spec.mechanism + "'");
+    }
+    if (spec.mechanism == "curve" && !curve_available()) {
+        throw std::runtime_error("this server's libzmq was built without CURVE support");
+    }
+    if (spec.mechanism == "plain" && !spec.zap) {
+        throw std::runtime_error("plain needs a ZAP handler");
+    }
+    if (spec.count_allocs && !alloc_count::available()) {
+        throw std::runtime_error("allocation counting is not available on this server");
+    }
+    if (spec.message_size == 0 || spec.message_count <= 0) {
+        throw std::runtime_error("spec needs a positive size and count");
+    }
+    return spec;
+}
+
+control_message encode_served(const served &outcome) {
+    control_message msg("done");
+    msg.fields["received"] = std::to_string(outcome.received);
+    if (outcome.measured) {
+        const result &r = *outcome.measured;
+        std::ostringstream elapsed, rate, megabits;
+        elapsed.precision(17);
+        rate.precision(17);
+        megabits.precision(17);
+        elapsed << r.elapsed_us;
+        rate << r.msg_per_sec;
+        megabits << r.megabits;
+        msg.fields["elapsed_us"] = elapsed.str();
+        msg.fields["msg_per_sec"] = rate.str();
+        msg.fields["megabits"] = megabits.str();
+        if (r.has_allocs) {
+            std::ostringstream allocs;
+            allocs.precision(17);
+            allocs << r.allocs_per_msg;
+            msg.fields["allocs_per_msg"] = allocs.str();
+        }
+    }
+    return msg;
+}
+
+served decode_served(const control_message &msg) {
+    served outcome;
+    outcome.received = static_cast<int>(msg.number("received"));
+    if (msg.fields.count("elapsed_us") != 0) {
+        result r;
+        r.elapsed_us = msg.number("elapsed_us");
+        r.msg_per_sec = msg.number("msg_per_sec");
+        r.megabits = msg.number("megabits");
+        if (msg.fields.count("allocs_per_msg") != 0) {
+            r.has_allocs = true;
+            r.allocs_per_msg = msg.number("allocs_per_msg");
+        }
+        outcome.measured = r;
+    }
+    return outcome;
+}
+
+control_client::control_client(zmq::context_t &context, const std::string &endpoint)
+    : socket_(context, zmq::socket_type::req) {
+    socket_.set(zmq::sockopt::linger, 0);
+    socket_.connect(endpoint);
+}
+
+control_message control_client::prepare(const test_spec &spec) {
+    return request(encode_spec(spec), "ready");
+}
+
+void control_client::start() {
+    request(control_message("start"), "started");
+}
+
+served control_client::finish() {
+    return decode_served(request(control_message("finish"), "done"));
+}
+
+void control_client::stop() {
+    request(control_message("stop"), "bye");
+}
+
+control_message control_client::request(const control_message &msg, const char *expected) {
+    std::string text = encode(msg);
+    socket_.send(zmq::buffer(text), zmq::send_flags::none);
+
+    zmq::message_t reply;
+    if (!socket_.recv(reply, zmq::recv_flags::none)) {
+        throw std::runtime_error("no reply to control request '" + msg.verb + "'");
+    }
+
+    control_message answer = decode(reply.to_string());
+    if (answer.verb == "error") {
+        throw std::runtime_error("server: " + answer.fields["message"]);
+    }
+    if (answer.verb != expected) {
+        throw std::runtime_error("unexpected control reply '" + answer.verb + "' to '" + msg.verb + "'");
+    }
+    return answer;
+}
+
+}  // namespace zmqbench
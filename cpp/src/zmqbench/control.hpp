@@ -0,0 +1,69 @@
+/*
+ * zmqbench - control channel between a client and `zmqbench serve`.
+ *
+ * REQ (client) / REP (server) on its own endpoint, one text frame per
+ * message: a verb followed by space-separated key=value fields.
+ *
+ *   spec command=thr size=64 count=N ...  ->  ready     data socket bound
+ *                                             [curve_serverkey=K]
+ *   start                                 ->  started   server primed
+ *   finish                                ->  done received=N [result fields]
+ *   stop                                  ->  bye
+ *
+ * Any request may be answered with "error <text>" instead.
+ */
+
+#ifndef ZMQBENCH_CONTROL_HPP
+#define ZMQBENCH_CONTROL_HPP
+
+#include "zmqbench/commands.hpp"
+#include "zmqbench/report.hpp"
+
+#include <zmq.hpp>
+
+#include <map>
+#include <string>
+
+namespace zmqbench {
+
+struct control_message {
+    std::string verb;
+    std::map<std::string, std::string> fields;
+
+    control_message() = default;
+    explicit control_message(std::string v) : verb(std::move(v)) {}
+
+    // Throws std::runtime_error when the field is missing
+    const std::string &get(const std::string &key) const;
+    double number(const std::string &key) const;
+};
+
+std::string encode(const control_message &msg);
+control_message decode(const std::string &text);
+
+control_message encode_spec(const test_spec &spec);
+test_spec decode_spec(const control_message &msg);
+
+// "done" reply for a finished test
+control_message encode_served(const served &outcome);
+served decode_served(const control_message &msg);
+
+class control_client {
+public:
+    control_client(zmq::context_t &context, const std::string &endpoint);
+
+    // Returns once the server is bound, with its "ready" reply
+    control_message prepare(const test_spec &spec);
+    void start();                         // returns once the server is primed
+    served finish();                      // returns the server's counters
+    void stop();
+
+private:
+    control_message request(const control_message &msg, const char *expected);
+
+    zmq::socket_t socket_;
+};
+
+}  // namespace zmqbench
+
+#endif  // ZMQBENCH_CONTROL_HPP
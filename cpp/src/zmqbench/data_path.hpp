@@ -0,0 +1,148 @@
+/*
+ * zmqbench - the calls inside the timed loops of lat and thr.
+ *
+ * Compiled twice from the same kernels: against cppzmq (zmqbench_core), and
+ * with ZMQBENCH_RAW_API against the libzmq C API (zmqbench_core_raw). The
+ * raw variant makes the same libzmq calls one for one:
+ *
+ *   message_t(data, size)   zmq_msg_init_size + memcpy
+ *   socket.send(message)    zmq_msg_send
+ *   socket.recv(message)    zmq_msg_recv into a reused zmq_msg_t
+ *
+ * so the difference between the two builds is cppzmq's own cost. Socket
+ * setup stays on cppzmq in both; it is outside the timed loops.
+ *
+ * inbox receives into a message (libzmq owns, and for payloads above the
+ * 33-byte VSM limit allocates, the data); buffer_inbox copies into one
+ * preallocated cache-aligned buffer (recv(mutable_buffer) / zmq_recv) and
+ * flags messages that did not fit.
+ */
+
+#ifndef ZMQBENCH_DATA_PATH_HPP
+#define ZMQBENCH_DATA_PATH_HPP
+
+#include <zmq.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+namespace zmqbench {
+namespace data_path {
+
+#ifdef ZMQBENCH_RAW_API
+
+constexpr const char *binding = "libzmq";
+
+// Received message, reused across calls
+class inbox {
+public:
+    inbox() { zmq_msg_init(&msg_); }
+    ~inbox() { zmq_msg_close(&msg_); }
+    inbox(const inbox &) = delete;
+    inbox &operator=(const inbox &) = delete;
+
+    size_t size() const { return zmq_msg_size(const_cast<zmq_msg_t *>(&msg_)); }
+    bool truncated() const { return false; }
+
+    // Receives one message; false on failure
+    bool recv(zmq::socket_t &socket) { return zmq_msg_recv(&msg_, socket.handle(), 0) >= 0; }
+
+    // Sends the received message back (REP echo); the message is consumed
+    bool send_back(zmq::socket_t &socket) { return zmq_msg_send(&msg_, socket.handle(), 0) >= 0; }
+
+private:
+    zmq_msg_t msg_;
+};
+
+// Copies size bytes into a new message and sends it
+inline bool send_copy(zmq::socket_t &socket, const void *data, size_t size) {
+    zmq_msg_t msg;
+    if (zmq_msg_init_size(&msg, size) != 0) {
+        return false;
+    }
+    std::memcpy(zmq_msg_data(&msg), data, size);
+    if (zmq_msg_send(&msg, socket.handle(), 0) < 0) {
+        zmq_msg_close(&msg);
+        return false;
+    }
+    return true;
+}
+
+// Copies one message into data; returns its full size (more than capacity
+// when truncated), -1 on failure
+inline int recv_into(zmq::socket_t &socket, void *data, size_t capacity) {
+    return zmq_recv(socket.handle(), data, capacity, 0);
+}
+
+#else
+
+constexpr const char *binding = "cppzmq";
+
+class inbox {
+public:
+    size_t size() const { return msg_.size(); }
+    bool truncated() const { return false; }
+
+    bool recv(zmq::socket_t &socket) {
+        return static_cast<bool>(socket.recv(msg_, zmq::recv_flags::none));
+    }
+
+    bool send_back(zmq::socket_t &socket) {
+        return static_cast<bool>(socket.send(msg_, zmq::send_flags::none));
+    }
+
+private:
+    zmq::message_t msg_;
+};
+
+inline bool send_copy(zmq::socket_t &socket, const void *data, size_t size) {
+    zmq::message_t msg(data, size);
+    return static_cast<bool>(socket.send(msg, zmq::send_flags::none));
+}
+
+inline int recv_into(zmq::socket_t &socket, void *data, size_t capacity) {
+    auto received = socket.recv(zmq::mutable_buffer(data, capacity), zmq::recv_flags::none);
+    return received ? static_cast<int>(received->untruncated_size) : -1;
+}
+
+#endif
+
+constexpr size_t CACHE_LINE = 64;
+
+// One cache-aligned buffer of the expected message size, reused for every
+// message; the only per-message allocation left is libzmq's own
+class buffer_inbox {
+public:
+    explicit buffer_inbox(size_t capacity)
+        : capacity_(capacity),
+          data_(static_cast<char *>(::operator new(capacity, std::align_val_t(CACHE_LINE)))) {}
+    ~buffer_inbox() { ::operator delete(data_, std::align_val_t(CACHE_LINE)); }
+    buffer_inbox(const buffer_inbox &) = delete;
+    buffer_inbox &operator=(const buffer_inbox &) = delete;
+
+    size_t size() const { return size_; }
+    bool truncated() const { return size_ > capacity_; }
+
+    bool recv(zmq::socket_t &socket) {
+        int received = recv_into(socket, data_, capacity_);
+        if (received < 0) {
+            return false;
+        }
+        size_ = static_cast<size_t>(received);
+        return true;
+    }
+
+    // Echo copies the buffer into a new message
+    bool send_back(zmq::socket_t &socket) { return send_copy(socket, data_, size_); }
+
+private:
+    size_t capacity_;
+    size_t size_ = 0;
+    char *data_;
+};
+
+}  // namespace data_path
+}  // namespace zmqbench
+
+#endif  // ZMQBENCH_DATA_PATH_HPP
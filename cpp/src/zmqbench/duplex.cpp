@@ -0,0 +1,354 @@
+/*
+ * zmqbench duplex - full-duplex throughput over one connection.
+ *
+ * Both sides hold one DEALER (or PAIR, --peer) socket and run the same
+ * single-threaded zmq_poll loop: send whenever the socket is writable and
+ * messages are left, drain whatever has arrived. A socket may only be used
+ * from one thread, so the loop interleaves the two directions rather than
+ * splitting them across threads. Per size there are two phases:
+ *
+ *   one-way   the client streams N messages, the server only receives
+ *   duplex    both stream N messages at the same time
+ *
+ * Each phase starts with a warm-up roundtrip; each receiver times from its
+ * first message to its last, as in thr. At the end of a phase the server
+ * sends its own figures as one control_message frame after its data.
+ *
+ * I/O thread CPU is the run time of libzmq's "ZMQbg/IO/*" threads over the
+ * streaming window, from /proc/self/task/<tid>/schedstat (Linux only), as a
+ * percentage of one core. With --role both the two sides share one context,
+ * so the client's figure covers both ends of the connection and the I/O
+ * threads carry four streams (--io-threads spreads them).
+ */
+
+#include "zmqbench/commands.hpp"
+#include "zmqbench/control.hpp"
+#include "zmqbench/report.hpp"
+
+#include <zmq.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <dirent.h>
+
+#include <fstream>
+#endif
+
+namespace zmqbench {
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// Total run time of this process's libzmq I/O threads in ns; -1 when the
+// platform does not expose it
+long long io_thread_cpu_ns() {
+#ifdef __linux__
+    DIR *dir = opendir("/proc/self/task");
+    if (dir == nullptr) {
+        return -1;
+    }
+    long long total = 0;
+    bool found = false;
+    while (dirent *entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        std::string task = std::string("/proc/self/task/") + entry->d_name;
+        std::ifstream comm(task + "/comm");
+        std::string name;
+        if (!std::getline(comm, name) || name.rfind("ZMQbg/IO/", 0) != 0) {
+            continue;
+        }
+        std::ifstream schedstat(task + "/schedstat");
+        long long run_ns = 0;
+        if (schedstat >> run_ns) {
+            total += run_ns;
+            found = true;
+        }
+    }
+    closedir(dir);
+    return found ? total : -1;
+#else
+    return -1;
+#endif
+}
+
+// What one side saw in one phase
+struct stream_result {
+    long long received = 0;
+    double recv_elapsed_us = 0.0;  // first to last received message
+    double window_us = 0.0;        // streaming loop, wall clock
+    long long io_cpu_ns = -1;      // I/O threads over the window
+
+    double msg_per_sec() const {
+        return received > 1 ? (received - 1) / (recv_elapsed_us / 1000000.0) : 0.0;
+    }
+    double io_cpu_percent() const {
+        return io_cpu_ns < 0 ? -1.0 : 100.0 * (io_cpu_ns / 1000.0) / window_us;
+    }
+};
+
+void send_blocking(zmq::socket_t &socket, const std::string &text) {
+    if (!socket.send(zmq::buffer(text), zmq::send_flags::none)) {
+        throw std::runtime_error("Failed to send");
+    }
+}
+
+void expect_size(const zmq::recv_buffer_result_t &received, size_t message_size) {
+    if (!received || received->truncated() || received->size != message_size) {
+        throw std::runtime_error("Message size mismatch. Expected " + std::to_string(message_size) +
+                                 ", got " + std::to_string(received ? received->untruncated_size : 0));
+    }
+}
+
+// Sends `to_send` messages and receives `to_receive`, interleaved on one
+// poll loop
+stream_result stream(zmq::socket_t &socket, size_t message_size, long long to_send,
+                     long long to_receive) {
+    std::vector<char> payload(message_size, 'X');
+    std::vector<char> inbound(message_size);
+    stream_result r;
+    long long sent = 0;
+    clock_type::time_point first;
+    clock_type::time_point last;
+
+    long long cpu_before = io_thread_cpu_ns();
+    auto start = clock_type::now();
+    while (sent < to_send || r.received < to_receive) {
+        zmq_pollitem_t item = {socket.handle(), 0, 0, 0};
+        if (r.received < to_receive) {
+            item.events |= ZMQ_POLLIN;
+        }
+        if (sent < to_send) {
+            item.events |= ZMQ_POLLOUT;
+        }
+        if (zmq_poll(&item, 1, -1) < 0) {
+            throw zmq::error_t();
+        }
+
+        if (item.revents & ZMQ_POLLIN) {
+            while (r.received < to_receive) {
+                auto received = socket.recv(zmq::buffer(inbound), zmq::recv_flags::dontwait);
+                if (!received) {
+                    break;
+                }
+                expect_size(received, message_size);
+                last = clock_type::now();
+                if (r.received == 0) {
+                    first = last;
+                }
+                r.received++;
+            }
+        }
+        if (item.revents & ZMQ_POLLOUT) {
+            // Bounded so the receive side is never starved
+            for (int burst = 0; burst < 256 && sent < to_send; burst++) {
+                if (!socket.send(zmq::buffer(payload), zmq::send_flags::dontwait)) {
+                    break;
+                }
+                sent++;
+            }
+        }
+    }
+    r.window_us = std::chrono::duration<double, std::micro>(clock_type::now() - start).count();
+    long long cpu_after = io_thread_cpu_ns();
+    if (cpu_before >= 0 && cpu_after >= 0) {
+        r.io_cpu_ns = cpu_after - cpu_before;
+    }
+    r.recv_elapsed_us = std::chrono::duration<double, std::micro>(last - first).count();
+    return r;
+}
+
+control_message encode_stream(const stream_result &r) {
+    control_message msg("phase");
+    msg.fields["received"] = std::to_string(r.received);
+    msg.fields["recv_elapsed_us"] = std::to_string(r.recv_elapsed_us);
+    msg.fields["window_us"] = std::to_string(r.window_us);
+    msg.fields["io_cpu_ns"] = std::to_string(r.io_cpu_ns);
+    return msg;
+}
+
+stream_result decode_stream(const control_message &msg) {
+    if (msg.verb != "phase") {
+        throw std::runtime_error("Expected the server's phase result, got '" + msg.verb + "'");
+    }
+    stream_result r;
+    r.received = static_cast<long long>(msg.number("received"));
+    r.recv_elapsed_us = msg.number("recv_elapsed_us");
+    r.window_us = msg.number("window_us");
+    r.io_cpu_ns = static_cast<long long>(msg.number("io_cpu_ns"));
+    return r;
+}
+
+// Server side of one phase: warm-up echo, stream, then its figures
+void serve_phase(zmq::socket_t &socket, size_t message_size, long long count, bool duplex) {
+    std::vector<char> warmup(message_size);
+    expect_size(socket.recv(zmq::buffer(warmup), zmq::recv_flags::none), message_size);
+    if (!socket.send(zmq::buffer(warmup), zmq::send_flags::none)) {
+        throw std::runtime_error("Failed to send the warm-up reply");
+    }
+
+    stream_result r = stream(socket, message_size, duplex ? count : 0, count);
+    send_blocking(socket, encode(encode_stream(r)));
+}
+
+struct phase_result {
+    stream_result client;  // server -> client direction
+    stream_result server;  // client -> server direction
+};
+
+phase_result run_phase(zmq::socket_t &socket, size_t message_size, long long count, bool duplex) {
+    std::vector<char> warmup(message_size, 'W');
+    if (!socket.send(zmq::buffer(warmup), zmq::send_flags::none)) {
+        throw std::runtime_error("Failed to send the warm-up request");
+    }
+    expect_size(socket.recv(zmq::buffer(warmup), zmq::recv_flags::none), message_size);
+
+    phase_result r;
+    r.client = stream(socket, message_size, count, duplex ? count : 0);
+
+    zmq::message_t figures;
+    if (!socket.recv(figures, zmq::recv_flags::none)) {
+        throw std::runtime_error("Failed to receive the server's phase result");
+    }
+    r.server = decode_stream(decode(figures.to_string()));
+    return r;
+}
+
+struct duplex_result {
+    double one_way = 0.0;           // client -> server alone, msg/s
+    double client_to_server = 0.0;  // during duplex
+    double server_to_client = 0.0;
+    double client_io_cpu = -1.0;    // percent of one core, duplex window
+    double server_io_cpu = -1.0;
+    double window_us = 0.0;         // client's duplex streaming loop
+
+    double aggregate() const { return client_to_server + server_to_client; }
+};
+
+void print_cpu(std::ostream &out, const char *label, double percent) {
+    out << "I/O thread CPU (" << label << "): ";
+    if (percent < 0) {
+        out << "not available on this platform\n";
+    } else {
+        out << percent << "% of one core\n";
+    }
+}
+
+void print(std::ostream &out, const options &opt, size_t size, const duplex_result &r) {
+    out << "\n=== Full-Duplex Throughput Results ===\n";
+    out << "Peer: " << opt.peer << "\n";
+    out << "Message size: " << size << " bytes\n";
+    out << "Messages: " << opt.count << " per direction\n";
+    out << "One direction alone (client -> server): " << r.one_way << " msg/s\n";
+    out << "Duplex client -> server: " << r.client_to_server << " msg/s ("
+        << 100.0 * r.client_to_server / r.one_way << "% of one direction alone)\n";
+    out << "Duplex server -> client: " << r.server_to_client << " msg/s\n";
+    out << "Aggregate throughput: " << r.aggregate() << " msg/s, "
+        << r.aggregate() * size * 8 / 1000000.0 << " Mb/s\n";
+    if (opt.role == role::both) {
+        print_cpu(out, "process, both sides", r.client_io_cpu);
+    } else {
+        print_cpu(out, "client", r.client_io_cpu);
+        print_cpu(out, "server", r.server_io_cpu);
+    }
+}
+
+bench_output::record duplex_record(const options &opt, size_t size, const duplex_result &r) {
+    bench_output::record rec;
+    rec.benchmark = "duplex";
+    rec.role = role_name(opt.role);
+    rec.transport = transport_of(opt.endpoint);
+    rec.endpoint = opt.endpoint;
+    rec.size = size;
+    rec.count = opt.count;
+    rec.messages = 2LL * opt.count;
+    rec.elapsed_us = r.window_us;
+    rec.msg_per_sec = r.aggregate();
+    rec.mbps = r.aggregate() * size * 8 / 1000000.0;
+    rec.zmq_version = zmq_version_string();
+    rec.set("peer", opt.peer);
+    rec.set("io_threads", opt.io_threads);
+    rec.config.emplace_back("one_way_msg_per_sec", bench_output::json_number(r.one_way));
+    rec.config.emplace_back("client_to_server_msg_per_sec", bench_output::json_number(r.client_to_server));
+    rec.config.emplace_back("server_to_client_msg_per_sec", bench_output::json_number(r.server_to_client));
+    if (r.client_io_cpu >= 0) {
+        rec.config.emplace_back("client_io_cpu_pct", bench_output::json_number(r.client_io_cpu));
+    }
+    if (r.server_io_cpu >= 0 && opt.role != role::both) {
+        rec.config.emplace_back("server_io_cpu_pct", bench_output::json_number(r.server_io_cpu));
+    }
+    return rec;
+}
+
+zmq::socket_type peer_type(const options &opt) {
+    return opt.peer == "pair" ? zmq::socket_type::pair : zmq::socket_type::dealer;
+}
+
+}  // namespace
+
+void run_duplex(const options &opt) {
+    if (!opt.control.empty()) {
+        throw usage_error("duplex runs its own server (--role server), not through --control");
+    }
+    if (opt.peer == "req") {
+        throw usage_error("duplex needs a peer that can stream both ways: --peer dealer or pair");
+    }
+
+    auto server = [&](zmq::context_t &context, bool verbose) {
+        zmq::socket_t socket(context, peer_type(opt));
+        configure(socket, opt.sockopts);
+        bind_with_retry(socket, opt.endpoint);
+        if (verbose && chatty(opt)) {
+            std::cout << "Listening on " << opt.endpoint << "\n";
+            std::cout << "Message count: " << opt.count << " per direction\n";
+            std::cout << "Waiting for messages...\n";
+        }
+
+        for (size_t size : opt.sizes) {
+            serve_phase(socket, size, opt.count, false);
+            serve_phase(socket, size, opt.count, true);
+            if (verbose && chatty(opt)) {
+                std::cout << "Completed " << size << " byte messages.\n";
+            }
+        }
+    };
+
+    auto client = [&](zmq::context_t &context, bool verbose) {
+        zmq::socket_t socket(context, peer_type(opt));
+        configure(socket, opt.sockopts);
+        socket.connect(opt.endpoint);
+        if (verbose && chatty(opt)) {
+            std::cout << "Connected to " << opt.endpoint << "\n";
+            std::cout << "Message count: " << opt.count << " per direction\n";
+        }
+
+        for (size_t size : opt.sizes) {
+            phase_result one_way = run_phase(socket, size, opt.count, false);
+            phase_result duplex = run_phase(socket, size, opt.count, true);
+
+            duplex_result r;
+            r.one_way = one_way.server.msg_per_sec();
+            r.client_to_server = duplex.server.msg_per_sec();
+            r.server_to_client = duplex.client.msg_per_sec();
+            r.client_io_cpu = duplex.client.io_cpu_percent();
+            r.server_io_cpu = duplex.server.io_cpu_percent();
+            r.window_us = duplex.client.window_us;
+
+            if (opt.format == "text") {
+                print(std::cout, opt, size, r);
+            }
+            write_record(opt, duplex_record(opt, size, r));
+        }
+    };
+
+    run_roles(opt, server, client);
+}
+
+}  // namespace zmqbench
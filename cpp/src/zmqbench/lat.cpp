@@ -0,0 +1,230 @@
+/*
+ * zmqbench lat - roundtrip latency over REQ/REP.
+ *
+ * Server: REP echoes every request. Client: REQ sends one warm-up roundtrip
+ * per size, then times each roundtrip. Average latency is total time / 2N as
+ * in remote_lat; the percentiles come from the per-roundtrip samples, also
+ * halved to one-way. With --trials each trial repeats warm-up and timing.
+ * --recv buffer receives on both sides into a preallocated buffer instead of
+ * a message; --allocs counts the client process's heap allocations per
+ * roundtrip. --mechanism curve encrypts both directions (security.hpp); the
+ * handshake falls within the warm-up.
+ */
+
+#include "zmqbench/alloc_count.hpp"
+#include "zmqbench/commands.hpp"
+#include "zmqbench/control.hpp"
+#include "zmqbench/data_path.hpp"
+#include "zmqbench/report.hpp"
+#include "zmqbench/security.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace zmqbench {
+
+namespace {
+
+using clock_type = std::chrono::high_resolution_clock;
+
+template <typename Inbox>
+void check_size(size_t expected, const Inbox &message) {
+    if (message.truncated()) {
+        throw std::runtime_error("Message truncated: " + std::to_string(message.size()) +
+                                 " bytes into a " + std::to_string(expected) + " byte buffer");
+    }
+    size_t got = message.size();
+    if (got != expected) {
+        throw std::runtime_error("Message size mismatch. Expected " + std::to_string(expected) +
+                                 ", got " + std::to_string(got));
+    }
+}
+
+template <typename Inbox>
+served echo(zmq::socket_t &socket, const test_spec &spec, const std::function<void()> &primed,
+            Inbox &request) {
+    primed();
+
+    // Warm-up + measured roundtrips
+    served outcome;
+    for (int i = 0; i <= spec.message_count; i++) {
+        if (!request.recv(socket)) {
+            throw std::runtime_error("Failed to receive message " + std::to_string(i));
+        }
+        check_size(spec.message_size, request);
+
+        if (!request.send_back(socket)) {
+            throw std::runtime_error("Failed to send message " + std::to_string(i));
+        }
+        outcome.received++;
+    }
+    return outcome;
+}
+
+served serve(zmq::socket_t &socket, const test_spec &spec, const std::function<void()> &primed) {
+    if (spec.recv == "buffer") {
+        data_path::buffer_inbox request(spec.message_size);
+        return echo(socket, spec, primed, request);
+    }
+    data_path::inbox request;
+    return echo(socket, spec, primed, request);
+}
+
+template <typename Inbox>
+result measure(zmq::socket_t &socket, const std::string &transport, size_t message_size,
+               int roundtrip_count, Inbox &reply, bool count_allocs) {
+    std::vector<char> send_buf(message_size, 'X');
+    std::vector<double> samples;
+    samples.reserve(static_cast<size_t>(roundtrip_count));
+
+    auto roundtrip = [&](int i) {
+        if (!data_path::send_copy(socket, send_buf.data(), message_size)) {
+            throw std::runtime_error("Failed to send message " + std::to_string(i));
+        }
+
+        if (!reply.recv(socket)) {
+            throw std::runtime_error("Failed to receive message " + std::to_string(i));
+        }
+        check_size(message_size, reply);
+    };
+
+    // Warm-up
+    roundtrip(-1);
+
+    if (count_allocs) {
+        alloc_count::enable();
+    }
+    unsigned long long allocs_before = alloc_count::total();
+    auto start = clock_type::now();
+    auto last = start;
+    for (int i = 0; i < roundtrip_count; i++) {
+        roundtrip(i);
+        auto now = clock_type::now();
+        samples.push_back(std::chrono::duration<double, std::micro>(now - last).count() / 2.0);
+        last = now;
+    }
+    unsigned long long allocs = alloc_count::total() - allocs_before;
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(last - start).count();
+
+    result r;
+    r.command = "lat";
+    r.transport = transport;
+    r.message_size = message_size;
+    r.message_count = roundtrip_count;
+    r.elapsed_us = static_cast<double>(elapsed);
+    r.msg_per_sec = roundtrip_count * 1000000.0 / r.elapsed_us;
+    r.megabits = r.msg_per_sec * message_size * 8 / 1000000.0;
+    r.has_latency = true;
+    r.latency_us = r.elapsed_us / static_cast<double>(roundtrip_count * 2);
+    r.latency = summarize(std::move(samples));
+    if (count_allocs) {
+        r.has_allocs = true;
+        r.allocs_per_msg = static_cast<double>(allocs) / roundtrip_count;
+    }
+    return r;
+}
+
+result measure(zmq::socket_t &socket, const options &opt, const std::string &transport,
+               size_t message_size) {
+    if (opt.recv == "buffer") {
+        data_path::buffer_inbox reply(message_size);
+        return measure(socket, transport, message_size, opt.count, reply, opt.count_allocs);
+    }
+    data_path::inbox reply;
+    return measure(socket, transport, message_size, opt.count, reply, opt.count_allocs);
+}
+
+}  // namespace
+
+const session lat_session = {zmq::socket_type::rep, serve};
+
+void run_lat(const options &opt) {
+    check_control_role(opt);
+    std::string transport = transport_of(opt.endpoint);
+    security_setup security = resolve_security(opt);
+
+    auto server = [&](zmq::context_t &context, bool verbose) {
+        std::unique_ptr<zap_handler> zap;
+        if (security.zap) {
+            zap = std::make_unique<zap_handler>(context);
+        }
+        zmq::socket_t socket(context, zmq::socket_type::rep);
+        configure(socket, opt.sockopts);
+        secure_server(socket, security.mechanism, security.server_keys, security.zap);
+        bind_with_retry(socket, opt.endpoint);
+        if (verbose && chatty(opt)) {
+            // Flushed: scripts wait for this line before starting the client
+            std::cout << "Listening on " << opt.endpoint << std::endl;
+            if (security.mechanism == "curve") {
+                // Flushed now: a client in another process needs it to connect
+                std::cout << "CURVE server key: " << security.server_keys.public_key << std::endl;
+            }
+            std::cout << "Roundtrip count: " << opt.count << "\n";
+            std::cout << "Waiting for messages...\n";
+        }
+
+        for (size_t size : opt.sizes) {
+            for (int t = 0; t < opt.trials; t++) {
+                serve(socket, spec_for(opt, size), [] {});
+            }
+            if (verbose && chatty(opt)) {
+                std::cout << "Completed " << opt.count << " roundtrips of " << size << " bytes.\n";
+            }
+        }
+    };
+
+    auto client = [&](zmq::context_t &context, bool verbose) {
+        std::unique_ptr<control_client> control;
+        if (!opt.control.empty()) {
+            control = std::make_unique<control_client>(context, opt.control);
+        }
+
+        // Connected after the first "ready" so a persistent server is
+        // already bound and no reconnect interval is lost
+        zmq::socket_t socket;
+        std::string server_key = security.server_key;
+        for (size_t size : opt.sizes) {
+            auto trial = [&]() {
+                if (control) {
+                    control_message ready = control->prepare(spec_for(opt, size));
+                    if (security.mechanism == "curve") {
+                        server_key = ready.get("curve_serverkey");
+                    }
+                }
+                if (socket.handle() == nullptr) {
+                    socket = zmq::socket_t(context, zmq::socket_type::req);
+                    configure(socket, opt.sockopts);
+                    secure_client(socket, security.mechanism, server_key, security.client_keys);
+                    socket.connect(opt.endpoint);
+                    if (verbose && chatty(opt)) {
+                        std::cout << "Connected to " << opt.endpoint << "\n";
+                        std::cout << "Roundtrip count: " << opt.count << "\n";
+                    }
+                }
+                if (control) {
+                    control->start();
+                }
+
+                result r = measure(socket, opt, transport, size);
+
+                if (control) {
+                    served outcome = control->finish();
+                    if (outcome.received != opt.count + 1) {
+                        throw std::runtime_error("Server echoed " + std::to_string(outcome.received) +
+                                                 " messages, expected " + std::to_string(opt.count + 1));
+                    }
+                }
+                return r;
+            };
+            report(opt, repeat_trials(opt, trial));
+        }
+    };
+
+    run_roles(opt, server, client);
+}
+
+}  // namespace zmqbench
@@ -0,0 +1,34 @@
+/*
+ * zmqbench - single-binary ZeroMQ benchmark harness
+ *
+ * One executable for every test: pick a command, then run the server side,
+ * the client side, or both in one process. Sizes given as a list are run in
+ * turn over the same sockets, so a sweep needs no process restarts.
+ *
+ * Usage: ./zmqbench <command> [options]
+ * Example: ./zmqbench thr --size 64,1500,65536 --count 1000000
+ */
+
+#include "zmqbench/commands.hpp"
+#include "zmqbench/options.hpp"
+
+#include <iostream>
+#include <string>
+
+int main(int argc, char *argv[]) {
+    if (argc >= 2 && (std::string(argv[1]) == "--help" || std::string(argv[1]) == "-h")) {
+        zmqbench::print_usage(std::cout, argv[0]);
+        return 0;
+    }
+
+    zmqbench::options opt;
+    try {
+        opt = zmqbench::parse_options(argc, argv);
+    } catch (const zmqbench::usage_error &e) {
+        std::cerr << "Error: " << e.what() << "\n\n";
+        zmqbench::print_usage(std::cerr, argv[0]);
+        return 1;
+    }
+
+    return zmqbench::run(opt);
+}
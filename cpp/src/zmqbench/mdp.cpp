@@ -0,0 +1,672 @@
+/*
+ * zmqbench mdp - RPC through a Majordomo (MDP 0.2) service broker.
+ *
+ * A reference broker, worker and client after the ZeroMQ guide's Majordomo
+ * pattern, all on one ROUTER that clients and workers connect to:
+ *
+ *   client (DEALER)  "" MDPC01 service body            -> broker
+ *   broker -> worker "" MDPW01 REQUEST client "" body
+ *   worker (DEALER)  "" MDPW01 REPLY client "" body    -> broker
+ *   broker -> client "" MDPC01 service body
+ *
+ * Workers register with READY for one service and are handed requests least
+ * recently used first; requests for a service with no idle worker wait in the
+ * broker. Broker and idle workers exchange HEARTBEATs every --heartbeat ms, a
+ * worker silent for three intervals is dropped, and a worker that hears
+ * nothing from the broker for three intervals reconnects.
+ *
+ * Each run starts --workers echo workers spread round-robin over --services
+ * services ("echo-0", ...), waits until all have registered, then lets
+ * --threads clients loose, each with one request in flight and its requests
+ * spread over the services. After a warm-up request per service, the window
+ * runs until the last client has made its share of --count requests. Every
+ * combination of the three lists is run, except those with fewer workers than
+ * services. Broker CPU is the broker thread's CPU time over the window, as a
+ * percentage of one core (Linux): near 100% the broker is the limit.
+ *
+ * Everything is one process; RPC latency is the full request -> reply time.
+ */
+
+#include "zmqbench/commands.hpp"
+#include "zmqbench/report.hpp"
+#include "zmqbench/stats.hpp"
+
+#include <zmq.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <time.h>
+#endif
+
+namespace zmqbench {
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+const char *const client_header = "MDPC01";
+const char *const worker_header = "MDPW01";
+
+// Worker commands, one byte each
+const char cmd_ready = '\x01';
+const char cmd_request = '\x02';
+const char cmd_reply = '\x03';
+const char cmd_heartbeat = '\x04';
+const char cmd_disconnect = '\x05';
+
+// Heartbeats a peer may miss before it is given up on
+const int liveness = 3;
+
+std::string service_name(size_t index) { return "echo-" + std::to_string(index); }
+
+// ROUTER_MANDATORY send; false (and msg intact) when the peer is gone
+bool deliver(zmq::socket_t &socket, frames &msg) {
+    try {
+        send_frames(socket, msg);
+        return true;
+    } catch (const zmq::error_t &e) {
+        if (e.num() != EHOSTUNREACH) {
+            throw;
+        }
+        return false;
+    }
+}
+
+zmq::message_t frame(const std::string &text) { return zmq::message_t(text.data(), text.size()); }
+zmq::message_t frame(char command) { return zmq::message_t(&command, 1); }
+
+// Thread CPU time of the calling thread, readable from other threads; -1
+// where unsupported
+class cpu_clock {
+public:
+    cpu_clock() {
+#ifdef __linux__
+        valid_ = pthread_getcpuclockid(pthread_self(), &id_) == 0;
+#endif
+    }
+
+    long long now_ns() const {
+#ifdef __linux__
+        timespec ts;
+        if (valid_ && clock_gettime(id_, &ts) == 0) {
+            return static_cast<long long>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+        }
+#endif
+        return -1;
+    }
+
+private:
+#ifdef __linux__
+    clockid_t id_ = 0;
+#endif
+    bool valid_ = false;
+};
+
+struct broker_counters {
+    long long requests = 0;
+    long long heartbeats_sent = 0;
+    long long heartbeats_received = 0;
+    long long expired = 0;
+};
+
+// The broker: one ROUTER for clients and workers
+class broker {
+public:
+    broker(zmq::context_t &context, const std::string &endpoint, std::chrono::milliseconds heartbeat)
+        : socket_(context, zmq::socket_type::router), heartbeat_(heartbeat) {
+        socket_.set(zmq::sockopt::router_mandatory, true);
+        bind_with_retry(socket_, endpoint);
+    }
+
+    // Runs until the context shuts down
+    void run() {
+        cpu_ = cpu_clock();
+        running_ = true;
+        auto heartbeat_at = clock_type::now() + heartbeat_;
+        while (true) {
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(heartbeat_at -
+                                                                            clock_type::now());
+            zmq_pollitem_t item = {socket_.handle(), 0, ZMQ_POLLIN, 0};
+            if (zmq_poll(&item, 1, std::max<long>(0, static_cast<long>(wait.count()))) < 0) {
+                throw zmq::error_t();
+            }
+            // Everything waiting, without going back to zmq_poll in between
+            while (item.revents & ZMQ_POLLIN) {
+                zmq::message_t first;
+                if (!socket_.recv(first, zmq::recv_flags::dontwait)) {
+                    break;
+                }
+                frames msg;
+                msg.push_back(std::move(first));
+                while (msg.back().more()) {
+                    msg.emplace_back();
+                    (void)socket_.recv(msg.back(), zmq::recv_flags::none);
+                }
+                route(msg);
+            }
+            if (clock_type::now() >= heartbeat_at) {
+                beat();
+                heartbeat_at += heartbeat_;
+            }
+        }
+    }
+
+    int registered() const { return registered_.load(); }
+
+    // The broker thread's CPU clock, once running() is true
+    bool running() const { return running_.load(); }
+    const cpu_clock &cpu() const { return cpu_; }
+
+    // Valid once the broker thread has returned
+    const broker_counters &counters() const { return counters_; }
+
+private:
+    struct worker_entry {
+        std::string service;
+        clock_type::time_point expiry;
+    };
+
+    struct service_entry {
+        std::deque<frames> requests;      // client id, body...
+        std::deque<std::string> waiting;  // idle workers, least recently used first
+    };
+
+    void route(frames &msg) {
+        if (msg.size() < 4 || msg[1].size() != 0) {
+            return;  // not MDP; dropped as the reference broker does
+        }
+        std::string sender = msg[0].to_string();
+        std::string header = msg[2].to_string();
+        if (header == client_header) {
+            client_request(sender, msg);
+        } else if (header == worker_header) {
+            worker_message(sender, msg);
+        }
+    }
+
+    // sender "" MDPC01 service body...
+    void client_request(const std::string &sender, frames &msg) {
+        service_entry &service = services_[msg[3].to_string()];
+        frames request;
+        request.push_back(frame(sender));
+        for (size_t i = 4; i < msg.size(); i++) {
+            request.push_back(std::move(msg[i]));
+        }
+        service.requests.push_back(std::move(request));
+        counters_.requests++;
+        dispatch(service);
+    }
+
+    // sender "" MDPW01 command ...
+    void worker_message(const std::string &sender, frames &msg) {
+        if (msg[3].size() != 1) {
+            return;
+        }
+        char command = *msg[3].data<char>();
+        auto known = workers_.find(sender);
+
+        if (command == cmd_ready) {
+            if (known != workers_.end() || msg.size() < 5) {
+                // READY twice is a protocol error
+                disconnect(sender);
+                return;
+            }
+            std::string service = msg[4].to_string();
+            workers_[sender] = worker_entry{service, clock_type::now() + liveness * heartbeat_};
+            registered_++;
+            idle(sender, service);
+            return;
+        }
+        if (known == workers_.end()) {
+            if (command != cmd_disconnect) {
+                disconnect(sender);
+            }
+            return;
+        }
+        known->second.expiry = clock_type::now() + liveness * heartbeat_;
+
+        if (command == cmd_reply && msg.size() >= 6) {
+            // sender "" MDPW01 REPLY client "" body... -> client "" MDPC01 service body...
+            frames reply;
+            reply.push_back(std::move(msg[4]));
+            reply.push_back(zmq::message_t());
+            reply.push_back(frame(client_header));
+            reply.push_back(frame(known->second.service));
+            for (size_t i = 6; i < msg.size(); i++) {
+                reply.push_back(std::move(msg[i]));
+            }
+            // A client that has gone away just loses its reply
+            (void)deliver(socket_, reply);
+            idle(sender, known->second.service);
+        } else if (command == cmd_heartbeat) {
+            counters_.heartbeats_received++;
+        } else if (command == cmd_disconnect) {
+            forget(sender);
+        }
+    }
+
+    void idle(const std::string &worker, const std::string &service) {
+        service_entry &entry = services_[service];
+        entry.waiting.push_back(worker);
+        dispatch(entry);
+    }
+
+    void dispatch(service_entry &service) {
+        while (!service.requests.empty() && !service.waiting.empty()) {
+            std::string worker = service.waiting.front();
+            service.waiting.pop_front();
+            frames &request = service.requests.front();
+
+            // worker "" MDPW01 REQUEST client "" body...
+            frames out;
+            out.push_back(frame(worker));
+            out.push_back(zmq::message_t());
+            out.push_back(frame(worker_header));
+            out.push_back(frame(cmd_request));
+            out.push_back(std::move(request[0]));
+            out.push_back(zmq::message_t());
+            for (size_t i = 1; i < request.size(); i++) {
+                out.push_back(std::move(request[i]));
+            }
+            if (!deliver(socket_, out)) {
+                // The worker vanished without a word: requeue the request
+                request[0] = std::move(out[4]);
+                for (size_t i = 1; i < request.size(); i++) {
+                    request[i] = std::move(out[5 + i]);
+                }
+                forget(worker);
+                continue;
+            }
+            service.requests.pop_front();
+        }
+    }
+
+    // Heartbeats idle workers and drops the ones that went silent
+    void beat() {
+        auto now = clock_type::now();
+        for (auto &entry : services_) {
+            std::deque<std::string> alive;
+            for (const std::string &worker : entry.second.waiting) {
+                if (workers_.at(worker).expiry < now) {
+                    workers_.erase(worker);
+                    counters_.expired++;
+                    continue;
+                }
+                if (!send_command(worker, cmd_heartbeat)) {
+                    workers_.erase(worker);
+                    continue;
+                }
+                counters_.heartbeats_sent++;
+                alive.push_back(worker);
+            }
+            entry.second.waiting.swap(alive);
+        }
+    }
+
+    bool send_command(const std::string &worker, char command) {
+        frames out;
+        out.push_back(frame(worker));
+        out.push_back(zmq::message_t());
+        out.push_back(frame(worker_header));
+        out.push_back(frame(command));
+        return deliver(socket_, out);
+    }
+
+    void disconnect(const std::string &worker) {
+        (void)send_command(worker, cmd_disconnect);
+        forget(worker);
+    }
+
+    void forget(const std::string &worker) {
+        auto known = workers_.find(worker);
+        if (known == workers_.end()) {
+            return;
+        }
+        std::deque<std::string> &waiting = services_[known->second.service].waiting;
+        waiting.erase(std::remove(waiting.begin(), waiting.end(), worker), waiting.end());
+        workers_.erase(known);
+    }
+
+    zmq::socket_t socket_;
+    std::chrono::milliseconds heartbeat_;
+    std::map<std::string, service_entry> services_;
+    std::map<std::string, worker_entry> workers_;
+    broker_counters counters_;
+    std::atomic<int> registered_{0};
+    cpu_clock cpu_;
+    std::atomic<bool> running_{false};
+};
+
+// An echo worker for one service; runs until the context shuts down,
+// counting its reconnects
+void run_worker(zmq::context_t &context, const std::string &endpoint, const std::string &service,
+                std::chrono::milliseconds heartbeat, std::atomic<long long> &reconnects) {
+    zmq::socket_t socket;
+    auto connect = [&]() {
+        socket = zmq::socket_t(context, zmq::socket_type::dealer);
+        socket.set(zmq::sockopt::linger, 0);
+        socket.connect(endpoint);
+        frames ready;
+        ready.push_back(zmq::message_t());
+        ready.push_back(frame(worker_header));
+        ready.push_back(frame(cmd_ready));
+        ready.push_back(frame(service));
+        send_frames(socket, ready);
+    };
+    connect();
+
+    int broker_liveness = liveness;
+    auto heartbeat_at = clock_type::now() + heartbeat;
+    while (true) {
+        zmq_pollitem_t item = {socket.handle(), 0, ZMQ_POLLIN, 0};
+        if (zmq_poll(&item, 1, static_cast<long>(heartbeat.count())) < 0) {
+            throw zmq::error_t();
+        }
+        if (item.revents & ZMQ_POLLIN) {
+            frames msg = recv_frames(socket);
+            broker_liveness = liveness;
+            if (msg.size() < 3 || msg[2].size() != 1) {
+                continue;
+            }
+            char command = *msg[2].data<char>();
+            if (command == cmd_request && msg.size() >= 6) {
+                // "" MDPW01 REQUEST client "" body... -> "" MDPW01 REPLY client "" body...
+                msg[2] = frame(cmd_reply);
+                send_frames(socket, msg);
+            } else if (command == cmd_disconnect) {
+                reconnects++;
+                connect();
+            }
+        } else if (--broker_liveness == 0) {
+            reconnects++;
+            connect();
+            broker_liveness = liveness;
+        }
+        if (clock_type::now() >= heartbeat_at) {
+            frames beat;
+            beat.push_back(zmq::message_t());
+            beat.push_back(frame(worker_header));
+            beat.push_back(frame(cmd_heartbeat));
+            send_frames(socket, beat);
+            heartbeat_at = clock_type::now() + heartbeat;
+        }
+    }
+}
+
+// Blocks until every client is ready, then releases them together
+class start_line {
+public:
+    explicit start_line(int parties) : waiting_(parties) {}
+
+    void arrive_and_wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (--waiting_ == 0) {
+            start_ = clock_type::now();
+            released_.notify_all();
+            return;
+        }
+        released_.wait(lock, [this]() { return waiting_ == 0; });
+    }
+
+    clock_type::time_point start() const { return start_; }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable released_;
+    int waiting_;
+    clock_type::time_point start_;
+};
+
+// One synchronous MDP client: one request in flight
+class client {
+public:
+    client(zmq::context_t &context, const std::string &endpoint)
+        : socket_(context, zmq::socket_type::dealer) {
+        socket_.set(zmq::sockopt::linger, 0);
+        socket_.connect(endpoint);
+    }
+
+    void call(const std::string &service, const std::vector<char> &body) {
+        frames request;
+        request.push_back(zmq::message_t());
+        request.push_back(frame(client_header));
+        request.push_back(frame(service));
+        request.push_back(zmq::message_t(body.data(), body.size()));
+        send_frames(socket_, request);
+
+        // "" MDPC01 service body
+        frames reply = recv_frames(socket_);
+        if (reply.size() != 4 || reply[3].size() != body.size() || reply[2].to_string() != service) {
+            throw std::runtime_error("Unexpected reply from the broker for service " + service);
+        }
+    }
+
+private:
+    zmq::socket_t socket_;
+};
+
+struct run_config {
+    size_t workers = 0;
+    size_t services = 0;
+    size_t heartbeat_ms = 0;
+};
+
+struct mdp_result {
+    run_config config;
+    size_t size = 0;
+    long long rpcs = 0;
+    double elapsed_us = 0.0;
+    latency_summary latency;  // request -> reply, us
+    broker_counters counters;
+    long long reconnects = 0;
+    double broker_cpu = -1.0;  // percent of one core over the window
+
+    double rpc_per_sec() const { return rpcs / (elapsed_us / 1000000.0); }
+};
+
+mdp_result run_once(const options &opt, const run_config &config, size_t size) {
+    std::chrono::milliseconds heartbeat(config.heartbeat_ms);
+    int clients = opt.client_threads;
+    int per_client = std::max(1, opt.count / clients);
+
+    zmq::context_t context(opt.io_threads);
+    broker hub(context, opt.endpoint, heartbeat);
+
+    first_error errors(context);
+
+    std::vector<std::thread> threads;
+    threads.emplace_back(errors.guarded([&]() { hub.run(); }));
+    std::atomic<long long> reconnects{0};
+    for (size_t w = 0; w < config.workers; w++) {
+        threads.emplace_back(errors.guarded([&, w]() {
+            run_worker(context, opt.endpoint, service_name(w % config.services), heartbeat, reconnects);
+        }));
+    }
+
+    // Every worker registered, or give up after a few heartbeats' worth
+    auto deadline = clock_type::now() + std::chrono::seconds(5) + liveness * heartbeat;
+    while (hub.registered() < static_cast<int>(config.workers) && clock_type::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::vector<std::vector<double>> samples(static_cast<size_t>(clients));
+    start_line line(clients);
+    std::atomic<int> finished{0};
+    clock_type::time_point end;
+    std::mutex end_lock;
+    std::vector<std::thread> client_threads;
+    if (hub.registered() == static_cast<int>(config.workers)) {
+        for (int c = 0; c < clients; c++) {
+            client_threads.emplace_back(errors.guarded([&, c]() {
+                client rpc(context, opt.endpoint);
+                std::vector<char> body(size, 'X');
+                for (size_t s = 0; s < config.services; s++) {
+                    rpc.call(service_name(s), body);
+                }
+                std::vector<double> &mine = samples[static_cast<size_t>(c)];
+                mine.reserve(static_cast<size_t>(per_client));
+                line.arrive_and_wait();
+                for (int i = 0; i < per_client; i++) {
+                    auto sent = clock_type::now();
+                    rpc.call(service_name((static_cast<size_t>(c) + i) % config.services), body);
+                    mine.push_back(std::chrono::duration<double, std::micro>(clock_type::now() - sent).count());
+                }
+                if (++finished == clients) {
+                    std::lock_guard<std::mutex> lock(end_lock);
+                    end = clock_type::now();
+                }
+            }));
+        }
+    }
+
+    // The broker's CPU clock is set as soon as its thread runs
+    while (!hub.running()) {
+        std::this_thread::yield();
+    }
+    long long cpu_before = hub.cpu().now_ns();
+    for (std::thread &thread : client_threads) {
+        thread.join();
+    }
+    long long cpu_after = hub.cpu().now_ns();
+    bool timed_out = client_threads.empty();
+    context.shutdown();
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    errors.rethrow();
+    if (timed_out) {
+        throw std::runtime_error("Only " + std::to_string(hub.registered()) + " of " +
+                                 std::to_string(config.workers) + " workers registered with the broker");
+    }
+
+    mdp_result r;
+    r.config = config;
+    r.size = size;
+    r.rpcs = static_cast<long long>(per_client) * clients;
+    r.elapsed_us = std::chrono::duration<double, std::micro>(end - line.start()).count();
+    std::vector<double> all;
+    for (const std::vector<double> &mine : samples) {
+        all.insert(all.end(), mine.begin(), mine.end());
+    }
+    r.latency = summarize(all);
+    r.counters = hub.counters();
+    r.reconnects = reconnects.load();
+    if (cpu_before >= 0 && cpu_after >= 0) {
+        // The window ends with the last client; the join adds a few us at most
+        r.broker_cpu = 100.0 * ((cpu_after - cpu_before) / 1000.0) / r.elapsed_us;
+    }
+    return r;
+}
+
+void print(std::ostream &out, const options &opt, size_t size, const std::vector<mdp_result> &rows) {
+    out << "\n=== Majordomo Broker Results ===\n";
+    out << "Message size: " << size << " bytes\n";
+    out << "Clients: " << opt.client_threads << " (one request in flight each)\n";
+    out << std::setw(8) << "Workers" << std::setw(10) << "Services" << std::setw(16) << "Heartbeat (ms)"
+        << std::setw(12) << "RPC/s" << std::setw(11) << "p50 (us)" << std::setw(11) << "p99 (us)"
+        << std::setw(13) << "p99.9 (us)" << std::setw(13) << "Broker CPU" << std::setw(12)
+        << "Heartbeats" << "\n";
+    out << std::fixed;
+    for (const mdp_result &r : rows) {
+        std::ostringstream cpu;
+        if (r.broker_cpu < 0) {
+            cpu << "n/a";
+        } else {
+            cpu << std::fixed << std::setprecision(1) << r.broker_cpu << "%";
+        }
+        out << std::setw(8) << r.config.workers << std::setw(10) << r.config.services << std::setw(16)
+            << r.config.heartbeat_ms << std::setw(12) << std::setprecision(0) << r.rpc_per_sec()
+            << std::setprecision(2) << std::setw(11) << r.latency.p50 << std::setw(11) << r.latency.p99
+            << std::setw(13) << r.latency.p999 << std::setw(13) << cpu.str() << std::setw(12)
+            << r.counters.heartbeats_sent + r.counters.heartbeats_received << "\n";
+    }
+    out << std::defaultfloat << std::setprecision(6);
+    out << "RPC latency is the full request -> reply time through the broker\n";
+    for (const mdp_result &r : rows) {
+        if (r.counters.expired > 0 || r.reconnects > 0) {
+            out << "Warning: " << r.config.workers << " workers / " << r.config.services
+                << " services / " << r.config.heartbeat_ms << " ms: " << r.counters.expired
+                << " workers expired, " << r.reconnects << " reconnects\n";
+        }
+    }
+}
+
+bench_output::record mdp_record(const options &opt, const mdp_result &r) {
+    result as_result;
+    as_result.command = "mdp";
+    as_result.transport = transport_of(opt.endpoint);
+    as_result.message_size = r.size;
+    as_result.message_count = static_cast<int>(r.rpcs);
+    as_result.elapsed_us = r.elapsed_us;
+    as_result.has_latency = true;
+    as_result.latency_us = r.latency.mean;
+    as_result.latency = r.latency;
+
+    bench_output::record rec = to_record(as_result, opt);
+    rec.msg_per_sec = r.rpc_per_sec();
+    rec.set("workers", static_cast<int>(r.config.workers));
+    rec.set("services", static_cast<int>(r.config.services));
+    rec.set("heartbeat_ms", static_cast<int>(r.config.heartbeat_ms));
+    rec.set("clients", opt.client_threads);
+    rec.config.emplace_back("heartbeats", bench_output::json_number(static_cast<double>(
+                                              r.counters.heartbeats_sent + r.counters.heartbeats_received)));
+    rec.config.emplace_back("expired_workers", bench_output::json_number(static_cast<double>(r.counters.expired)));
+    if (r.broker_cpu >= 0) {
+        rec.config.emplace_back("broker_cpu_pct", bench_output::json_number(r.broker_cpu));
+    }
+    return rec;
+}
+
+}  // namespace
+
+void run_mdp(const options &opt) {
+    if (opt.role != role::both || !opt.control.empty()) {
+        throw usage_error("mdp runs broker, workers and clients in one process (no --role or --control)");
+    }
+    std::vector<size_t> worker_counts = opt.workers.empty() ? std::vector<size_t>{1, 4, 16} : opt.workers;
+    std::vector<size_t> heartbeats = opt.heartbeat_ms.empty() ? std::vector<size_t>{2500} : opt.heartbeat_ms;
+
+    for (size_t size : opt.sizes) {
+        std::vector<mdp_result> rows;
+        for (size_t heartbeat : heartbeats) {
+            for (size_t services : opt.mdp_services) {
+                for (size_t workers : worker_counts) {
+                    if (workers < services) {
+                        if (chatty(opt)) {
+                            std::cout << "Skipping " << workers << " workers for " << services
+                                      << " services (every service needs one)\n";
+                        }
+                        continue;
+                    }
+                    if (chatty(opt)) {
+                        std::cout << "Running " << workers << " workers, " << services << " services, "
+                                  << heartbeat << " ms heartbeat with " << size << " byte messages...\n";
+                    }
+                    mdp_result r = run_once(opt, run_config{workers, services, heartbeat}, size);
+                    write_record(opt, mdp_record(opt, r));
+                    rows.push_back(r);
+                }
+            }
+        }
+        if (opt.format == "text") {
+            print(std::cout, opt, size, rows);
+        }
+    }
+}
+
+}  // namespace zmqbench
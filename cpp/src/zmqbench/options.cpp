@@ -0,0 +1,408 @@
+#include "zmqbench/options.hpp"
+#include "zmqbench/alloc_count.hpp"
+#include "zmqbench/commands.hpp"
+#include "zmqbench/security.hpp"
+#include "bench_output.hpp"
+
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+namespace zmqbench {
+
+namespace {
+
+int parse_non_negative(const std::string &name, const std::string &value) {
+    int n = std::atoi(value.c_str());
+    if (n < 0 || (n == 0 && value != "0")) {
+        throw usage_error(name + " must be zero or positive, got '" + value + "'");
+    }
+    return n;
+}
+
+int parse_positive(const std::string &name, const std::string &value) {
+    int n = std::atoi(value.c_str());
+    if (n <= 0) {
+        throw usage_error(name + " must be positive, got '" + value + "'");
+    }
+    return n;
+}
+
+// Fractional values allowed, e.g. 0.5 us of work
+double parse_non_negative_real(const std::string &name, const std::string &value) {
+    char *end = nullptr;
+    double x = std::strtod(value.c_str(), &end);
+    if (value.empty() || *end != '\0' || !(x >= 0.0)) {
+        throw usage_error(name + " must be zero or positive, got '" + value + "'");
+    }
+    return x;
+}
+
+double parse_percent(const std::string &name, const std::string &value) {
+    double pct = std::atof(value.c_str());
+    if (pct < 0.0 || pct > 100.0 || (pct == 0.0 && value.find_first_not_of("0.") != std::string::npos)) {
+        throw usage_error(name + " must be a percentage from 0 to 100, got '" + value + "'");
+    }
+    return pct;
+}
+
+std::vector<size_t> parse_sizes(const std::string &name, const std::string &value) {
+    std::vector<size_t> sizes;
+    std::stringstream list(value);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        sizes.push_back(static_cast<size_t>(parse_positive(name, item)));
+    }
+    if (sizes.empty()) {
+        throw usage_error(name + " needs at least one value");
+    }
+    return sizes;
+}
+
+std::vector<std::string> parse_names(const std::string &name, const std::string &value) {
+    std::vector<std::string> names;
+    std::stringstream list(value);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        names.push_back(item);
+    }
+    if (names.empty()) {
+        throw usage_error(name + " needs at least one value");
+    }
+    return names;
+}
+
+std::vector<std::string> parse_mechanisms(const std::string &name, const std::string &value) {
+    std::vector<std::string> mechanisms;
+    std::stringstream list(value);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        if (item != "null" && item != "plain" && item != "curve") {
+            throw usage_error(name + " must be null, plain or curve, got '" + item + "'");
+        }
+        if (item == "curve" && !curve_available()) {
+            throw usage_error("curve needs a libzmq built with CURVE support (libsodium)");
+        }
+        mechanisms.push_back(item);
+    }
+    if (mechanisms.empty()) {
+        throw usage_error(name + " needs at least one value");
+    }
+    return mechanisms;
+}
+
+role parse_role(const std::string &value) {
+    if (value == "server") {
+        return role::server;
+    }
+    if (value == "client") {
+        return role::client;
+    }
+    if (value == "both") {
+        return role::both;
+    }
+    throw usage_error("unknown role '" + value + "' (expected server, client or both)");
+}
+
+}  // namespace
+
+void parse_arguments(options &opt, const std::vector<std::string> &args) {
+    for (size_t i = 0; i < args.size(); i++) {
+        const std::string &arg = args[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= args.size()) {
+                throw usage_error(arg + " needs a value");
+            }
+            return args[++i];
+        };
+
+        if (arg == "--role" || arg == "-r") {
+            opt.role = parse_role(value());
+        } else if (arg == "--endpoint" || arg == "-e") {
+            opt.endpoint = value();
+        } else if (arg == "--size" || arg == "-s") {
+            opt.sizes = parse_sizes(arg, value());
+        } else if (arg == "--count" || arg == "-n") {
+            opt.count = parse_positive(arg, value());
+        } else if (arg == "--io-threads") {
+            opt.io_threads = parse_positive(arg, value());
+        } else if (arg == "--control" || arg == "-c") {
+            opt.control = value();
+        } else if (arg == "--format" || arg == "-f") {
+            opt.format = value();
+            if (opt.format != "text" && opt.format != "json" && opt.format != "csv") {
+                throw usage_error("unknown format '" + opt.format + "' (expected text, json or csv)");
+            }
+        } else if (arg == "--output" || arg == "-o") {
+            opt.output = value();
+        } else if (arg == "--trials") {
+            opt.trials = parse_positive(arg, value());
+        } else if (arg == "--target-ci") {
+            std::string text = value();
+            opt.target_ci = std::atof(text.c_str());
+            if (opt.target_ci <= 0.0) {
+                throw usage_error("--target-ci must be a positive percentage, got '" + text + "'");
+            }
+        } else if (arg == "--max-trials") {
+            opt.max_trials = parse_positive(arg, value());
+        } else if (arg == "--recv") {
+            opt.recv = value();
+            if (opt.recv != "message" && opt.recv != "buffer") {
+                throw usage_error("--recv must be message or buffer, got '" + opt.recv + "'");
+            }
+        } else if (arg == "--allocs") {
+            opt.count_allocs = true;
+        } else if (arg == "--sockets") {
+            opt.sockets = parse_sizes(arg, value());
+        } else if (arg == "--active") {
+            opt.active = parse_positive(arg, value());
+        } else if (arg == "--poller") {
+            opt.poller = value();
+            if (opt.poller != "all" && opt.poller != "zmq_poll" && opt.poller != "poller_t" &&
+                opt.poller != "active_poller_t") {
+                throw usage_error("--poller must be all, zmq_poll, poller_t or active_poller_t, got '" +
+                                  opt.poller + "'");
+            }
+        } else if (arg == "--threads") {
+            opt.client_threads = parse_positive(arg, value());
+        } else if (arg == "--peer") {
+            opt.peer = value();
+            if (opt.peer != "dealer" && opt.peer != "req" && opt.peer != "pair") {
+                throw usage_error("--peer must be dealer, req or pair, got '" + opt.peer + "'");
+            }
+        } else if (arg == "--pattern") {
+            opt.patterns = parse_names(arg, value());
+        } else if (arg == "--via") {
+            opt.via = parse_names(arg, value());
+            for (const std::string &via : opt.via) {
+                if (via != "proxy" && via != "steerable" && via != "batch") {
+                    throw usage_error("--via must be proxy, steerable or batch, got '" + via + "'");
+                }
+            }
+        } else if (arg == "--capture") {
+            opt.capture = true;
+        } else if (arg == "--batch") {
+            opt.batch = parse_positive(arg, value());
+        } else if (arg == "--busy-poll") {
+            opt.busy_poll = true;
+        } else if (arg == "--proxy-cpu") {
+            opt.proxy_cpu = parse_non_negative(arg, value());
+        } else if (arg == "--stages") {
+            opt.chain_stages = parse_sizes(arg, value());
+        } else if (arg == "--stage") {
+            opt.chain_stage = parse_positive(arg, value());
+        } else if (arg == "--stage-work") {
+            opt.stage_work.clear();
+            for (const std::string &work : parse_names(arg, value())) {
+                opt.stage_work.push_back(parse_non_negative_real(arg, work));
+            }
+        } else if (arg == "--workers") {
+            opt.workers = parse_sizes(arg, value());
+        } else if (arg == "--services") {
+            opt.mdp_services = parse_sizes(arg, value());
+        } else if (arg == "--heartbeat") {
+            opt.heartbeat_ms = parse_sizes(arg, value());
+        } else if (arg == "--pirate") {
+            opt.pirate_modes = parse_names(arg, value());
+            for (const std::string &mode : opt.pirate_modes) {
+                if (mode != "lazy" && mode != "paranoid") {
+                    throw usage_error("--pirate must be lazy or paranoid, got '" + mode + "'");
+                }
+            }
+        } else if (arg == "--timeout") {
+            opt.timeouts = parse_sizes(arg, value());
+        } else if (arg == "--retries") {
+            opt.retries = parse_non_negative(arg, value());
+        } else if (arg == "--drop") {
+            opt.drop_pct = parse_percent(arg, value());
+        } else if (arg == "--delay") {
+            opt.delay_pct = parse_percent(arg, value());
+        } else if (arg == "--delay-ms") {
+            opt.delay_ms = parse_non_negative(arg, value());
+        } else if (arg == "--fanout") {
+            opt.fanouts = parse_sizes(arg, value());
+        } else if (arg == "--gather") {
+            opt.gathers = parse_names(arg, value());
+            for (const std::string &gather : opt.gathers) {
+                if (gather != "router" && gather != "dealer") {
+                    throw usage_error("--gather must be router or dealer, got '" + gather + "'");
+                }
+            }
+        } else if (arg == "--service-time") {
+            opt.service_time = value();
+        } else if (arg == "--mechanism") {
+            opt.mechanisms = parse_mechanisms(arg, value());
+        } else if (arg == "--zap") {
+            opt.zap = value();
+            if (opt.zap != "off" && opt.zap != "on" && opt.zap != "both") {
+                throw usage_error("--zap must be off, on or both, got '" + opt.zap + "'");
+            }
+        } else if (arg == "--curve-serverkey") {
+            opt.curve_serverkey = value();
+            if (opt.curve_serverkey.size() != 40) {
+                throw usage_error("--curve-serverkey must be a 40-character Z85 key");
+            }
+        } else if (arg == "--sndhwm") {
+            opt.sockopts.sndhwm = parse_non_negative(arg, value());
+        } else if (arg == "--rcvhwm") {
+            opt.sockopts.rcvhwm = parse_non_negative(arg, value());
+        } else if (arg == "--sndbuf") {
+            opt.sockopts.sndbuf = parse_positive(arg, value());
+        } else if (arg == "--rcvbuf") {
+            opt.sockopts.rcvbuf = parse_positive(arg, value());
+        } else if (arg == "--test") {
+            opt.ab_test = value();
+            if (opt.ab_test != "lat" && opt.ab_test != "thr") {
+                throw usage_error("--test must be lat or thr, got '" + opt.ab_test + "'");
+            }
+        } else if (arg == "--a") {
+            opt.variant_a = value();
+        } else if (arg == "--b") {
+            opt.variant_b = value();
+        } else if (arg == "--pairs") {
+            opt.pairs = parse_positive(arg, value());
+        } else {
+            throw usage_error("unknown option '" + arg + "'");
+        }
+    }
+}
+
+options parse_options(int argc, char *argv[]) {
+    if (argc < 2) {
+        throw usage_error("missing command");
+    }
+
+    options opt;
+    opt.command = argv[1];
+    opt.output = bench_output::output_path_from_env();
+    if (find_command(opt.command) == nullptr) {
+        throw usage_error("unknown command '" + opt.command + "'");
+    }
+
+    parse_arguments(opt, std::vector<std::string>(argv + 2, argv + argc));
+
+    if (opt.target_ci > 0.0 && opt.control.empty()) {
+        throw usage_error("--target-ci needs a persistent server (--role client --control EP)");
+    }
+    if (opt.count_allocs && !alloc_count::available()) {
+        throw usage_error("--allocs needs glibc and the allocation hooks (in zmqbench, not zmqbench_raw)");
+    }
+    if (opt.max_trials < opt.trials) {
+        opt.max_trials = opt.trials;
+    }
+
+    return opt;
+}
+
+void print_usage(std::ostream &out, const char *program) {
+    out << "Usage: " << program << " <command> [options]\n";
+    out << "\nCommands:\n";
+    for (const command &cmd : commands()) {
+        out << "  " << std::left << std::setw(20) << cmd.name << cmd.summary << "\n";
+    }
+    out << "\nOptions:\n";
+    out << "  -r, --role ROLE       server, client or both (default: both, one process)\n";
+    out << "  -e, --endpoint EP     server binds, client connects (default: tcp://127.0.0.1:5555)\n";
+    out << "  -s, --size S[,S...]   message sizes in bytes, run in turn (default: 64)\n";
+    out << "  -n, --count N         messages or roundtrips per size (default: per command)\n";
+    out << "      --io-threads N    libzmq I/O threads per context (default: 1)\n";
+    out << "  -c, --control EP      control channel of a persistent server (serve, stop, client role)\n";
+    out << "  -f, --format FMT      results on stdout: text, json (one object per line) or csv\n";
+    out << "  -o, --output FILE     also append result records to FILE (.csv: CSV, else JSON lines)\n";
+    out << "      --trials N        repeat each size N times; report the median and 95% CI\n";
+    out << "      --target-ci PCT   keep adding trials until the CI is within PCT% of the median\n";
+    out << "      --max-trials N    upper bound for --target-ci (default: 30)\n";
+    out << "      --test CMD        ab: kernel to compare, lat or thr (default: thr)\n";
+    out << "      --a ARGS          ab: options of configuration A, e.g. \"--io-threads 1\"\n";
+    out << "      --b ARGS          ab: options of configuration B\n";
+    out << "      --pairs N         ab: A/B pairs per size, run in ABBA order (default: 10)\n";
+    out << "      --recv MODE       lat/thr receive path: message (default) or buffer (preallocated)\n";
+    out << "      --allocs          report heap allocations per message (glibc)\n";
+    out << "      --sockets N,...   poll: sockets in the poll set; conns: connections (default: 1,10,100,1000,10000)\n";
+    out << "      --active K        poll: sockets that receive traffic (default: 10)\n";
+    out << "      --poller P        poll: zmq_poll, poller_t, active_poller_t or all (default)\n";
+    out << "      --threads N       conns: client threads sharing the connections (default: 4);\n";
+    out << "                        mdp: clients, one request in flight each" "\n";
+    out << "      --peer TYPE       conns: client socket type, dealer (default) or req;\n";
+    out << "                        duplex: socket type of both sides, dealer (default) or pair\n";
+    out << "      --pattern P,...   patterns: req-rep, push-pull, pair, dealer-dealer, dealer-router,\n";
+    out << "                        router-router, pub-sub (default: all)\n";
+    out << "      --via P,...       proxy: zmq::proxy (proxy), zmq_proxy_steerable (steerable),\n";
+    out << "                        the batching forwarder (batch); default: all three\n";
+    out << "      --capture         proxy: give the proxy a capture socket (drained by a SUB)\n";
+    out << "      --batch N         proxy: messages the batching forwarder moves per burst (default: 256)\n";
+    out << "      --busy-poll       proxy: the batching forwarder spins instead of blocking in zmq_poll\n";
+    out << "      --proxy-cpu N     proxy: pin the proxy thread to core N (Linux)\n";
+    out << "      --stages N,...    chain: forwarding stages between source and sink (default: 3,8)\n";
+    out << "      --stage K         chain: run stage K alone (tcp, one process per element)\n";
+    out << "      --stage-work US,...\n";
+    out << "                        chain: spin per message in each stage, in us (one value: all)\n";
+    out << "      --workers N,...   mdp: Majordomo workers, round-robin over the services (default: 1,4,16);\n";
+    out << "                        pirate: Paranoid Pirate workers (default: 4)\n";
+    out << "      --services N,...  mdp: services the workers register for (default: 1,4)\n";
+    out << "      --heartbeat MS,...\n";
+    out << "                        mdp: broker/worker heartbeat interval in ms (default: 2500);\n";
+    out << "                        pirate: queue/worker heartbeat interval (default: 100)\n";
+    out << "      --pirate M,...    pirate: lazy (REQ -> server), paranoid (REQ -> queue -> workers)\n";
+    out << "                        or both (default)\n";
+    out << "      --timeout MS,...  pirate: reply timeout per attempt (default: 100,500)\n";
+    out << "      --retries N       pirate: attempts after the first before giving up (default: 3)\n";
+    out << "      --drop PCT        pirate: requests the server drops (paranoid: its worker crashes) (default: 1)\n";
+    out << "      --delay PCT       pirate: requests the server holds for --delay-ms (default: 1)\n";
+    out << "      --delay-ms MS     pirate: how long a delayed request is held (default: 200)\n";
+    out << "      --fanout K,...    scatter: servers each request goes to (default: 1,2,4,8,16,32,64)\n";
+    out << "      --gather G,...    scatter: router (one ROUTER), dealer (one DEALER per server) or both\n";
+    out << "      --service-time D  scatter: server service time: none (default), fixed:US,\n";
+    out << "                        uniform:MIN:MAX, exp:MEAN or bimodal:US:SLOW:PCT\n";
+    out << "      --mechanism M,... null, plain or curve; lat/thr take one (default: null),\n";
+    out << "                        connect a list (default: every one built)\n";
+    out << "      --zap MODE        ZAP handler on the server: off, on, or both for connect\n";
+    out << "      --curve-serverkey K\n";
+    out << "                        server's CURVE public key, for a client in its own process\n";
+    out << "      --sndhwm N        ZMQ_SNDHWM on data sockets (0 = unlimited)\n";
+    out << "      --rcvhwm N        ZMQ_RCVHWM on data sockets (0 = unlimited)\n";
+    out << "      --sndbuf N        ZMQ_SNDBUF (kernel send buffer) on data sockets\n";
+    out << "      --rcvbuf N        ZMQ_RCVBUF (kernel receive buffer) on data sockets\n";
+    out << "\nExamples:\n";
+    out << "  " << program << " thr --size 64,1500,65536\n";
+    out << "  " << program << " lat --role server --endpoint tcp://*:5555 --size 64 --count 10000\n";
+    out << "  " << program << " lat --role client --endpoint tcp://localhost:5555 --size 64 --count 10000\n";
+    out << "  " << program << " lat --size 64 --trials 10\n";
+    out << "  " << program << " thr --size 64,1500,65536 --recv buffer --allocs\n";
+    out << "  " << program << " lat --size 64,1500 --mechanism curve\n";
+    out << "  " << program << " poll --sockets 10,1000,10000 --active 16\n";
+    out << "  " << program << " conns --role server --endpoint tcp://*:5555\n";
+    out << "  " << program << " conns --role client --endpoint tcp://localhost:5555 --sockets 100,10000\n";
+    out << "  " << program << " patterns --size 64,1500 --pattern req-rep,dealer-router,router-router\n";
+    out << "  " << program << " duplex --size 64,1500 --peer pair --io-threads 2\n";
+    out << "  " << program << " proxy --size 64,1500 --capture\n";
+    out << "  " << program << " proxy --size 16,64 --via proxy,batch --batch 1024 --busy-poll --proxy-cpu 2\n";
+    out << "  " << program << " chain --endpoint inproc://zmqbench-chain --stages 3,8 --stage-work 0,0.5,0\n";
+    out << "  " << program << " mdp --workers 1,4,16 --services 1,4 --heartbeat 10,2500 --threads 8\n";
+    out << "  " << program << " pirate --pirate lazy --timeout 50,100,250 --drop 2 --delay 5 --delay-ms 80\n";
+    out << "  " << program << " scatter --fanout 1,8,64 --gather dealer --service-time bimodal:50:2000:1\n";
+    out << "  " << program << " connect --endpoint ipc:///tmp/zmqbench-connect --mechanism null,curve\n";
+    out << "  " << program << " ab --test thr --a \"--io-threads 1\" --b \"--io-threads 2\" --pairs 20\n";
+    out << "  " << program << " serve --control tcp://*:5550 --endpoint tcp://*:5556\n";
+    out << "  " << program << " thr --role client --control tcp://localhost:5550 --endpoint tcp://localhost:5556\n";
+    out << "  " << program << " thr --role client --control tcp://localhost:5550 --endpoint tcp://localhost:5556 --target-ci 2\n";
+}
+
+const char *role_name(role r) {
+    switch (r) {
+    case role::server:
+        return "server";
+    case role::client:
+        return "client";
+    case role::both:
+        return "both";
+    }
+    return "unknown";
+}
+
+std::string transport_of(const std::string &endpoint) {
+    size_t pos = endpoint.find("://");
+    return pos == std::string::npos ? std::string() : endpoint.substr(0, pos);
+}
+
+}  // namespace zmqbench
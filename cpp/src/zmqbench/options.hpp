@@ -0,0 +1,198 @@
+/*
+ * zmqbench - command-line options shared by every subcommand.
+ *
+ * Usage: zmqbench <command> [--role server|client|both] [--endpoint E]
+ *                 [--size S[,S...]] [--count N] [--io-threads N]
+ *                 [--control E] [--sndhwm N] [--rcvhwm N] [--sndbuf N] [--rcvbuf N]
+ *                 [--format text|json|csv] [--output FILE]
+ *                 [--trials N] [--target-ci PCT] [--max-trials N]
+ *                 [--recv message|buffer] [--allocs]
+ *                 [--sockets N[,N...]] [--active K] [--poller P]
+ *                 [--threads N] [--peer dealer|req|pair] [--pattern P[,P...]]
+ *                 [--via proxy|steerable|batch[,...]] [--capture]
+ *                 [--batch N] [--busy-poll] [--proxy-cpu N]
+ *                 [--stages N[,N...]] [--stage K] [--stage-work US[,US...]]
+ *                 [--workers N[,N...]] [--services N[,N...]] [--heartbeat MS[,MS...]]
+ *                 [--pirate lazy|paranoid[,...]] [--timeout MS[,MS...]] [--retries N]
+ *                 [--drop PCT] [--delay PCT] [--delay-ms MS]
+ *                 [--fanout K[,K...]] [--gather router|dealer[,...]] [--service-time DIST]
+ *                 [--mechanism M[,M...]] [--zap off|on|both] [--curve-serverkey K]
+ *                 [--test lat|thr] [--a ARGS] [--b ARGS] [--pairs N]
+ */
+
+#ifndef ZMQBENCH_OPTIONS_HPP
+#define ZMQBENCH_OPTIONS_HPP
+
+#include <cstddef>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace zmqbench {
+
+// Which side(s) of a test this process runs
+enum class role { server, client, both };
+
+// libzmq options applied to data sockets; -1 keeps the libzmq default
+struct socket_options {
+    int sndhwm = -1;
+    int rcvhwm = -1;
+    int sndbuf = -1;
+    int rcvbuf = -1;
+
+    bool operator==(const socket_options &other) const {
+        return sndhwm == other.sndhwm && rcvhwm == other.rcvhwm &&
+               sndbuf == other.sndbuf && rcvbuf == other.rcvbuf;
+    }
+    bool operator!=(const socket_options &other) const { return !(*this == other); }
+};
+
+struct options {
+    std::string command;
+    zmqbench::role role = role::both;
+
+    // Server binds, client connects; one address works for both
+    // ("tcp://127.0.0.1:5555"), or pass "tcp://*:5555" to a server
+    std::string endpoint = "tcp://127.0.0.1:5555";
+
+    // Sweep: each size is run in turn over the same sockets
+    std::vector<size_t> sizes = {64};
+
+    // Messages (thr) or roundtrips (lat) per size; 0 = command default
+    int count = 0;
+
+    int io_threads = 1;
+
+    // Control channel of a persistent server (`zmqbench serve`). Empty means
+    // the client talks to a one-shot server started for this run.
+    std::string control;
+
+    socket_options sockopts;
+
+    // Receive path of lat/thr: "message" (a zmq::message_t per call) or
+    // "buffer" (recv into one preallocated buffer). count_allocs reports
+    // heap allocations per message of the measuring process.
+    std::string recv = "message";
+    bool count_allocs = false;
+
+    // Repeated trials per size: the median of the trials (outliers dropped)
+    // is reported with a 95% bootstrap CI. With target_ci > 0 trials
+    // continue past `trials` until the CI is narrower than target_ci percent
+    // of the median, or max_trials is reached; that needs a persistent
+    // server, since only the client knows when to stop.
+    int trials = 1;
+    double target_ci = 0.0;
+    int max_trials = 30;
+
+    // ab: kernel under test and the option sets of its two configurations,
+    // applied on top of the options above
+    std::string ab_test = "thr";
+    std::string variant_a;
+    std::string variant_b;
+    int pairs = 10;
+
+    // poll: poll-set sizes swept in turn, how many of the sockets get
+    // traffic, and which poller(s) to run ("all": every one built)
+    std::vector<size_t> sockets = {1, 10, 100, 1000, 10000};
+    int active = 10;
+    std::string poller = "all";
+
+    // conns: connection counts are taken from `sockets`, spread over
+    // client_threads threads; each connection is its own DEALER or REQ socket.
+    // mdp: client_threads synchronous clients.
+    // duplex: the socket type of both sides, DEALER or PAIR.
+    int client_threads = 4;
+    std::string peer = "dealer";
+
+    // patterns: socket patterns to run, by name ("req-rep", "pub-sub", ...);
+    // empty runs every one
+    std::vector<std::string> patterns;
+
+    // proxy: the proxies compared with a direct connection (zmq::proxy,
+    // zmq_proxy_steerable, the batching forwarder), and whether they get a
+    // capture socket. batch caps the messages the forwarder moves per
+    // direction before it looks at the other one; busy_poll makes it spin on
+    // non-blocking receives instead of sleeping in zmq_poll. proxy_cpu pins
+    // the proxy thread to a core (-1: not pinned).
+    std::vector<std::string> via = {"proxy", "steerable", "batch"};
+    bool capture = false;
+    int batch = 256;
+    bool busy_poll = false;
+    int proxy_cpu = -1;
+
+    // chain: pipeline lengths run in turn; chain_stage > 0 runs only that
+    // stage (a process of a multi-process chain); stage_work is the spin per
+    // message of each stage in microseconds (one value: every stage)
+    std::vector<size_t> chain_stages = {3, 8};
+    int chain_stage = 0;
+    std::vector<double> stage_work;
+
+    // mdp: Majordomo workers, services and heartbeat intervals (ms); every
+    // combination is run, with client_threads clients. pirate: workers and
+    // heartbeat intervals of the Paranoid Pirate queue. Empty workers and
+    // heartbeat_ms take the command's default.
+    std::vector<size_t> workers;
+    std::vector<size_t> mdp_services = {1, 4};
+    std::vector<size_t> heartbeat_ms;
+
+    // pirate: reliable REQ clients (Lazy Pirate) against a server, or
+    // through a heartbeating queue to workers (Paranoid Pirate). Each
+    // request waits timeout ms per attempt and is retried `retries` times on
+    // a new socket; the server side drops drop_pct percent of requests and
+    // holds delay_pct percent for delay_ms before replying.
+    std::vector<std::string> pirate_modes = {"lazy", "paranoid"};
+    std::vector<size_t> timeouts = {100, 500};
+    int retries = 3;
+    double drop_pct = 1.0;
+    double delay_pct = 1.0;
+    int delay_ms = 200;
+
+    // scatter: fan-outs run in turn, how the client gathers the replies
+    // (one ROUTER, or a DEALER per server) and the servers' service time
+    // distribution ("none", "fixed:US", "exp:MEAN", ...)
+    std::vector<size_t> fanouts = {1, 2, 4, 8, 16, 32, 64};
+    std::vector<std::string> gathers = {"router", "dealer"};
+    std::string service_time = "none";
+
+    // Security of data connections (security.hpp): mechanisms run in turn,
+    // and whether a ZAP handler authenticates handshakes: "off", "on" or
+    // "both" (without, then with); empty takes the command's default. A
+    // client in its own process needs the server's CURVE public key, which
+    // the server prints at startup.
+    std::vector<std::string> mechanisms;
+    std::string zap;
+    std::string curve_serverkey;
+
+    // Suppresses setup chatter (set for the runs nested inside ab)
+    bool quiet = false;
+
+    // Results on stdout: "text" (human-readable), "json" (one JSON object per
+    // line) or "csv". --output also appends records to a file (CSV when the
+    // name ends in .csv); defaults to $ZMQ_BENCH_OUTPUT.
+    std::string format = "text";
+    std::string output;
+};
+
+// Thrown for bad command lines; main prints usage and exits with 1
+class usage_error : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Parses argv[1] as the command and the rest as options
+options parse_options(int argc, char *argv[]);
+
+// Applies option arguments (no command) on top of opt
+void parse_arguments(options &opt, const std::vector<std::string> &args);
+
+void print_usage(std::ostream &out, const char *program);
+
+const char *role_name(role r);
+
+// "tcp", "ipc", "inproc", ... (the scheme of a ZeroMQ endpoint)
+std::string transport_of(const std::string &endpoint);
+
+}  // namespace zmqbench
+
+#endif  // ZMQBENCH_OPTIONS_HPP
@@ -0,0 +1,417 @@
+/*
+ * zmqbench patterns - the lat and thr kernels over every socket pattern.
+ *
+ * Each pattern is run as a latency test (one warm-up roundtrip, then N
+ * timed roundtrips, one-way = roundtrip / 2 as in lat) and as a throughput
+ * test (N one-way messages, the receiver times from the first to the last
+ * as in thr), where the pattern allows it:
+ *
+ *   req-rep         REQ -> REP         lat only (REQ cannot stream)
+ *   push-pull       PUSH -> PULL       thr only (no reply path)
+ *   pair            PAIR <-> PAIR
+ *   dealer-dealer   DEALER <-> DEALER
+ *   dealer-router   DEALER <-> ROUTER  the server echoes the routing-id frame
+ *   router-router   ROUTER <-> ROUTER  both sides address the other by id
+ *   pub-sub         PUB -> SUB         replies go over a second PUB/SUB pair
+ *
+ * The differences against req-rep and push-pull are the cost of envelopes,
+ * REQ's state machine and routing-id lookups. ROUTERs run with
+ * ROUTER_MANDATORY so that they block at the high-water mark instead of
+ * dropping, like the other patterns. The publishers are XPUB sockets with
+ * XPUB_NODROP for the same reason, and so they can wait for the
+ * subscription before the first message; their send path is PUB's. Routing
+ * ids travel as cppzmq frames in both builds; the payload goes through
+ * data_path.hpp like lat and thr. Both sides run in one process, one pattern
+ * and size at a time; the reply endpoint of pub-sub is the next tcp port
+ * (or the endpoint with "-1" appended).
+ */
+
+#include "zmqbench/commands.hpp"
+#include "zmqbench/data_path.hpp"
+#include "zmqbench/report.hpp"
+#include "zmqbench/stats.hpp"
+
+#include <zmq.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace zmqbench {
+
+namespace {
+
+using clock_type = std::chrono::high_resolution_clock;
+
+struct pattern {
+    const char *name;
+    const char *label;
+    zmq::socket_type client;
+    zmq::socket_type server;
+    bool lat;
+    bool thr;
+};
+
+const std::vector<pattern> &all_patterns() {
+    static const std::vector<pattern> table = {
+        {"req-rep", "REQ/REP", zmq::socket_type::req, zmq::socket_type::rep, true, false},
+        {"push-pull", "PUSH/PULL", zmq::socket_type::push, zmq::socket_type::pull, false, true},
+        {"pair", "PAIR/PAIR", zmq::socket_type::pair, zmq::socket_type::pair, true, true},
+        {"dealer-dealer", "DEALER/DEALER", zmq::socket_type::dealer, zmq::socket_type::dealer, true, true},
+        {"dealer-router", "DEALER/ROUTER", zmq::socket_type::dealer, zmq::socket_type::router, true, true},
+        {"router-router", "ROUTER/ROUTER", zmq::socket_type::router, zmq::socket_type::router, true, true},
+        {"pub-sub", "PUB/SUB", zmq::socket_type::xpub, zmq::socket_type::sub, true, true},
+    };
+    return table;
+}
+
+std::vector<pattern> selected_patterns(const options &opt) {
+    if (opt.patterns.empty()) {
+        return all_patterns();
+    }
+    std::vector<pattern> selected;
+    for (const std::string &name : opt.patterns) {
+        auto it = std::find_if(all_patterns().begin(), all_patterns().end(),
+                               [&](const pattern &p) { return name == p.name; });
+        if (it == all_patterns().end()) {
+            throw usage_error("unknown pattern '" + name + "' (expected req-rep, push-pull, pair, "
+                              "dealer-dealer, dealer-router, router-router or pub-sub)");
+        }
+        selected.push_back(*it);
+    }
+    return selected;
+}
+
+// The server ROUTER's routing id, which a client ROUTER addresses
+const std::string server_id = "zmqbench-server";
+
+// One side of a pattern: messages leave on tx and arrive on rx, the same
+// socket except in pub-sub. ROUTER sides put the peer's routing id in front
+// of every payload; the server learns it from the first request.
+class side {
+public:
+    side(zmq::context_t &context, zmq::socket_type type, const socket_options &sockopts)
+        : main_(context, type), envelope_(type == zmq::socket_type::router) {
+        setup(main_, type, sockopts);
+        tx_ = &main_;
+        rx_ = &main_;
+        publisher_ = type == zmq::socket_type::xpub;
+        tx_publishes_ = publisher_;
+    }
+    side(const side &) = delete;
+    side &operator=(const side &) = delete;
+
+    zmq::socket_t &main() { return main_; }
+
+    // pub-sub latency: the reverse pair, publishing if main subscribes
+    zmq::socket_t &add_reply(zmq::context_t &context, const socket_options &sockopts) {
+        zmq::socket_type type = publisher_ ? zmq::socket_type::sub : zmq::socket_type::xpub;
+        reply_ = zmq::socket_t(context, type);
+        setup(reply_, type, sockopts);
+        (publisher_ ? rx_ : tx_) = &reply_;
+        tx_publishes_ = true;
+        return reply_;
+    }
+
+    void address(const std::string &routing_id) { peer_ = zmq::message_t(routing_id); }
+
+    // Blocks until a subscriber has subscribed, when tx is a publisher
+    void wait_for_subscriber() {
+        if (!tx_publishes_) {
+            return;
+        }
+        zmq::message_t subscription;
+        if (!tx_->recv(subscription, zmq::recv_flags::none)) {
+            throw std::runtime_error("Failed to receive the subscription");
+        }
+    }
+
+    void send(const std::vector<char> &payload, int i) {
+        if (envelope_) {
+            send_routing_id(i);
+        }
+        if (!data_path::send_copy(*tx_, payload.data(), payload.size())) {
+            throw std::runtime_error("Failed to send message " + std::to_string(i));
+        }
+    }
+
+    // Sends a received message back unchanged (the echo of lat)
+    void send_back(data_path::inbox &message, int i) {
+        if (envelope_) {
+            send_routing_id(i);
+        }
+        if (!message.send_back(*tx_)) {
+            throw std::runtime_error("Failed to send message " + std::to_string(i));
+        }
+    }
+
+    void recv(data_path::inbox &message, size_t expected, int i) {
+        if (envelope_ && (!rx_->recv(peer_, zmq::recv_flags::none) || !peer_.more())) {
+            throw std::runtime_error("Failed to receive the routing id of message " + std::to_string(i));
+        }
+        if (!message.recv(*rx_)) {
+            throw std::runtime_error("Failed to receive message " + std::to_string(i));
+        }
+        if (message.size() != expected) {
+            throw std::runtime_error("Message size mismatch at message " + std::to_string(i) +
+                                     ". Expected " + std::to_string(expected) + ", got " +
+                                     std::to_string(message.size()));
+        }
+    }
+
+private:
+    static void setup(zmq::socket_t &socket, zmq::socket_type type, const socket_options &sockopts) {
+        configure(socket, sockopts);
+        if (type == zmq::socket_type::router) {
+            socket.set(zmq::sockopt::router_mandatory, true);
+        } else if (type == zmq::socket_type::xpub) {
+            int on = 1;
+            if (zmq_setsockopt(socket.handle(), ZMQ_XPUB_NODROP, &on, sizeof(on)) != 0) {
+                throw zmq::error_t();
+            }
+        } else if (type == zmq::socket_type::sub) {
+            socket.set(zmq::sockopt::subscribe, "");
+        }
+    }
+
+    // A client ROUTER cannot route to the server until the handshake has
+    // delivered its routing id; until then the send fails with EHOSTUNREACH
+    void send_routing_id(int i) {
+        auto deadline = clock_type::now() + std::chrono::seconds(5);
+        while (true) {
+            try {
+                zmq::message_t id(peer_.data(), peer_.size());
+                tx_->send(id, zmq::send_flags::sndmore);
+                routable_ = true;
+                return;
+            } catch (const zmq::error_t &e) {
+                if (routable_ || e.num() != EHOSTUNREACH || clock_type::now() > deadline) {
+                    throw std::runtime_error("Failed to route message " + std::to_string(i) + ": " +
+                                             e.what());
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    zmq::socket_t main_;
+    zmq::socket_t reply_;
+    zmq::socket_t *tx_;
+    zmq::socket_t *rx_;
+    bool publisher_;
+    bool tx_publishes_;
+    bool envelope_;
+    bool routable_ = false;
+    zmq::message_t peer_;
+};
+
+result lat_client(side &client, size_t message_size, int roundtrip_count) {
+    std::vector<char> payload(message_size, 'X');
+    data_path::inbox reply;
+    std::vector<double> samples;
+    samples.reserve(static_cast<size_t>(roundtrip_count));
+
+    client.wait_for_subscriber();
+
+    // Warm-up
+    client.send(payload, -1);
+    client.recv(reply, message_size, -1);
+
+    auto start = clock_type::now();
+    auto last = start;
+    for (int i = 0; i < roundtrip_count; i++) {
+        client.send(payload, i);
+        client.recv(reply, message_size, i);
+        auto now = clock_type::now();
+        samples.push_back(std::chrono::duration<double, std::micro>(now - last).count() / 2.0);
+        last = now;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(last - start).count();
+
+    result r;
+    r.command = "patterns";
+    r.message_size = message_size;
+    r.message_count = roundtrip_count;
+    r.elapsed_us = static_cast<double>(elapsed);
+    r.msg_per_sec = roundtrip_count * 1000000.0 / r.elapsed_us;
+    r.megabits = r.msg_per_sec * message_size * 8 / 1000000.0;
+    r.has_latency = true;
+    r.latency_us = r.elapsed_us / static_cast<double>(roundtrip_count * 2);
+    r.latency = summarize(std::move(samples));
+    return r;
+}
+
+// Warm-up + measured roundtrips
+void lat_server(side &server, size_t message_size, int roundtrip_count) {
+    data_path::inbox request;
+    server.wait_for_subscriber();
+    for (int i = 0; i <= roundtrip_count; i++) {
+        server.recv(request, message_size, i);
+        server.send_back(request, i);
+    }
+}
+
+void thr_client(side &client, size_t message_size, int message_count) {
+    std::vector<char> payload(message_size, 'X');
+    client.wait_for_subscriber();
+    for (int i = 0; i < message_count; i++) {
+        client.send(payload, i);
+    }
+}
+
+result thr_server(side &server, size_t message_size, int message_count) {
+    data_path::inbox message;
+
+    // Start timing after the first message (warm-up)
+    server.recv(message, message_size, 0);
+    auto start = clock_type::now();
+    for (int i = 1; i < message_count; i++) {
+        server.recv(message, message_size, i);
+    }
+    auto end = clock_type::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    result r;
+    r.command = "patterns";
+    r.message_size = message_size;
+    r.message_count = message_count;
+    r.elapsed_us = static_cast<double>(elapsed);
+    r.msg_per_sec = static_cast<double>(message_count - 1) / (r.elapsed_us / 1000000.0);
+    r.megabits = (r.msg_per_sec * message_size * 8) / 1000000.0;
+    return r;
+}
+
+// Runs one kernel of one pattern with a fresh server and client
+result run_pattern(const options &opt, const pattern &p, size_t size, bool latency) {
+    result measured;
+
+    auto server = [&](zmq::context_t &context, bool) {
+        side s(context, p.server, opt.sockopts);
+        if (p.server == zmq::socket_type::router) {
+            s.main().set(zmq::sockopt::routing_id, zmq::buffer(server_id));
+        }
+        bind_with_retry(s.main(), opt.endpoint);
+        if (latency) {
+            if (p.server == zmq::socket_type::sub) {
+                bind_with_retry(s.add_reply(context, opt.sockopts), sibling_endpoint(opt.endpoint, 1));
+            }
+            lat_server(s, size, opt.count);
+        } else {
+            measured = thr_server(s, size, opt.count);
+        }
+    };
+
+    auto client = [&](zmq::context_t &context, bool) {
+        side c(context, p.client, opt.sockopts);
+        if (p.client == zmq::socket_type::router) {
+            c.address(server_id);
+        }
+        c.main().connect(opt.endpoint);
+        if (latency) {
+            if (p.server == zmq::socket_type::sub) {
+                c.add_reply(context, opt.sockopts).connect(sibling_endpoint(opt.endpoint, 1));
+            }
+            measured = lat_client(c, size, opt.count);
+        } else {
+            thr_client(c, size, opt.count);
+        }
+    };
+
+    run_roles(opt, server, client);
+    measured.transport = transport_of(opt.endpoint);
+    return measured;
+}
+
+struct cell {
+    std::optional<result> lat;
+    std::optional<result> thr;
+};
+
+void print_matrix(std::ostream &out, const std::vector<pattern> &patterns,
+                  const std::map<std::string, cell> &cells, size_t size) {
+    const cell *req_rep = cells.count("req-rep") ? &cells.at("req-rep") : nullptr;
+    const cell *push_pull = cells.count("push-pull") ? &cells.at("push-pull") : nullptr;
+
+    out << "\n=== Socket Pattern Matrix ===\n";
+    out << "Message size: " << size << " bytes\n";
+    out << std::left << std::setw(16) << "Pattern" << std::right << std::setw(14) << "Latency (us)"
+        << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(12) << "vs REQ/REP"
+        << std::setw(16) << "Throughput" << std::setw(14) << "vs PUSH/PULL" << "\n";
+
+    auto ratio = [&](double value, double base) {
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(2) << value / base << "x";
+        return text.str();
+    };
+
+    out << std::fixed << std::setprecision(2);
+    for (const pattern &p : patterns) {
+        const cell &c = cells.at(p.name);
+        out << std::left << std::setw(16) << p.label << std::right;
+        if (c.lat) {
+            out << std::setw(14) << c.lat->latency_us << std::setw(10) << c.lat->latency.p50
+                << std::setw(10) << c.lat->latency.p99 << std::setw(12)
+                << (req_rep ? ratio(c.lat->latency_us, req_rep->lat->latency_us) : "-");
+        } else {
+            out << std::setw(14) << "-" << std::setw(10) << "-" << std::setw(10) << "-" << std::setw(12) << "-";
+        }
+        if (c.thr) {
+            out << std::setw(16) << std::setprecision(0) << c.thr->msg_per_sec << std::setprecision(2)
+                << std::setw(14) << (push_pull ? ratio(c.thr->msg_per_sec, push_pull->thr->msg_per_sec) : "-");
+        } else {
+            out << std::setw(16) << "-" << std::setw(14) << "-";
+        }
+        out << "\n";
+    }
+    out << std::defaultfloat << std::setprecision(6);
+    out << "Latency is one-way (roundtrip / 2); throughput in msg/s\n";
+}
+
+}  // namespace
+
+void run_patterns(const options &opt) {
+    if (opt.role != role::both || !opt.control.empty()) {
+        throw usage_error("patterns runs both sides in one process (no --role or --control)");
+    }
+    std::vector<pattern> patterns = selected_patterns(opt);
+
+    for (size_t size : opt.sizes) {
+        std::map<std::string, cell> cells;
+        for (const pattern &p : patterns) {
+            if (chatty(opt)) {
+                std::cout << "Running " << p.label << " with " << size << " byte messages...\n";
+            }
+            cell &c = cells[p.name];
+            if (p.lat) {
+                c.lat = run_pattern(opt, p, size, true);
+            }
+            if (p.thr) {
+                c.thr = run_pattern(opt, p, size, false);
+            }
+
+            for (const std::optional<result> *r : {&c.lat, &c.thr}) {
+                if (!*r) {
+                    continue;
+                }
+                bench_output::record rec = to_record(**r, opt);
+                rec.set("pattern", p.name);
+                rec.set("test", (*r)->has_latency ? "lat" : "thr");
+                write_record(opt, rec);
+            }
+        }
+        if (opt.format == "text") {
+            print_matrix(std::cout, patterns, cells, size);
+        }
+    }
+}
+
+}  // namespace zmqbench
@@ -0,0 +1,558 @@
+/*
+ * zmqbench pirate - reliable request-reply under induced failures.
+ *
+ * Clients are Lazy Pirate clients, as in the ZeroMQ guide: a REQ socket that
+ * waits --timeout ms for each reply, and on a timeout closes the socket,
+ * opens a new one and resends, up to --retries times before giving up on
+ * the request. Two server sides (--pirate):
+ *
+ *   lazy       REQ -> ROUTER server
+ *   paranoid   REQ -> ROUTER | ROUTER queue -> DEALER workers
+ *
+ * The lazy server drops --drop percent of requests (no reply) and holds
+ * --delay percent for --delay-ms before replying, without blocking the
+ * others. In paranoid mode the failures happen in the workers: a drop is a
+ * crash (the worker closes its socket mid-request and restarts at once under
+ * a new identity) and a delay blocks the worker, heartbeats included. The
+ * queue hands requests to the least recently used ready worker, heartbeats
+ * ready workers every --heartbeat ms and forgets a worker silent for three
+ * intervals; a request routed to a crashed worker before then is lost. A
+ * worker that hears nothing from the queue for three intervals reconnects,
+ * backing off exponentially.
+ *
+ * --threads clients share --count requests. Goodput is the requests that got
+ * a reply, per second of the run. Latency runs from the first attempt to the
+ * reply, retries included. Recovery is, for requests that needed a retry,
+ * the time from the first timeout to the reply. Failures are drawn from a
+ * fixed-seed generator, so runs are repeatable. Everything is one process.
+ */
+
+#include "zmqbench/commands.hpp"
+#include "zmqbench/report.hpp"
+#include "zmqbench/stats.hpp"
+
+#include <zmq.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace zmqbench {
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// Paranoid Pirate control frames, worker <-> queue
+const char ppp_ready = '\x01';
+const char ppp_heartbeat = '\x02';
+
+// Heartbeats a peer may miss before it is given up on
+const int liveness = 3;
+
+// Worker reconnect backoff, in heartbeat intervals
+const int backoff_max = 32;
+
+bool is_control(const frames &msg, char command) {
+    return msg.size() == 2 && msg[1].size() == 1 && *msg[1].data<char>() == command;
+}
+
+// What the server side does with one request
+enum class fate { reply, drop, delay };
+
+class failure_dice {
+public:
+    failure_dice(const options &opt, unsigned seed)
+        : drop_(opt.drop_pct), delay_(opt.delay_pct), engine_(seed), roll_(0.0, 100.0) {}
+
+    fate roll() {
+        double r = roll_(engine_);
+        if (r < drop_) {
+            return fate::drop;
+        }
+        return r < drop_ + delay_ ? fate::delay : fate::reply;
+    }
+
+private:
+    double drop_;
+    double delay_;
+    std::mt19937 engine_;
+    std::uniform_real_distribution<double> roll_;
+};
+
+// The lazy server: echoes on a ROUTER, drops some requests and holds others
+void run_lazy_server(zmq::socket_t &socket, const options &opt) {
+    failure_dice dice(opt, 1);
+    std::chrono::milliseconds delay(opt.delay_ms);
+    std::deque<std::pair<clock_type::time_point, frames>> held;  // due time order
+
+    while (true) {
+        long timeout = -1;
+        if (!held.empty()) {
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(held.front().first -
+                                                                            clock_type::now());
+            timeout = std::max<long>(0, static_cast<long>(wait.count()));
+        }
+        zmq_pollitem_t item = {socket.handle(), 0, ZMQ_POLLIN, 0};
+        if (zmq_poll(&item, 1, timeout) < 0) {
+            throw zmq::error_t();
+        }
+        if (item.revents & ZMQ_POLLIN) {
+            frames request = recv_frames(socket);
+            switch (dice.roll()) {
+            case fate::drop:
+                break;
+            case fate::delay:
+                held.emplace_back(clock_type::now() + delay, std::move(request));
+                break;
+            case fate::reply:
+                send_frames(socket, request);
+                break;
+            }
+        }
+        while (!held.empty() && held.front().first <= clock_type::now()) {
+            send_frames(socket, held.front().second);
+            held.pop_front();
+        }
+    }
+}
+
+// The Paranoid Pirate queue: clients on the frontend, workers on the backend
+void run_queue(zmq::socket_t &frontend, zmq::socket_t &backend, std::chrono::milliseconds heartbeat) {
+    // Ready workers, least recently used first, with their expiry
+    std::deque<std::pair<std::string, clock_type::time_point>> ready;
+    auto heartbeat_at = clock_type::now() + heartbeat;
+
+    while (true) {
+        zmq_pollitem_t items[] = {{backend.handle(), 0, ZMQ_POLLIN, 0},
+                                  {frontend.handle(), 0, ZMQ_POLLIN, 0}};
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(heartbeat_at - clock_type::now());
+        // Clients are only read while a worker is ready for them
+        if (zmq_poll(items, ready.empty() ? 1 : 2, std::max<long>(0, static_cast<long>(wait.count()))) < 0) {
+            throw zmq::error_t();
+        }
+
+        if (items[0].revents & ZMQ_POLLIN) {
+            // worker READY | HEARTBEAT, or worker client "" body
+            frames msg = recv_frames(backend);
+            bool control = is_control(msg, ppp_ready) || is_control(msg, ppp_heartbeat);
+            if (!control && msg.size() <= 2) {
+                std::cerr << "Warning: invalid message from a Paranoid Pirate worker, dropped\n";
+            } else {
+                std::string worker = msg[0].to_string();
+                ready.erase(std::remove_if(ready.begin(), ready.end(),
+                                           [&](const auto &entry) { return entry.first == worker; }),
+                            ready.end());
+                ready.emplace_back(worker, clock_type::now() + liveness * heartbeat);
+                if (!control) {
+                    msg.erase(msg.begin());
+                    send_frames(frontend, msg);
+                }
+            }
+        }
+        if (items[1].revents & ZMQ_POLLIN) {
+            // client "" body -> worker client "" body
+            frames msg = recv_frames(frontend);
+            msg.insert(msg.begin(), zmq::message_t(ready.front().first.data(), ready.front().first.size()));
+            ready.pop_front();
+            send_frames(backend, msg);
+        }
+
+        auto now = clock_type::now();
+        if (now >= heartbeat_at) {
+            for (const auto &entry : ready) {
+                frames beat;
+                beat.push_back(zmq::message_t(entry.first.data(), entry.first.size()));
+                beat.push_back(zmq::message_t(&ppp_heartbeat, 1));
+                send_frames(backend, beat);
+            }
+            heartbeat_at = now + heartbeat;
+        }
+        ready.erase(std::remove_if(ready.begin(), ready.end(),
+                                   [&](const auto &entry) { return entry.second < now; }),
+                    ready.end());
+    }
+}
+
+struct worker_counters {
+    long long crashes = 0;
+    long long reconnects = 0;  // after the queue went silent
+};
+
+// A Paranoid Pirate echo worker; runs until the context shuts down
+void run_worker(zmq::context_t &context, const std::string &endpoint, const options &opt,
+                std::chrono::milliseconds heartbeat, unsigned seed, worker_counters &counters) {
+    failure_dice dice(opt, seed);
+    zmq::socket_t socket;
+    auto connect = [&]() {
+        socket = zmq::socket_t(context, zmq::socket_type::dealer);
+        socket.set(zmq::sockopt::linger, 0);
+        socket.connect(endpoint);
+        if (!socket.send(zmq::const_buffer(&ppp_ready, 1), zmq::send_flags::none)) {
+            throw std::runtime_error("Failed to send READY");
+        }
+    };
+    connect();
+
+    int queue_liveness = liveness;
+    int backoff = 1;
+    auto heartbeat_at = clock_type::now() + heartbeat;
+    while (true) {
+        zmq_pollitem_t item = {socket.handle(), 0, ZMQ_POLLIN, 0};
+        if (zmq_poll(&item, 1, static_cast<long>(heartbeat.count())) < 0) {
+            throw zmq::error_t();
+        }
+        if (item.revents & ZMQ_POLLIN) {
+            frames msg = recv_frames(socket);
+            queue_liveness = liveness;
+            backoff = 1;
+            if (msg.size() == 3) {
+                fate f = dice.roll();
+                if (f == fate::drop) {
+                    // Crash mid-request; a supervisor restarts it at once
+                    counters.crashes++;
+                    connect();
+                    heartbeat_at = clock_type::now() + heartbeat;
+                    continue;
+                }
+                if (f == fate::delay) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(opt.delay_ms));
+                }
+                send_frames(socket, msg);
+            }
+        } else if (--queue_liveness == 0) {
+            std::this_thread::sleep_for(backoff * heartbeat);
+            backoff = std::min(backoff * 2, backoff_max);
+            counters.reconnects++;
+            connect();
+            queue_liveness = liveness;
+        }
+        if (clock_type::now() >= heartbeat_at) {
+            if (!socket.send(zmq::const_buffer(&ppp_heartbeat, 1), zmq::send_flags::none)) {
+                throw std::runtime_error("Failed to send HEARTBEAT");
+            }
+            heartbeat_at = clock_type::now() + heartbeat;
+        }
+    }
+}
+
+// What one client saw over its share of the requests
+struct client_tally {
+    std::vector<double> latency_us;   // succeeded requests, retries included
+    std::vector<double> recovery_us;  // retried requests: first timeout -> reply
+    long long retries = 0;
+    long long failed = 0;
+};
+
+// The Lazy Pirate client
+class lazy_pirate {
+public:
+    lazy_pirate(zmq::context_t &context, const std::string &endpoint, const options &opt,
+                std::chrono::milliseconds timeout)
+        : context_(context), endpoint_(endpoint), timeout_(timeout), retries_(opt.retries) {
+        connect();
+    }
+
+    // One request, first attempt to reply; false when every retry timed out
+    bool request(uint64_t sequence, std::vector<char> &body, client_tally &tally) {
+        std::memcpy(body.data(), &sequence, sizeof(sequence));
+        auto start = clock_type::now();
+        clock_type::time_point first_timeout;
+
+        for (int attempt = 0; attempt <= retries_; attempt++) {
+            if (!socket_.send(zmq::buffer(body), zmq::send_flags::none)) {
+                throw std::runtime_error("Failed to send request " + std::to_string(sequence));
+            }
+            auto deadline = clock_type::now() + timeout_;
+            while (true) {
+                auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - clock_type::now());
+                zmq_pollitem_t item = {socket_.handle(), 0, ZMQ_POLLIN, 0};
+                if (zmq_poll(&item, 1, std::max<long>(0, static_cast<long>(wait.count()))) < 0) {
+                    throw zmq::error_t();
+                }
+                if (!(item.revents & ZMQ_POLLIN)) {
+                    break;
+                }
+                zmq::message_t reply;
+                (void)socket_.recv(reply, zmq::recv_flags::none);
+                uint64_t echoed = 0;
+                if (reply.size() == body.size()) {
+                    std::memcpy(&echoed, reply.data(), sizeof(echoed));
+                }
+                if (echoed != sequence) {
+                    throw std::runtime_error("Malformed reply to request " + std::to_string(sequence));
+                }
+                auto now = clock_type::now();
+                tally.latency_us.push_back(std::chrono::duration<double, std::micro>(now - start).count());
+                if (attempt > 0) {
+                    tally.recovery_us.push_back(
+                        std::chrono::duration<double, std::micro>(now - first_timeout).count());
+                }
+                return true;
+            }
+
+            // No reply in time: REQ is stuck waiting, so start over on a new socket
+            if (attempt == 0) {
+                first_timeout = clock_type::now();
+            }
+            connect();
+            if (attempt < retries_) {
+                tally.retries++;
+            }
+        }
+        tally.failed++;
+        return false;
+    }
+
+private:
+    void connect() {
+        socket_ = zmq::socket_t(context_, zmq::socket_type::req);
+        socket_.set(zmq::sockopt::linger, 0);
+        socket_.connect(endpoint_);
+    }
+
+    zmq::context_t &context_;
+    std::string endpoint_;
+    std::chrono::milliseconds timeout_;
+    int retries_;
+    zmq::socket_t socket_;
+};
+
+struct run_config {
+    std::string mode;
+    size_t timeout_ms = 0;
+    size_t heartbeat_ms = 0;  // paranoid only
+    size_t workers = 0;       // paranoid only
+};
+
+struct pirate_result {
+    run_config config;
+    size_t size = 0;
+    long long requests = 0;
+    long long succeeded = 0;
+    long long retries = 0;
+    long long failed = 0;
+    double elapsed_us = 0.0;
+    latency_summary latency;
+    latency_summary recovery;
+    worker_counters workers;
+
+    double goodput() const { return succeeded / (elapsed_us / 1000000.0); }
+};
+
+pirate_result run_once(const options &opt, const run_config &config, size_t size) {
+    bool paranoid = config.mode == "paranoid";
+    std::chrono::milliseconds heartbeat(config.heartbeat_ms);
+    int clients = opt.client_threads;
+    int per_client = std::max(1, opt.count / clients);
+
+    zmq::context_t context(opt.io_threads);
+    zmq::socket_t frontend(context, zmq::socket_type::router);
+    zmq::socket_t backend;
+    bind_with_retry(frontend, opt.endpoint);
+    std::string backend_endpoint = sibling_endpoint(opt.endpoint, 1);
+    if (paranoid) {
+        backend = zmq::socket_t(context, zmq::socket_type::router);
+        bind_with_retry(backend, backend_endpoint);
+    }
+
+    first_error errors(context);
+
+    std::vector<std::thread> servers;
+    std::vector<worker_counters> worker_counts(paranoid ? config.workers : 0);
+    if (paranoid) {
+        servers.emplace_back(errors.guarded([&]() { run_queue(frontend, backend, heartbeat); }));
+        for (size_t w = 0; w < config.workers; w++) {
+            servers.emplace_back(errors.guarded([&, w]() {
+                run_worker(context, backend_endpoint, opt, heartbeat, static_cast<unsigned>(w + 1),
+                           worker_counts[w]);
+            }));
+        }
+    } else {
+        servers.emplace_back(errors.guarded([&]() { run_lazy_server(frontend, opt); }));
+    }
+
+    std::vector<client_tally> tallies(static_cast<size_t>(clients));
+    std::vector<std::thread> client_threads;
+    auto start = clock_type::now();
+    for (int c = 0; c < clients; c++) {
+        client_threads.emplace_back(errors.guarded([&, c]() {
+            lazy_pirate client(context, opt.endpoint, opt, std::chrono::milliseconds(config.timeout_ms));
+            std::vector<char> body(size, 'X');
+            client_tally &tally = tallies[static_cast<size_t>(c)];
+            tally.latency_us.reserve(static_cast<size_t>(per_client));
+            for (int i = 0; i < per_client; i++) {
+                uint64_t sequence = static_cast<uint64_t>(c) << 32 | static_cast<uint64_t>(i);
+                client.request(sequence, body, tally);
+            }
+        }));
+    }
+    for (std::thread &thread : client_threads) {
+        thread.join();
+    }
+    auto end = clock_type::now();
+    context.shutdown();
+    for (std::thread &thread : servers) {
+        thread.join();
+    }
+    errors.rethrow();
+
+    pirate_result r;
+    r.config = config;
+    r.size = size;
+    r.requests = static_cast<long long>(per_client) * clients;
+    r.elapsed_us = std::chrono::duration<double, std::micro>(end - start).count();
+    std::vector<double> latency;
+    std::vector<double> recovery;
+    for (const client_tally &tally : tallies) {
+        latency.insert(latency.end(), tally.latency_us.begin(), tally.latency_us.end());
+        recovery.insert(recovery.end(), tally.recovery_us.begin(), tally.recovery_us.end());
+        r.retries += tally.retries;
+        r.failed += tally.failed;
+    }
+    r.succeeded = static_cast<long long>(latency.size());
+    r.latency = summarize(latency);
+    r.recovery = summarize(recovery);
+    for (const worker_counters &w : worker_counts) {
+        r.workers.crashes += w.crashes;
+        r.workers.reconnects += w.reconnects;
+    }
+    return r;
+}
+
+std::string describe(const run_config &config) {
+    if (config.mode == "lazy") {
+        return "lazy";
+    }
+    return "paranoid/" + std::to_string(config.workers) + "w/" + std::to_string(config.heartbeat_ms) + "ms";
+}
+
+void print(std::ostream &out, const options &opt, size_t size, const std::vector<pirate_result> &rows) {
+    out << "\n=== Reliable Request-Reply (Pirate) Results ===\n";
+    out << "Message size: " << size << " bytes\n";
+    out << "Clients: " << opt.client_threads << ", retries: " << opt.retries << "\n";
+    out << "Injected: " << opt.drop_pct << "% dropped, " << opt.delay_pct << "% delayed by "
+        << opt.delay_ms << " ms\n";
+    out << std::left << std::setw(22) << "Server side" << std::right << std::setw(9) << "Timeout"
+        << std::setw(11) << "Goodput" << std::setw(11) << "p50 (us)" << std::setw(12) << "p99 (us)"
+        << std::setw(13) << "p99.9 (us)" << std::setw(9) << "Retries" << std::setw(8) << "Failed"
+        << std::setw(15) << "Recovery p50" << std::setw(15) << "Recovery p99" << "\n";
+    out << std::fixed;
+    for (const pirate_result &r : rows) {
+        std::ostringstream recovery50;
+        std::ostringstream recovery99;
+        if (r.recovery.samples == 0) {
+            recovery50 << "-";
+            recovery99 << "-";
+        } else {
+            recovery50 << std::fixed << std::setprecision(0) << r.recovery.p50;
+            recovery99 << std::fixed << std::setprecision(0) << r.recovery.p99;
+        }
+        out << std::left << std::setw(22) << describe(r.config) << std::right << std::setw(7)
+            << r.config.timeout_ms << "ms" << std::setw(11) << std::setprecision(0) << r.goodput()
+            << std::setprecision(2) << std::setw(11) << r.latency.p50 << std::setw(12) << r.latency.p99
+            << std::setw(13) << r.latency.p999 << std::setw(9) << r.retries << std::setw(8) << r.failed
+            << std::setw(15) << recovery50.str() << std::setw(15) << recovery99.str() << "\n";
+    }
+    out << std::defaultfloat << std::setprecision(6);
+    out << "Goodput in replies/s; latency from first attempt to reply; recovery (us) from the first\n"
+        << "timeout to the reply of retried requests\n";
+    for (const pirate_result &r : rows) {
+        if (r.config.mode == "paranoid") {
+            out << describe(r.config) << " (" << r.config.timeout_ms << " ms): " << r.workers.crashes
+                << " worker crashes, " << r.workers.reconnects << " worker reconnects\n";
+        }
+    }
+}
+
+bench_output::record pirate_record(const options &opt, const pirate_result &r) {
+    result as_result;
+    as_result.command = "pirate";
+    as_result.transport = transport_of(opt.endpoint);
+    as_result.message_size = r.size;
+    as_result.message_count = static_cast<int>(r.succeeded);
+    as_result.elapsed_us = r.elapsed_us;
+    as_result.has_latency = true;
+    as_result.latency_us = r.latency.mean;
+    as_result.latency = r.latency;
+
+    bench_output::record rec = to_record(as_result, opt);
+    rec.msg_per_sec = r.goodput();
+    rec.set("mode", r.config.mode);
+    rec.set("timeout_ms", static_cast<int>(r.config.timeout_ms));
+    rec.set("retries", opt.retries);
+    rec.set("clients", opt.client_threads);
+    rec.config.emplace_back("drop_pct", bench_output::json_number(opt.drop_pct));
+    rec.config.emplace_back("delay_pct", bench_output::json_number(opt.delay_pct));
+    rec.set("delay_ms", opt.delay_ms);
+    if (r.config.mode == "paranoid") {
+        rec.set("workers", static_cast<int>(r.config.workers));
+        rec.set("heartbeat_ms", static_cast<int>(r.config.heartbeat_ms));
+        rec.config.emplace_back("worker_crashes", bench_output::json_number(static_cast<double>(r.workers.crashes)));
+    }
+    rec.config.emplace_back("requests", bench_output::json_number(static_cast<double>(r.requests)));
+    rec.config.emplace_back("retried", bench_output::json_number(static_cast<double>(r.retries)));
+    rec.config.emplace_back("failed", bench_output::json_number(static_cast<double>(r.failed)));
+    if (r.recovery.samples > 0) {
+        rec.config.emplace_back("recovery_p50_us", bench_output::json_number(r.recovery.p50));
+        rec.config.emplace_back("recovery_p99_us", bench_output::json_number(r.recovery.p99));
+    }
+    return rec;
+}
+
+}  // namespace
+
+void run_pirate(const options &opt) {
+    if (opt.role != role::both || !opt.control.empty()) {
+        throw usage_error("pirate runs clients and server side in one process (no --role or --control)");
+    }
+    if (*std::min_element(opt.sizes.begin(), opt.sizes.end()) < sizeof(uint64_t)) {
+        throw usage_error("pirate numbers every request: --size must be at least 8");
+    }
+    std::vector<size_t> worker_counts = opt.workers.empty() ? std::vector<size_t>{4} : opt.workers;
+    std::vector<size_t> heartbeats = opt.heartbeat_ms.empty() ? std::vector<size_t>{100} : opt.heartbeat_ms;
+
+    std::vector<run_config> configs;
+    for (const std::string &mode : opt.pirate_modes) {
+        for (size_t timeout : opt.timeouts) {
+            if (mode == "lazy") {
+                configs.push_back(run_config{mode, timeout, 0, 0});
+                continue;
+            }
+            for (size_t heartbeat : heartbeats) {
+                for (size_t workers : worker_counts) {
+                    configs.push_back(run_config{mode, timeout, heartbeat, workers});
+                }
+            }
+        }
+    }
+
+    for (size_t size : opt.sizes) {
+        std::vector<pirate_result> rows;
+        for (const run_config &config : configs) {
+            if (chatty(opt)) {
+                std::cout << "Running " << describe(config) << " with a " << config.timeout_ms
+                          << " ms timeout, " << size << " byte messages...\n";
+            }
+            pirate_result r = run_once(opt, config, size);
+            write_record(opt, pirate_record(opt, r));
+            rows.push_back(r);
+        }
+        if (opt.format == "text") {
+            print(std::cout, opt, size, rows);
+        }
+    }
+}
+
+}  // namespace zmqbench
@@ -0,0 +1,345 @@
+/*
+ * zmqbench poll - one thread multiplexing N sockets.
+ *
+ * N PULL sockets are bound on inproc; one PUSH is connected to K of them
+ * (the active subset, spread evenly over the poll set), the rest stay idle.
+ * Each round the thread sends one timestamped message to every active
+ * socket, then waits and dispatches until all K have been drained:
+ *
+ *   zmq_poll          pollitem array of all N sockets, scanned after each wait
+ *   poller_t          zmq_poller_wait_all, only ready sockets come back
+ *   active_poller_t   the same with a std::function handler per socket
+ *
+ * poller_t and active_poller_t are libzmq draft API; they are only built
+ * with ZMQBENCH_DRAFT_API (libzmq must be built with drafts as well).
+ *
+ * Dispatch cost is wait + recv time per event, sends excluded. Latency is
+ * from each message's send to its dispatch, so it includes the time spent
+ * handling the sockets ahead of it in the same round.
+ */
+
+#include "zmqbench/commands.hpp"
+#include "zmqbench/report.hpp"
+#include "zmqbench/stats.hpp"
+
+#include <zmq.hpp>
+#include <zmq_addon.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(ZMQ_BUILD_DRAFT_API) && defined(ZMQ_HAVE_POLLER)
+#define ZMQBENCH_HAVE_POLLER 1
+#endif
+
+namespace zmqbench {
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+const std::vector<std::string> &available_pollers() {
+    static const std::vector<std::string> pollers = {
+        "zmq_poll",
+#ifdef ZMQBENCH_HAVE_POLLER
+        "poller_t",
+        "active_poller_t",
+#endif
+    };
+    return pollers;
+}
+
+// N bound PULL sockets, K of them fed by one PUSH (round-robin)
+struct poll_set {
+    zmq::context_t context;
+    std::vector<zmq::socket_t> sockets;
+    std::vector<size_t> active;
+    zmq::socket_t sender;
+
+    poll_set(size_t socket_count, size_t active_count) {
+        // Polled sockets, the sender, and headroom
+        context.set(zmq::ctxopt::max_sockets, static_cast<int>(socket_count) + 16);
+        sockets.reserve(socket_count);
+        for (size_t i = 0; i < socket_count; i++) {
+            try {
+                sockets.emplace_back(context, zmq::socket_type::pull);
+            } catch (const zmq::error_t &e) {
+                throw std::runtime_error("could not open socket " + std::to_string(i + 1) + " of " +
+                                         std::to_string(socket_count) + ": " + e.what() +
+                                         " (raise the open file limit, ulimit -n)");
+            }
+            sockets.back().bind("inproc://zmqbench-poll-" + std::to_string(i));
+        }
+
+        sender = zmq::socket_t(context, zmq::socket_type::push);
+        for (size_t j = 0; j < active_count; j++) {
+            size_t index = j * socket_count / active_count;
+            active.push_back(index);
+            sender.connect("inproc://zmqbench-poll-" + std::to_string(index));
+        }
+    }
+};
+
+// Drains ready sockets and keeps the latency samples
+class dispatcher {
+public:
+    dispatcher(size_t message_size, size_t expected_events)
+        : buffer_(message_size) {
+        samples_.reserve(expected_events);
+    }
+
+    void drain(zmq::socket_t &socket) {
+        while (true) {
+            auto received = socket.recv(zmq::buffer(buffer_), zmq::recv_flags::dontwait);
+            if (!received) {
+                return;
+            }
+            if (received->truncated() || received->size != buffer_.size()) {
+                throw std::runtime_error("Message size mismatch. Expected " +
+                                         std::to_string(buffer_.size()) + ", got " +
+                                         std::to_string(received->untruncated_size));
+            }
+            std::int64_t sent_ns;
+            std::memcpy(&sent_ns, buffer_.data(), sizeof(sent_ns));
+            std::int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                      clock_type::now().time_since_epoch())
+                                      .count();
+            if (recording_) {
+                samples_.push_back(static_cast<double>(now_ns - sent_ns) / 1000.0);
+            }
+            received_++;
+        }
+    }
+
+    size_t received() const { return received_; }
+    void reset() { received_ = 0; }
+    void record(bool on) { recording_ = on; }
+    std::vector<double> &samples() { return samples_; }
+
+private:
+    std::vector<char> buffer_;
+    std::vector<double> samples_;
+    size_t received_ = 0;
+    bool recording_ = false;
+};
+
+struct poll_result {
+    size_t events = 0;
+    size_t waits = 0;
+    double dispatch_us = 0.0;  // waits and recvs
+    double elapsed_us = 0.0;   // everything, sends included
+    latency_summary latency;
+};
+
+// One send-all / dispatch-all round per call of round(); wait() blocks until
+// at least one socket is ready and drains every ready socket
+template <typename Wait>
+poll_result drive(poll_set &set, dispatcher &dispatch, size_t message_size, int rounds, Wait wait) {
+    std::vector<char> payload(message_size, 'X');
+    size_t active = set.active.size();
+
+    size_t waits = 0;
+    auto round = [&]() -> double {
+        dispatch.reset();
+        for (size_t j = 0; j < active; j++) {
+            std::int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                      clock_type::now().time_since_epoch())
+                                      .count();
+            std::memcpy(payload.data(), &now_ns, sizeof(now_ns));
+            if (!set.sender.send(zmq::buffer(payload), zmq::send_flags::none)) {
+                throw std::runtime_error("Failed to send to active socket " + std::to_string(j));
+            }
+        }
+        auto sent = clock_type::now();
+        while (dispatch.received() < active) {
+            wait();
+            waits++;
+        }
+        return std::chrono::duration<double, std::micro>(clock_type::now() - sent).count();
+    };
+
+    // Warm-up
+    round();
+
+    poll_result r;
+    waits = 0;
+    dispatch.record(true);
+    auto start = clock_type::now();
+    for (int i = 0; i < rounds; i++) {
+        r.dispatch_us += round();
+    }
+    r.elapsed_us = std::chrono::duration<double, std::micro>(clock_type::now() - start).count();
+    dispatch.record(false);
+
+    r.events = static_cast<size_t>(rounds) * active;
+    r.waits = waits;
+    r.latency = summarize(std::move(dispatch.samples()));
+    return r;
+}
+
+poll_result run_zmq_poll(poll_set &set, dispatcher &dispatch, size_t message_size, int rounds) {
+    std::vector<zmq_pollitem_t> items(set.sockets.size());
+    for (size_t i = 0; i < set.sockets.size(); i++) {
+        items[i].socket = set.sockets[i].handle();
+        items[i].events = ZMQ_POLLIN;
+    }
+
+    return drive(set, dispatch, message_size, rounds, [&]() {
+        int ready = zmq_poll(items.data(), static_cast<int>(items.size()), -1);
+        if (ready < 0) {
+            throw zmq::error_t();
+        }
+        // Scan until every ready socket was seen
+        for (size_t i = 0; ready > 0 && i < items.size(); i++) {
+            if (items[i].revents & ZMQ_POLLIN) {
+                dispatch.drain(set.sockets[i]);
+                ready--;
+            }
+        }
+    });
+}
+
+#ifdef ZMQBENCH_HAVE_POLLER
+
+poll_result run_poller(poll_set &set, dispatcher &dispatch, size_t message_size, int rounds) {
+    zmq::poller_t<zmq::socket_t> poller;
+    for (zmq::socket_t &socket : set.sockets) {
+        poller.add(socket, zmq::event_flags::pollin, &socket);
+    }
+    std::vector<zmq::poller_event<zmq::socket_t>> events(set.sockets.size());
+
+    return drive(set, dispatch, message_size, rounds, [&]() {
+        size_t ready = poller.wait_all(events, std::chrono::milliseconds(-1));
+        for (size_t i = 0; i < ready; i++) {
+            dispatch.drain(*events[i].user_data);
+        }
+    });
+}
+
+poll_result run_active_poller(poll_set &set, dispatcher &dispatch, size_t message_size,
+                              int rounds) {
+    zmq::active_poller_t poller;
+    for (zmq::socket_t &socket : set.sockets) {
+        zmq::socket_t *target = &socket;
+        poller.add(socket, zmq::event_flags::pollin,
+                   [&dispatch, target](zmq::event_flags) { dispatch.drain(*target); });
+    }
+
+    return drive(set, dispatch, message_size, rounds,
+                 [&]() { poller.wait(std::chrono::milliseconds(-1)); });
+}
+
+#endif
+
+poll_result run_one(const std::string &poller, poll_set &set, size_t message_size, int rounds) {
+    dispatcher dispatch(message_size, static_cast<size_t>(rounds) * set.active.size());
+#ifdef ZMQBENCH_HAVE_POLLER
+    if (poller == "poller_t") {
+        return run_poller(set, dispatch, message_size, rounds);
+    }
+    if (poller == "active_poller_t") {
+        return run_active_poller(set, dispatch, message_size, rounds);
+    }
+#endif
+    (void)poller;
+    return run_zmq_poll(set, dispatch, message_size, rounds);
+}
+
+void print(std::ostream &out, const std::string &poller, size_t sockets, size_t active,
+           size_t size, const poll_result &r) {
+    out << "\n=== Poll Scaling Results ===\n";
+    out << "Poller: " << poller << "\n";
+    out << "Sockets: " << sockets << " (" << active << " active)\n";
+    out << "Message size: " << size << " bytes\n";
+    out << "Events: " << r.events << "\n";
+    out << "Events per wait: " << (static_cast<double>(r.events) / r.waits) << "\n";
+    out << "Dispatch cost: " << (r.dispatch_us * 1000.0 / r.events) << " ns/event\n";
+    out << "Event rate: " << (r.events / (r.elapsed_us / 1000000.0)) << " events/s\n";
+    out << "Latency (send to dispatch): mean " << r.latency.mean << " us, p50 " << r.latency.p50
+        << " us, p99 " << r.latency.p99 << " us, p99.9 " << r.latency.p999 << " us, max "
+        << r.latency.max << " us\n";
+}
+
+bench_output::record poll_record(const options &opt, const std::string &poller, size_t sockets,
+                               size_t active, size_t size, const poll_result &r) {
+    bench_output::record rec;
+    rec.benchmark = "poll";
+    rec.role = role_name(opt.role);
+    rec.transport = "inproc";
+    rec.endpoint = "inproc://zmqbench-poll-*";
+    rec.size = size;
+    rec.count = opt.count;
+    rec.messages = static_cast<long long>(r.events);
+    rec.elapsed_us = r.elapsed_us;
+    rec.msg_per_sec = r.events / (r.elapsed_us / 1000000.0);
+    rec.latency_us = r.latency.mean;
+    rec.min_us = r.latency.min;
+    rec.p50_us = r.latency.p50;
+    rec.p90_us = r.latency.p90;
+    rec.p99_us = r.latency.p99;
+    rec.p999_us = r.latency.p999;
+    rec.max_us = r.latency.max;
+    rec.samples = static_cast<long long>(r.latency.samples);
+    rec.zmq_version = zmq_version_string();
+    rec.set("poller", poller);
+    rec.set("sockets", static_cast<long long>(sockets));
+    rec.set("active", static_cast<long long>(active));
+    rec.config.emplace_back("events_per_wait",
+                            bench_output::json_number(static_cast<double>(r.events) / r.waits));
+    rec.config.emplace_back("dispatch_ns", bench_output::json_number(r.dispatch_us * 1000.0 / r.events));
+    return rec;
+}
+
+}  // namespace
+
+void run_poll(const options &opt) {
+    if (opt.role != role::both || !opt.control.empty()) {
+        throw usage_error("poll runs in one thread (no --role or --control)");
+    }
+
+    std::vector<std::string> pollers;
+    if (opt.poller == "all") {
+        pollers = available_pollers();
+    } else if (std::find(available_pollers().begin(), available_pollers().end(), opt.poller) !=
+               available_pollers().end()) {
+        pollers = {opt.poller};
+    } else {
+        throw usage_error(opt.poller + " needs the libzmq draft API (configure with "
+                          "-DZMQBENCH_DRAFT_API=ON against a libzmq built with drafts)");
+    }
+
+    raise_fd_limit();
+
+    for (size_t size : opt.sizes) {
+        if (size < sizeof(std::int64_t)) {
+            throw usage_error("poll needs messages of at least 8 bytes (send timestamp)");
+        }
+        for (size_t sockets : opt.sockets) {
+            size_t active = std::min(static_cast<size_t>(opt.active), sockets);
+            int rounds = std::max(1, opt.count / static_cast<int>(active));
+
+            poll_set set(sockets, active);
+            if (chatty(opt)) {
+                std::cout << "Polling " << sockets << " sockets (" << active << " active), "
+                          << rounds << " rounds...\n";
+            }
+
+            for (const std::string &poller : pollers) {
+                poll_result r = run_one(poller, set, size, rounds);
+                if (opt.format == "text") {
+                    print(std::cout, poller, sockets, active, size, r);
+                }
+                write_record(opt, poll_record(opt, poller, sockets, active, size, r));
+            }
+        }
+    }
+}
+
+}  // namespace zmqbench
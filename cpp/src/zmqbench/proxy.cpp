@@ -0,0 +1,443 @@
+/*
+ * zmqbench proxy - the cost of one broker hop.
+ *
+ * Runs the lat and thr kernels unchanged, first over a direct connection,
+ * then with a proxy thread between client and server:
+ *
+ *   lat   REQ -> [ROUTER | DEALER] -> REP     (queue)
+ *   thr   PUSH -> [PULL | PUSH] -> PULL       (streamer)
+ *
+ * The proxy is zmq::proxy, zmq_proxy_steerable (which also polls its
+ * control socket) or the batching forwarder below (--via). --capture adds a
+ * capture socket: a PUB that gets a copy of every frame, drained by a SUB
+ * on its own thread. --proxy-cpu pins whichever proxy thread runs.
+ *
+ * The batching forwarder drains each readable side with non-blocking
+ * receives, up to --batch messages at a time, before it polls again; with
+ * --busy-poll it never blocks and spins over both sides instead. Its
+ * report line includes the mean burst it actually saw (messages moved per
+ * non-empty drain): a burst near 1 means the forwarder keeps up and
+ * batching has nothing to batch.
+ * The proxy binds the client's endpoint and connects to the server, which
+ * binds the next one (sibling_endpoint), so client and server are the same
+ * code as in lat and thr. Each side has its own context, the direct runs
+ * included, so only the hop differs. That rules out inproc, and ipc is out
+ * as well: with libzmq 4.3 a one-shot ipc sender that disconnects right
+ * after its last send can lose the tail of its messages, which hangs thr.
+ *
+ * Added latency is proxied - direct one-way latency: each direction of a
+ * roundtrip crosses the proxy once, so it is the cost of one hop.
+ */
+
+#include "zmqbench/commands.hpp"
+#include "zmqbench/report.hpp"
+
+#include <zmq.hpp>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace zmqbench {
+
+namespace {
+
+const char *const capture_endpoint = "inproc://zmqbench-proxy-capture";
+const char *const control_endpoint = "inproc://zmqbench-proxy-control";
+
+void pin_to_cpu(int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0) {
+        throw std::runtime_error("Cannot pin the proxy thread to CPU " + std::to_string(cpu) + ": " +
+                                 std::strerror(rc));
+    }
+#else
+    (void)cpu;
+#endif
+}
+
+// Moves up to `limit` whole messages from one side to the other without
+// blocking on the receive; returns how many it moved
+long long drain(zmq::socket_t &from, zmq::socket_t &to, zmq::socket_t *capture, int limit,
+                zmq::message_t &frame) {
+    long long moved = 0;
+    while (moved < limit) {
+        if (!from.recv(frame, zmq::recv_flags::dontwait)) {
+            break;
+        }
+        // The rest of a multipart message has arrived with its first frame
+        while (true) {
+            bool more = frame.more();
+            if (capture != nullptr) {
+                zmq::message_t copy;
+                copy.copy(frame);
+                capture->send(copy, more ? zmq::send_flags::sndmore : zmq::send_flags::none);
+            }
+            to.send(frame, more ? zmq::send_flags::sndmore : zmq::send_flags::none);
+            if (!more) {
+                break;
+            }
+            (void)from.recv(frame, zmq::recv_flags::none);
+        }
+        moved++;
+    }
+    return moved;
+}
+
+struct forward_stats {
+    long long messages = 0;
+    long long bursts = 0;  // drains that moved at least one message
+
+    double mean_burst() const { return bursts > 0 ? static_cast<double>(messages) / bursts : 0.0; }
+};
+
+// The batching forwarder. Returns (by throwing ETERM) when the context shuts
+// down, like zmq::proxy. backward is false for PULL/PUSH, where only the
+// frontend receives.
+void forward_batches(zmq::socket_t &frontend, zmq::socket_t &backend, zmq::socket_t *capture,
+                     bool backward, int limit, bool busy_poll, forward_stats &stats) {
+    zmq::message_t frame;
+    zmq_pollitem_t items[] = {{frontend.handle(), 0, ZMQ_POLLIN, 0},
+                              {backend.handle(), 0, ZMQ_POLLIN, 0}};
+    int item_count = backward ? 2 : 1;
+
+    while (true) {
+        long long moved = drain(frontend, backend, capture, limit, frame);
+        long long moved_back = backward ? drain(backend, frontend, capture, limit, frame) : 0;
+        for (long long n : {moved, moved_back}) {
+            if (n > 0) {
+                stats.messages += n;
+                stats.bursts++;
+            }
+        }
+        if (moved > 0 || moved_back > 0 || busy_poll) {
+            continue;
+        }
+        if (zmq_poll(items, item_count, -1) < 0) {
+            throw zmq::error_t();
+        }
+    }
+}
+
+// A proxy on its own thread and context, between frontend (bound) and
+// backend (connected)
+class hop {
+public:
+    hop(const options &opt, const std::string &via, bool latency, const std::string &frontend,
+        const std::string &backend)
+        : context_(opt.io_threads), steerable_(via == "steerable"), captured_(0) {
+        zmq::socket_type front = latency ? zmq::socket_type::router : zmq::socket_type::pull;
+        zmq::socket_type back = latency ? zmq::socket_type::dealer : zmq::socket_type::push;
+
+        if (opt.capture) {
+            drain_ = std::thread([this]() { drain(); });
+        }
+        if (steerable_) {
+            control_ = zmq::socket_t(context_, zmq::socket_type::pair);
+            control_.connect(control_endpoint);
+        }
+
+        proxy_ = std::thread([this, &opt, via, latency, front, back, frontend, backend]() {
+            try {
+                if (opt.proxy_cpu >= 0) {
+                    pin_to_cpu(opt.proxy_cpu);
+                }
+                zmq::socket_t frontend_socket(context_, front);
+                zmq::socket_t backend_socket(context_, back);
+                configure(frontend_socket, opt.sockopts);
+                configure(backend_socket, opt.sockopts);
+                bind_with_retry(frontend_socket, frontend);
+                backend_socket.connect(backend);
+
+                zmq::socket_t capture;
+                if (opt.capture) {
+                    capture = zmq::socket_t(context_, zmq::socket_type::pub);
+                    capture.bind(capture_endpoint);
+                }
+                if (steerable_) {
+                    zmq::socket_t control(context_, zmq::socket_type::pair);
+                    control.bind(control_endpoint);
+                    zmq::proxy_steerable(frontend_socket, backend_socket, capture, control);
+                } else if (via == "batch") {
+                    forward_batches(frontend_socket, backend_socket, opt.capture ? &capture : nullptr,
+                                    latency, opt.batch, opt.busy_poll, stats_);
+                } else {
+                    zmq::proxy(frontend_socket, backend_socket, capture);
+                }
+            } catch (const zmq::error_t &e) {
+                // zmq::proxy and the forwarder only return when the context
+                // shuts down
+                if (e.num() != ETERM) {
+                    error_ = std::current_exception();
+                }
+            } catch (...) {
+                error_ = std::current_exception();
+            }
+        });
+    }
+
+    hop(const hop &) = delete;
+    hop &operator=(const hop &) = delete;
+
+    ~hop() {
+        try {
+            stop();
+        } catch (...) {
+        }
+    }
+
+    void stop() {
+        if (!proxy_.joinable()) {
+            return;
+        }
+        if (steerable_) {
+            control_.send(zmq::str_buffer("TERMINATE"), zmq::send_flags::none);
+            proxy_.join();
+            control_.close();
+        }
+        context_.shutdown();
+        if (proxy_.joinable()) {
+            proxy_.join();
+        }
+        if (drain_.joinable()) {
+            drain_.join();
+        }
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+    long long captured() const { return captured_.load(); }
+
+    // Valid once stop() has joined the proxy thread
+    const forward_stats &stats() const { return stats_; }
+
+private:
+    void drain() {
+        try {
+            zmq::socket_t sub(context_, zmq::socket_type::sub);
+            sub.set(zmq::sockopt::subscribe, "");
+            sub.connect(capture_endpoint);
+            zmq::message_t frame;
+            while (sub.recv(frame, zmq::recv_flags::none)) {
+                captured_++;
+            }
+        } catch (const zmq::error_t &) {
+            // ETERM: the hop is stopping
+        }
+    }
+
+    zmq::context_t context_;
+    bool steerable_;
+    zmq::socket_t control_;
+    std::thread proxy_;
+    std::thread drain_;
+    std::atomic<long long> captured_;
+    forward_stats stats_;
+    std::exception_ptr error_;
+};
+
+// Runs one kernel with client and server in separate threads and contexts,
+// through a hop unless via is "direct"; returns the measuring side's result
+result run_kernel(const options &opt, const std::string &via, bool latency, size_t size,
+                  long long *captured, forward_stats *stats) {
+    const command *kernel = find_command(latency ? "lat" : "thr");
+    std::string backend = via == "direct" ? opt.endpoint : sibling_endpoint(opt.endpoint, 1);
+
+    options base = opt;
+    base.command = kernel->name;
+    base.sizes = {size};
+    base.quiet = true;
+    base.output.clear();
+    options server = base;
+    server.role = role::server;
+    server.endpoint = backend;
+    options client = base;
+    client.role = role::client;
+
+    std::unique_ptr<hop> proxy;
+    if (via != "direct") {
+        proxy = std::make_unique<hop>(opt, via, latency, opt.endpoint, backend);
+    }
+
+    result_capture capture;
+    zmq::context_t server_context(opt.io_threads);
+    std::exception_ptr server_error;
+    std::thread server_thread([&]() {
+        context_override use(server_context);
+        try {
+            kernel->run(server);
+        } catch (...) {
+            server_error = std::current_exception();
+        }
+    });
+    try {
+        kernel->run(client);
+    } catch (...) {
+        // Unblock the server before joining, as run_roles does
+        server_context.shutdown();
+        server_thread.join();
+        throw;
+    }
+    server_thread.join();
+    if (server_error) {
+        std::rethrow_exception(server_error);
+    }
+    if (proxy) {
+        proxy->stop();
+        *captured = proxy->captured();
+        *stats = proxy->stats();
+    }
+
+    if (capture.results().size() != 1) {
+        throw std::runtime_error("proxy: expected one result per run, got " +
+                                 std::to_string(capture.results().size()));
+    }
+    return capture.results().front();
+}
+
+struct hop_result {
+    std::string via;
+    result lat;
+    result thr;
+    long long captured = 0;
+    forward_stats lat_stats;
+    forward_stats thr_stats;
+};
+
+std::string label(const options &opt, const std::string &via) {
+    if (via == "proxy") {
+        return "zmq::proxy";
+    }
+    if (via == "steerable") {
+        return "zmq_proxy_steerable";
+    }
+    if (via == "batch") {
+        return "batch/" + std::to_string(opt.batch) + (opt.busy_poll ? " (busy)" : "");
+    }
+    return "direct";
+}
+
+void print(std::ostream &out, const options &opt, size_t size, const std::vector<hop_result> &rows) {
+    const hop_result &direct = rows.front();
+
+    out << "\n=== Proxy Hop Results ===\n";
+    out << "Message size: " << size << " bytes\n";
+    out << "Capture socket: " << (opt.capture ? "on" : "off") << "\n";
+    out << std::left << std::setw(22) << "Path" << std::right << std::setw(14) << "Latency (us)"
+        << std::setw(10) << "p99" << std::setw(12) << "Added (us)" << std::setw(16) << "Throughput"
+        << std::setw(12) << "vs direct" << "\n";
+
+    out << std::fixed << std::setprecision(2);
+    for (const hop_result &row : rows) {
+        std::ostringstream added;
+        std::ostringstream ratio;
+        if (&row == &direct) {
+            added << "-";
+            ratio << "-";
+        } else {
+            added << std::fixed << std::setprecision(2) << row.lat.latency_us - direct.lat.latency_us;
+            ratio << std::fixed << std::setprecision(2) << row.thr.msg_per_sec / direct.thr.msg_per_sec
+                  << "x";
+        }
+        out << std::left << std::setw(22) << label(opt, row.via) << std::right << std::setw(14)
+            << row.lat.latency_us << std::setw(10) << row.lat.latency.p99 << std::setw(12)
+            << added.str() << std::setw(16) << std::setprecision(0) << row.thr.msg_per_sec
+            << std::setprecision(2) << std::setw(12) << ratio.str() << "\n";
+    }
+    out << std::defaultfloat << std::setprecision(6);
+    out << "Latency is one-way (roundtrip / 2); throughput in msg/s\n";
+    for (const hop_result &row : rows) {
+        if (row.via == "batch") {
+            out << std::fixed << std::setprecision(1) << "Batching forwarder mean burst: "
+                << row.lat_stats.mean_burst() << " (lat), " << row.thr_stats.mean_burst()
+                << " (thr) messages, limit " << opt.batch << "\n" << std::defaultfloat
+                << std::setprecision(6);
+        }
+    }
+    if (opt.capture) {
+        for (const hop_result &row : rows) {
+            if (&row != &direct) {
+                out << "Captured frames (" << label(opt, row.via) << "): " << row.captured << "\n";
+            }
+        }
+    }
+}
+
+}  // namespace
+
+void run_proxy(const options &opt) {
+    if (opt.role != role::both || !opt.control.empty()) {
+        throw usage_error("proxy runs client, proxy and server in one process (no --role or --control)");
+    }
+    if (transport_of(opt.endpoint) != "tcp") {
+        throw usage_error("proxy runs over tcp (client, proxy and server have their own contexts)");
+    }
+#ifndef __linux__
+    if (opt.proxy_cpu >= 0) {
+        throw usage_error("--proxy-cpu is only supported on Linux");
+    }
+#endif
+
+    std::vector<std::string> paths = {"direct"};
+    paths.insert(paths.end(), opt.via.begin(), opt.via.end());
+
+    for (size_t size : opt.sizes) {
+        std::vector<hop_result> rows;
+        for (const std::string &via : paths) {
+            if (chatty(opt)) {
+                std::cout << "Running " << label(opt, via) << " with " << size << " byte messages...\n";
+            }
+            hop_result row;
+            row.via = via;
+            long long captured_lat = 0;
+            long long captured_thr = 0;
+            row.lat = run_kernel(opt, via, true, size, &captured_lat, &row.lat_stats);
+            row.thr = run_kernel(opt, via, false, size, &captured_thr, &row.thr_stats);
+            row.captured = captured_lat + captured_thr;
+            rows.push_back(row);
+
+            for (const result *r : {&row.lat, &row.thr}) {
+                bench_output::record rec = to_record(*r, opt);
+                rec.benchmark = "proxy";
+                rec.set("via", via);
+                rec.set("test", r->has_latency ? "lat" : "thr");
+                rec.set("capture", opt.capture ? 1 : 0);
+                if (via == "batch") {
+                    const forward_stats &stats = r == &row.lat ? row.lat_stats : row.thr_stats;
+                    rec.set("batch", opt.batch);
+                    rec.set("busy_poll", opt.busy_poll ? 1 : 0);
+                    rec.config.emplace_back("mean_burst", bench_output::json_number(stats.mean_burst()));
+                }
+                if (opt.proxy_cpu >= 0) {
+                    rec.set("proxy_cpu", opt.proxy_cpu);
+                }
+                write_record(opt, rec);
+            }
+        }
+        if (opt.format == "text") {
+            print(std::cout, opt, size, rows);
+        }
+    }
+}
+
+}  // namespace zmqbench
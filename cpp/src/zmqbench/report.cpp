@@ -0,0 +1,177 @@
+#include "zmqbench/report.hpp"
+#include "zmqbench/data_path.hpp"
+
+#include <zmq.h>
+
+#include <iostream>
+
+namespace zmqbench {
+
+namespace {
+
+void print_trials(std::ostream &out, const result &r, const char *unit) {
+    if (!r.trials || r.trials->trials < 2) {
+        return;
+    }
+    const trial_summary &t = *r.trials;
+    out << "Trials: " << t.trials << " (" << t.rejected << " rejected as outliers), median reported\n";
+    out << static_cast<int>(t.confidence * 100 + 0.5) << "% CI: [" << t.ci_low << ", " << t.ci_high
+        << "] " << unit << " (width " << t.relative_width() << "% of median)\n";
+}
+
+void print_allocs(std::ostream &out, const result &r, const char *per) {
+    if (r.has_allocs) {
+        out << "Allocations: " << r.allocs_per_msg << " per " << per << "\n";
+    }
+}
+
+}  // namespace
+
+void print_result(std::ostream &out, const result &r) {
+    if (r.has_latency) {
+        out << "\n=== Latency Test Results ===\n";
+        out << "Message size: " << r.message_size << " bytes\n";
+        out << "Average latency: " << r.latency_us << " us\n";
+        out << "Latency percentiles (one-way): p50 " << r.latency.p50
+            << " us, p90 " << r.latency.p90
+            << " us, p99 " << r.latency.p99
+            << " us, p99.9 " << r.latency.p999
+            << " us, max " << r.latency.max << " us\n";
+        out << "Total elapsed time: " << r.elapsed_us << " us\n";
+        out << "Message rate: " << r.msg_per_sec << " msg/s\n";
+        print_allocs(out, r, "roundtrip");
+        print_trials(out, r, "us");
+        return;
+    }
+
+    double elapsed_sec = r.elapsed_us / 1000000.0;
+    out << "\n=== Throughput Test Results ===\n";
+    out << "Received: " << r.message_count << " messages\n";
+    out << "Message size: " << r.message_size << " bytes\n";
+    out << "Total data: " << (r.message_size * r.message_count / (1024.0 * 1024.0)) << " MB\n";
+    out << "Elapsed time: " << elapsed_sec << " seconds\n";
+    out << "Throughput: " << r.msg_per_sec << " msg/s\n";
+    out << "Throughput: " << r.megabits << " Mb/s\n";
+    if (r.end_to_end_msg_per_sec > 0.0) {
+        out << "End-to-end throughput: " << r.end_to_end_msg_per_sec << " msg/s\n";
+    }
+    print_allocs(out, r, "message");
+    print_trials(out, r, "msg/s");
+}
+
+std::string zmq_version_string() {
+    int major = 0, minor = 0, patch = 0;
+    zmq_version(&major, &minor, &patch);
+    return std::to_string(major) + "." + std::to_string(minor) + "." + std::to_string(patch);
+}
+
+bench_output::record to_record(const result &r, const options &opt) {
+    bench_output::record rec;
+    rec.benchmark = r.command;
+    rec.role = role_name(opt.role);
+    rec.transport = r.transport;
+    rec.endpoint = opt.endpoint;
+    rec.size = r.message_size;
+    rec.count = opt.count;
+    rec.elapsed_us = r.elapsed_us;
+    rec.binding = data_path::binding;
+    rec.zmq_version = zmq_version_string();
+
+    if (r.has_latency) {
+        rec.messages = r.message_count;
+        rec.latency_us = r.latency_us;
+        rec.min_us = r.latency.min;
+        rec.p50_us = r.latency.p50;
+        rec.p90_us = r.latency.p90;
+        rec.p99_us = r.latency.p99;
+        rec.p999_us = r.latency.p999;
+        rec.max_us = r.latency.max;
+        rec.samples = static_cast<long long>(r.latency.samples);
+    } else {
+        // The warm-up message is outside the timed window
+        rec.messages = r.message_count - 1;
+        rec.msg_per_sec = r.msg_per_sec;
+        rec.mbps = r.megabits;
+        if (r.end_to_end_msg_per_sec > 0.0) {
+            rec.end_to_end_msg_per_sec = r.end_to_end_msg_per_sec;
+        }
+    }
+
+    if (r.trials) {
+        rec.trials = static_cast<long long>(r.trials->trials);
+        rec.rejected_trials = static_cast<long long>(r.trials->rejected);
+        rec.ci_low = r.trials->ci_low;
+        rec.ci_high = r.trials->ci_high;
+        rec.confidence = r.trials->confidence;
+        rec.trial_values = r.trials->values;
+    }
+
+    rec.set("io_threads", opt.io_threads);
+    rec.set("sndhwm", opt.sockopts.sndhwm);
+    rec.set("rcvhwm", opt.sockopts.rcvhwm);
+    rec.set("sndbuf", opt.sockopts.sndbuf);
+    rec.set("rcvbuf", opt.sockopts.rcvbuf);
+    rec.set("persistent_server", opt.control.empty() ? 0 : 1);
+    rec.set("recv", opt.recv);
+    rec.set("mechanism", opt.mechanisms.empty() ? std::string("null") : opt.mechanisms.front());
+    if (opt.zap == "on") {
+        rec.set("zap", 1);
+    }
+    if (r.has_allocs) {
+        rec.config.emplace_back("allocs_per_msg", bench_output::json_number(r.allocs_per_msg));
+    }
+    if (opt.target_ci > 0.0) {
+        rec.config.emplace_back("target_ci", bench_output::json_number(opt.target_ci));
+        rec.set("max_trials", opt.max_trials);
+    }
+    return rec;
+}
+
+namespace {
+
+result_capture *active_capture = nullptr;
+
+}  // namespace
+
+result_capture::result_capture() : previous_(active_capture) {
+    active_capture = this;
+}
+
+result_capture::~result_capture() {
+    active_capture = previous_;
+}
+
+void write_record(const options &opt, const bench_output::record &rec) {
+    if (opt.format != "text") {
+        bench_output::environment env = bench_output::current_environment();
+        if (opt.format == "json") {
+            std::cout << bench_output::to_json(rec, env) << "\n";
+        } else {
+            static bool header_written = false;
+            if (!header_written) {
+                std::cout << bench_output::csv_header() << "\n";
+                header_written = true;
+            }
+            std::cout << bench_output::to_csv(rec, env) << "\n";
+        }
+        std::cout.flush();
+    }
+
+    if (!opt.output.empty() && !bench_output::append(opt.output, rec)) {
+        std::cerr << "Warning: could not write result record to " << opt.output << "\n";
+    }
+}
+
+void report(const options &opt, const result &r) {
+    if (active_capture != nullptr) {
+        active_capture->results_.push_back(r);
+        return;
+    }
+
+    if (opt.format == "text") {
+        print_result(std::cout, r);
+    }
+    write_record(opt, to_record(r, opt));
+}
+
+}  // namespace zmqbench
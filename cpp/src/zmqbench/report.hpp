@@ -0,0 +1,97 @@
+/*
+ * zmqbench - result records and their text output.
+ *
+ * The text format keeps the lines run_benchmark.sh and the cross-language
+ * scripts parse: "Average latency:", "Message rate:" and the two
+ * "Throughput:" lines (msg/s first, then Mb/s). JSON and CSV records come
+ * from bench_output.hpp.
+ */
+
+#ifndef ZMQBENCH_REPORT_HPP
+#define ZMQBENCH_REPORT_HPP
+
+#include "zmqbench/options.hpp"
+#include "zmqbench/stats.hpp"
+#include "bench_output.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace zmqbench {
+
+struct result {
+    std::string command;    // "lat", "thr", ...
+    std::string transport;  // endpoint scheme
+    size_t message_size = 0;
+    int message_count = 0;  // messages (thr) or roundtrips (lat) measured
+    double elapsed_us = 0.0;
+    double msg_per_sec = 0.0;
+    double megabits = 0.0;
+
+    // Sender clock from the first measured send to the receiver's completion
+    // reply over the control channel (persistent server only, thr)
+    double end_to_end_msg_per_sec = 0.0;
+
+    // Latency tests only: one-way latency (roundtrip / 2)
+    bool has_latency = false;
+    double latency_us = 0.0;
+    latency_summary latency;
+
+    // Heap allocations per message (per roundtrip for lat) in the timed
+    // window, counted with --allocs
+    bool has_allocs = false;
+    double allocs_per_msg = 0.0;
+
+    // Set when the headline value is the median of repeated trials; the
+    // other fields then come from the trial closest to that median
+    std::optional<trial_summary> trials;
+};
+
+// The value trials are compared on: one-way latency, or receiver msg/s
+inline double headline(const result &r) {
+    return r.has_latency ? r.latency_us : r.msg_per_sec;
+}
+
+void print_result(std::ostream &out, const result &r);
+
+// libzmq version of the loaded library, "major.minor.patch"
+std::string zmq_version_string();
+
+bench_output::record to_record(const result &r, const options &opt);
+
+// Writes a result in opt.format to stdout and appends it to opt.output,
+// unless a result_capture is active
+void report(const options &opt, const result &r);
+
+// Writes a record to stdout (json/csv formats) and appends it to opt.output
+void write_record(const options &opt, const bench_output::record &rec);
+
+// While alive, report() collects results here instead of writing them;
+// lets a command run another command and use its results
+class result_capture {
+public:
+    result_capture();
+    ~result_capture();
+    result_capture(const result_capture &) = delete;
+    result_capture &operator=(const result_capture &) = delete;
+
+    const std::vector<result> &results() const { return results_; }
+
+private:
+    friend void report(const options &opt, const result &r);
+
+    result_capture *previous_;
+    std::vector<result> results_;
+};
+
+// Setup chatter ("Listening on ...") only belongs in text output
+inline bool chatty(const options &opt) {
+    return opt.format == "text" && !opt.quiet;
+}
+
+}  // namespace zmqbench
+
+#endif  // ZMQBENCH_REPORT_HPP
@@ -0,0 +1,114 @@
+#include "zmqbench/router_echo.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <unistd.h>
+
+#include <fstream>
+#endif
+
+namespace zmqbench {
+
+usage process_usage() {
+    usage u;
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    long long size_pages = 0;
+    long long resident_pages = 0;
+    if (!(statm >> size_pages >> resident_pages)) {
+        return u;
+    }
+    u.rss_kb = resident_pages * (sysconf(_SC_PAGESIZE) / 1024);
+
+    DIR *dir = opendir("/proc/self/fd");
+    if (dir == nullptr) {
+        return u;
+    }
+    while (dirent *entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') {
+            u.fds++;
+        }
+    }
+    closedir(dir);
+    u.fds--;  // the descriptor of the listing itself
+    u.available = true;
+#endif
+    return u;
+}
+
+long long router_echo(zmq::socket_t &socket) {
+    usage baseline = process_usage();
+    std::vector<zmq::message_t> frames;
+    long long echoed = 0;
+
+    while (true) {
+        size_t parts = 0;
+        do {
+            if (parts == frames.size()) {
+                frames.emplace_back();
+            }
+            if (!socket.recv(frames[parts], zmq::recv_flags::none)) {
+                throw std::runtime_error("Failed to receive request " + std::to_string(echoed));
+            }
+            parts++;
+        } while (frames[parts - 1].more());
+
+        zmq::message_t &body = frames[parts - 1];
+        bool stop = false;
+        if (body.size() < sizeof(std::int64_t)) {
+            std::string verb = body.to_string();
+            control_message reply("usage");
+            if (verb == "stats") {
+                usage now = process_usage();
+                reply.fields["available"] = now.available ? "1" : "0";
+                reply.fields["rss_kb"] = std::to_string(now.rss_kb);
+                reply.fields["fds"] = std::to_string(now.fds);
+                reply.fields["base_rss_kb"] = std::to_string(baseline.rss_kb);
+                reply.fields["base_fds"] = std::to_string(baseline.fds);
+            } else if (verb == "stop") {
+                reply = control_message("bye");
+                stop = true;
+            } else {
+                reply = control_message("error");
+                reply.fields["message"] = "unknown request '" + verb + "'";
+            }
+            body = zmq::message_t(encode(reply));
+        } else {
+            echoed++;
+        }
+
+        for (size_t i = 0; i < parts; i++) {
+            zmq::send_flags flags = i + 1 < parts ? zmq::send_flags::sndmore : zmq::send_flags::none;
+            if (!socket.send(frames[i], flags)) {
+                throw std::runtime_error("Failed to send reply " + std::to_string(echoed));
+            }
+        }
+        if (stop) {
+            return echoed;
+        }
+    }
+}
+
+control_message ask(zmq::socket_t &socket, const std::string &verb, const char *expected) {
+    if (!socket.send(zmq::buffer(verb), zmq::send_flags::none)) {
+        throw std::runtime_error("Failed to send '" + verb + "' to the server");
+    }
+    zmq::message_t reply;
+    if (!socket.recv(reply, zmq::recv_flags::none)) {
+        throw std::runtime_error("no reply to '" + verb + "'");
+    }
+    control_message answer = decode(reply.to_string());
+    if (answer.verb == "error") {
+        throw std::runtime_error("server: " + answer.fields["message"]);
+    }
+    if (answer.verb != expected) {
+        throw std::runtime_error("unexpected reply '" + answer.verb + "' to '" + verb + "'");
+    }
+    return answer;
+}
+
+}  // namespace zmqbench
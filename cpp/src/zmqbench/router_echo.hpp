@@ -0,0 +1,44 @@
+/*
+ * zmqbench - ROUTER echo server shared by conns and connect.
+ *
+ * Every request is echoed to its sender, routing-id envelope included, so
+ * DEALER and REQ clients work alike. Requests shorter than 8 bytes (the
+ * send timestamp of every data message) are control verbs, not data:
+ *
+ *   stats  ->  usage available=0|1 rss_kb=N fds=N base_rss_kb=N base_fds=N
+ *   stop   ->  bye     and router_echo() returns
+ *
+ * The base_ fields are the process usage when router_echo() was entered.
+ */
+
+#ifndef ZMQBENCH_ROUTER_ECHO_HPP
+#define ZMQBENCH_ROUTER_ECHO_HPP
+
+#include "zmqbench/control.hpp"
+
+#include <zmq.hpp>
+
+#include <string>
+
+namespace zmqbench {
+
+// Resident memory and open file descriptors of this process (Linux only;
+// available is false elsewhere)
+struct usage {
+    bool available = false;
+    long long rss_kb = 0;
+    long long fds = 0;
+};
+
+usage process_usage();
+
+// Echoes requests until "stop"; returns the data requests echoed
+long long router_echo(zmq::socket_t &socket);
+
+// One control verb over a data connection; throws unless the reply is
+// `expected`
+control_message ask(zmq::socket_t &socket, const std::string &verb, const char *expected);
+
+}  // namespace zmqbench
+
+#endif  // ZMQBENCH_ROUTER_ECHO_HPP
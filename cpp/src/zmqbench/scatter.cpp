@@ -0,0 +1,408 @@
+/*
+ * zmqbench scatter - scatter-gather RPC and how its tail grows with fan-out.
+ *
+ * Each request goes to K echo servers at once and completes on the last
+ * reply, so its latency is the slowest of K. The servers echo like local_lat,
+ * each on its own thread, bound to sibling_endpoint(endpoint, k) for
+ * k = 0..K-1. They are ROUTER sockets that send the whole envelope back, as
+ * REP would; REP itself refuses ROUTER peers. The client gathers (--gather):
+ *
+ *   router   one ROUTER connected to all K, addressing each server by its
+ *            routing id
+ *   dealer   one DEALER per server, replies collected with zmq_poll
+ *
+ * Servers take a service time per request from --service-time, drawn from a
+ * fixed-seed generator per server:
+ *
+ *   none                 reply at once (default)
+ *   fixed:US             always US microseconds
+ *   uniform:MIN:MAX      uniform between MIN and MAX us
+ *   exp:MEAN             exponential with mean MEAN us
+ *   bimodal:US:SLOW:PCT  US, except PCT percent of requests take SLOW us
+ *
+ * They sleep rather than spin, so K servers do not compete for cores while
+ * "working"; sleeps shorter than the timer slack (tens of us) run long.
+ *
+ * Every K in --fanout (default 1..64) is run with fresh servers, after one
+ * untimed warm-up request; the report has the end-to-end percentiles per K
+ * and p99 relative to the first K. Everything is one process.
+ */
+
+#include "zmqbench/commands.hpp"
+#include "zmqbench/report.hpp"
+#include "zmqbench/stats.hpp"
+
+#include <zmq.hpp>
+#include <zmq_addon.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace zmqbench {
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// A parsed --service-time
+struct service_time {
+    std::string kind = "none";
+    double a = 0.0;
+    double b = 0.0;
+    double pct = 0.0;
+};
+
+service_time parse_service_time(const std::string &spec) {
+    std::vector<std::string> parts;
+    std::stringstream list(spec);
+    std::string item;
+    while (std::getline(list, item, ':')) {
+        parts.push_back(item);
+    }
+    auto number = [&](size_t i) {
+        char *end = nullptr;
+        double value = std::strtod(parts[i].c_str(), &end);
+        if (parts[i].empty() || *end != '\0' || value < 0.0) {
+            throw usage_error("--service-time: '" + parts[i] + "' is not a duration in us");
+        }
+        return value;
+    };
+
+    service_time st;
+    st.kind = parts.empty() ? "" : parts[0];
+    if (st.kind == "none" && parts.size() == 1) {
+        return st;
+    }
+    if (st.kind == "fixed" && parts.size() == 2) {
+        st.a = number(1);
+        return st;
+    }
+    if (st.kind == "uniform" && parts.size() == 3) {
+        st.a = number(1);
+        st.b = number(2);
+        if (st.b < st.a) {
+            throw usage_error("--service-time uniform:MIN:MAX needs MIN <= MAX");
+        }
+        return st;
+    }
+    if (st.kind == "exp" && parts.size() == 2) {
+        st.a = number(1);
+        return st;
+    }
+    if (st.kind == "bimodal" && parts.size() == 4) {
+        st.a = number(1);
+        st.b = number(2);
+        st.pct = number(3);
+        if (st.pct > 100.0) {
+            throw usage_error("--service-time bimodal:US:SLOW:PCT needs PCT <= 100");
+        }
+        return st;
+    }
+    throw usage_error("--service-time must be none, fixed:US, uniform:MIN:MAX, exp:MEAN or "
+                      "bimodal:US:SLOW:PCT, got '" + spec + "'");
+}
+
+// Draws service times for one server
+class service_clock {
+public:
+    service_clock(const service_time &st, unsigned seed) : st_(st), engine_(seed) {}
+
+    std::chrono::microseconds next() {
+        double us = 0.0;
+        if (st_.kind == "fixed") {
+            us = st_.a;
+        } else if (st_.kind == "uniform") {
+            us = std::uniform_real_distribution<double>(st_.a, st_.b)(engine_);
+        } else if (st_.kind == "exp") {
+            us = st_.a > 0.0 ? std::exponential_distribution<double>(1.0 / st_.a)(engine_) : 0.0;
+        } else if (st_.kind == "bimodal") {
+            us = std::uniform_real_distribution<double>(0.0, 100.0)(engine_) < st_.pct ? st_.b : st_.a;
+        }
+        return std::chrono::microseconds(static_cast<long long>(us));
+    }
+
+private:
+    service_time st_;
+    std::mt19937 engine_;
+};
+
+std::string server_id(size_t k) { return "zmqbench-scatter-" + std::to_string(k); }
+
+// One local_lat-style echo server, with a service time per request
+void run_server(zmq::context_t &context, const options &opt, size_t k, const service_time &st) {
+    zmq::socket_t socket(context, zmq::socket_type::router);
+    configure(socket, opt.sockopts);
+    socket.set(zmq::sockopt::routing_id, server_id(k));
+    bind_with_retry(socket, sibling_endpoint(opt.endpoint, static_cast<int>(k)));
+    service_clock clock(st, static_cast<unsigned>(k + 1));
+
+    while (true) {
+        frames request = recv_frames(socket);
+        auto received = clock_type::now();
+        std::chrono::microseconds delay = clock.next();
+        if (delay.count() > 0) {
+            std::this_thread::sleep_until(received + delay);
+        }
+        // Peer id, "" and body all go back unchanged
+        send_frames(socket, request);
+    }
+}
+
+// The client side: sends one request to every server, returns on the last reply
+class gatherer {
+public:
+    virtual ~gatherer() = default;
+    virtual void scatter(const std::vector<char> &body) = 0;
+};
+
+class router_gatherer : public gatherer {
+public:
+    router_gatherer(zmq::context_t &context, const options &opt, size_t fanout)
+        : socket_(context, zmq::socket_type::router), fanout_(fanout) {
+        configure(socket_, opt.sockopts);
+        // After a failed run, requests queued for a dead server must not
+        // hold up closing the context
+        socket_.set(zmq::sockopt::linger, 0);
+        socket_.set(zmq::sockopt::router_mandatory, true);
+        for (size_t k = 0; k < fanout; k++) {
+            ids_.push_back(server_id(k));
+            // Name the peer locally so replies and sends use a known id
+            socket_.set(zmq::sockopt::connect_routing_id, ids_.back());
+            socket_.connect(sibling_endpoint(opt.endpoint, static_cast<int>(k)));
+        }
+    }
+
+    // Waits until the ROUTER knows every server, then gathers once
+    void warm_up(const std::vector<char> &body) {
+        auto deadline = clock_type::now() + std::chrono::seconds(10);
+        for (const std::string &id : ids_) {
+            while (true) {
+                try {
+                    send_one(id, body);
+                    break;
+                } catch (const zmq::error_t &e) {
+                    if (e.num() != EHOSTUNREACH || clock_type::now() > deadline) {
+                        throw;
+                    }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+        }
+        gather();
+    }
+
+    void scatter(const std::vector<char> &body) override {
+        for (const std::string &id : ids_) {
+            send_one(id, body);
+        }
+        gather();
+    }
+
+private:
+    // id "" body, the envelope a REQ would send
+    void send_one(const std::string &id, const std::vector<char> &body) {
+        if (!socket_.send(zmq::buffer(id), zmq::send_flags::sndmore) ||
+            !socket_.send(zmq::const_buffer(), zmq::send_flags::sndmore) ||
+            !socket_.send(zmq::buffer(body), zmq::send_flags::none)) {
+            throw std::runtime_error("Failed to send to " + id);
+        }
+    }
+
+    void gather() {
+        for (size_t received = 0; received < fanout_; received++) {
+            reply_.clear();
+            if (!zmq::recv_multipart(socket_, std::back_inserter(reply_))) {
+                throw std::runtime_error("Failed to receive a reply");
+            }
+        }
+    }
+
+    zmq::socket_t socket_;
+    size_t fanout_;
+    std::vector<std::string> ids_;
+    std::vector<zmq::message_t> reply_;
+};
+
+class dealer_gatherer : public gatherer {
+public:
+    dealer_gatherer(zmq::context_t &context, const options &opt, size_t fanout) {
+        for (size_t k = 0; k < fanout; k++) {
+            sockets_.emplace_back(context, zmq::socket_type::dealer);
+            configure(sockets_.back(), opt.sockopts);
+            sockets_.back().set(zmq::sockopt::linger, 0);  // as for the ROUTER
+            sockets_.back().connect(sibling_endpoint(opt.endpoint, static_cast<int>(k)));
+            items_.push_back({sockets_.back().handle(), 0, ZMQ_POLLIN, 0});
+        }
+    }
+
+    void scatter(const std::vector<char> &body) override {
+        for (zmq::socket_t &socket : sockets_) {
+            // "" body, the envelope a REQ would send
+            if (!socket.send(zmq::const_buffer(), zmq::send_flags::sndmore) ||
+                !socket.send(zmq::buffer(body), zmq::send_flags::none)) {
+                throw std::runtime_error("Failed to send");
+            }
+        }
+        size_t pending = sockets_.size();
+        while (pending > 0) {
+            if (zmq_poll(items_.data(), static_cast<int>(items_.size()), -1) < 0) {
+                throw zmq::error_t();
+            }
+            for (size_t k = 0; k < items_.size(); k++) {
+                if (items_[k].revents & ZMQ_POLLIN) {
+                    reply_.clear();
+                    (void)zmq::recv_multipart(sockets_[k], std::back_inserter(reply_));
+                    pending--;
+                }
+            }
+        }
+    }
+
+private:
+    std::vector<zmq::socket_t> sockets_;
+    std::vector<zmq_pollitem_t> items_;
+    std::vector<zmq::message_t> reply_;
+};
+
+struct scatter_result {
+    std::string gather;
+    size_t fanout = 0;
+    size_t size = 0;
+    int requests = 0;
+    double elapsed_us = 0.0;
+    latency_summary latency;
+
+    double requests_per_sec() const { return requests / (elapsed_us / 1000000.0); }
+};
+
+scatter_result run_once(const options &opt, const std::string &gather, size_t fanout, size_t size,
+                        const service_time &st) {
+    zmq::context_t context(opt.io_threads);
+
+    first_error errors(context);
+    std::vector<std::thread> servers;
+    for (size_t k = 0; k < fanout; k++) {
+        servers.emplace_back(errors.guarded([&, k]() { run_server(context, opt, k, st); }));
+    }
+
+    scatter_result r;
+    r.gather = gather;
+    r.fanout = fanout;
+    r.size = size;
+    r.requests = opt.count;
+    errors.guarded([&]() {
+        std::vector<char> body(size, 'X');
+        std::unique_ptr<gatherer> client;
+        if (gather == "router") {
+            auto router = std::make_unique<router_gatherer>(context, opt, fanout);
+            router->warm_up(body);
+            client = std::move(router);
+        } else {
+            client = std::make_unique<dealer_gatherer>(context, opt, fanout);
+            client->scatter(body);
+        }
+
+        std::vector<double> samples;
+        samples.reserve(static_cast<size_t>(opt.count));
+        auto start = clock_type::now();
+        for (int i = 0; i < opt.count; i++) {
+            auto sent = clock_type::now();
+            client->scatter(body);
+            samples.push_back(std::chrono::duration<double, std::micro>(clock_type::now() - sent).count());
+        }
+        r.elapsed_us = std::chrono::duration<double, std::micro>(clock_type::now() - start).count();
+        r.latency = summarize(samples);
+    })();
+
+    context.shutdown();
+    for (std::thread &server : servers) {
+        server.join();
+    }
+    errors.rethrow();
+    return r;
+}
+
+void print(std::ostream &out, const options &opt, const std::string &gather, size_t size,
+           const std::vector<scatter_result> &rows) {
+    out << "\n=== Scatter-Gather Results ===\n";
+    out << "Gather: " << (gather == "router" ? "one ROUTER to K servers" : "one DEALER per server") << "\n";
+    out << "Message size: " << size << " bytes\n";
+    out << "Service time: " << opt.service_time << "\n";
+    out << "Requests: " << opt.count << " per fan-out\n";
+    out << std::setw(5) << "K" << std::setw(12) << "Requests/s" << std::setw(11) << "Mean (us)"
+        << std::setw(11) << "p50 (us)" << std::setw(11) << "p90 (us)" << std::setw(11) << "p99 (us)"
+        << std::setw(13) << "p99.9 (us)" << std::setw(12)
+        << "p99 vs K=" + std::to_string(rows.front().fanout) << "\n";
+    out << std::fixed;
+    const scatter_result &single = rows.front();
+    for (const scatter_result &r : rows) {
+        std::ostringstream ratio;
+        ratio << std::fixed << std::setprecision(2) << r.latency.p99 / single.latency.p99 << "x";
+        out << std::setw(5) << r.fanout << std::setw(12) << std::setprecision(0) << r.requests_per_sec()
+            << std::setprecision(2) << std::setw(11) << r.latency.mean << std::setw(11) << r.latency.p50
+            << std::setw(11) << r.latency.p90 << std::setw(11) << r.latency.p99 << std::setw(13)
+            << r.latency.p999 << std::setw(12) << ratio.str() << "\n";
+    }
+    out << std::defaultfloat << std::setprecision(6);
+    out << "Latency is request -> last of K replies\n";
+}
+
+bench_output::record scatter_record(const options &opt, const scatter_result &r) {
+    result as_result;
+    as_result.command = "scatter";
+    as_result.transport = transport_of(opt.endpoint);
+    as_result.message_size = r.size;
+    as_result.message_count = r.requests;
+    as_result.elapsed_us = r.elapsed_us;
+    as_result.has_latency = true;
+    as_result.latency_us = r.latency.mean;
+    as_result.latency = r.latency;
+
+    bench_output::record rec = to_record(as_result, opt);
+    rec.msg_per_sec = r.requests_per_sec();
+    rec.set("gather", r.gather);
+    rec.set("fanout", static_cast<int>(r.fanout));
+    rec.set("service_time", opt.service_time);
+    return rec;
+}
+
+}  // namespace
+
+void run_scatter(const options &opt) {
+    if (opt.role != role::both || !opt.control.empty()) {
+        throw usage_error("scatter runs client and servers in one process (no --role or --control)");
+    }
+    service_time st = parse_service_time(opt.service_time);
+    raise_fd_limit();
+
+    for (size_t size : opt.sizes) {
+        for (const std::string &gather : opt.gathers) {
+            std::vector<scatter_result> rows;
+            for (size_t fanout : opt.fanouts) {
+                if (chatty(opt)) {
+                    std::cout << "Running K=" << fanout << " (" << gather << ") with " << size
+                              << " byte messages...\n";
+                }
+                scatter_result r = run_once(opt, gather, fanout, size, st);
+                write_record(opt, scatter_record(opt, r));
+                rows.push_back(r);
+            }
+            if (opt.format == "text") {
+                print(std::cout, opt, gather, size, rows);
+            }
+        }
+    }
+}
+
+}  // namespace zmqbench
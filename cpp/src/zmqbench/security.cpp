@@ -0,0 +1,154 @@
+#include "zmqbench/security.hpp"
+#include "zmqbench/commands.hpp"
+
+#include <stdexcept>
+
+namespace zmqbench {
+
+namespace {
+
+const char *const zap_endpoint = "inproc://zeromq.zap.01";
+const char *const zap_domain = "zmqbench";
+const char *const plain_username = "zmqbench";
+const char *const plain_password = "zmqbench";
+
+}  // namespace
+
+bool curve_available() {
+    return zmq_has("curve") != 0;
+}
+
+curve_keypair make_curve_keypair() {
+    if (!curve_available()) {
+        throw std::runtime_error("libzmq was built without CURVE support (libsodium)");
+    }
+    char public_key[41];
+    char secret_key[41];
+    if (zmq_curve_keypair(public_key, secret_key) != 0) {
+        throw zmq::error_t();
+    }
+    return {public_key, secret_key};
+}
+
+security_setup resolve_security(const options &opt) {
+    security_setup setup;
+    if (opt.mechanisms.size() > 1) {
+        throw usage_error(opt.command + " takes one --mechanism");
+    }
+    if (!opt.mechanisms.empty()) {
+        setup.mechanism = opt.mechanisms.front();
+    }
+    if (opt.zap == "both") {
+        throw usage_error(opt.command + " takes --zap on or off");
+    }
+    setup.zap = opt.zap == "on";
+
+    // libzmq leaves checking PLAIN credentials to ZAP
+    if (setup.mechanism == "plain" && !setup.zap) {
+        throw usage_error("plain needs a ZAP handler (--zap on)");
+    }
+    if (setup.mechanism != "curve") {
+        return setup;
+    }
+
+    if (opt.role != role::client) {
+        setup.server_keys = make_curve_keypair();
+        setup.server_key = setup.server_keys.public_key;
+    } else {
+        setup.server_key = opt.curve_serverkey;
+    }
+    if (opt.role != role::server) {
+        setup.client_keys = make_curve_keypair();
+    }
+    if (setup.server_key.empty() && opt.control.empty()) {
+        throw usage_error("curve needs --curve-serverkey (printed by the server at startup)");
+    }
+    return setup;
+}
+
+std::vector<std::string> available_mechanisms() {
+    std::vector<std::string> mechanisms = {"null", "plain"};
+    if (curve_available()) {
+        mechanisms.push_back("curve");
+    }
+    return mechanisms;
+}
+
+void secure_server(zmq::socket_t &socket, const std::string &mechanism, const curve_keypair &keys,
+                   bool zap) {
+    if (zap) {
+        socket.set(zmq::sockopt::zap_domain, zap_domain);
+    }
+    if (mechanism == "plain") {
+        socket.set(zmq::sockopt::plain_server, 1);
+    } else if (mechanism == "curve") {
+        socket.set(zmq::sockopt::curve_server, 1);
+        socket.set(zmq::sockopt::curve_secretkey, keys.secret_key);
+    }
+}
+
+void secure_client(zmq::socket_t &socket, const std::string &mechanism,
+                   const std::string &server_key, const curve_keypair &keys) {
+    if (mechanism == "plain") {
+        socket.set(zmq::sockopt::plain_username, plain_username);
+        socket.set(zmq::sockopt::plain_password, plain_password);
+    } else if (mechanism == "curve") {
+        socket.set(zmq::sockopt::curve_serverkey, server_key);
+        socket.set(zmq::sockopt::curve_publickey, keys.public_key);
+        socket.set(zmq::sockopt::curve_secretkey, keys.secret_key);
+    }
+}
+
+zap_handler::zap_handler(zmq::context_t &context) : socket_(context, zmq::socket_type::rep) {
+    socket_.set(zmq::sockopt::linger, 0);
+    bind_with_retry(socket_, zap_endpoint);
+    thread_ = std::thread([this]() { run(); });
+}
+
+zap_handler::~zap_handler() {
+    stop_ = true;
+    thread_.join();
+}
+
+// Request: version, request id, domain, address, routing id, mechanism,
+// credentials... Reply: version, request id, status code and text, user id,
+// metadata.
+void zap_handler::run() {
+    try {
+        std::vector<zmq::message_t> request;
+        while (!stop_) {
+            // Wakes up now and then to notice stop_
+            zmq_pollitem_t item = {socket_.handle(), 0, ZMQ_POLLIN, 0};
+            int ready = zmq_poll(&item, 1, 100);
+            if (ready < 0) {
+                throw zmq::error_t();
+            }
+            if (ready == 0) {
+                continue;
+            }
+
+            request.clear();
+            do {
+                request.emplace_back();
+                if (!socket_.recv(request.back(), zmq::recv_flags::none)) {
+                    return;
+                }
+            } while (request.back().more());
+            if (request.size() < 2) {
+                continue;
+            }
+
+            socket_.send(zmq::str_buffer("1.0"), zmq::send_flags::sndmore);
+            socket_.send(request[1], zmq::send_flags::sndmore);
+            socket_.send(zmq::str_buffer("200"), zmq::send_flags::sndmore);
+            socket_.send(zmq::str_buffer("OK"), zmq::send_flags::sndmore);
+            socket_.send(zmq::str_buffer(""), zmq::send_flags::sndmore);
+            socket_.send(zmq::str_buffer(""), zmq::send_flags::none);
+            requests_++;
+        }
+    } catch (const zmq::error_t &) {
+        // Context shut down: the benchmark is failing, the caller reports why
+    }
+}
+
+}  // namespace zmqbench
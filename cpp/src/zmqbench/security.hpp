@@ -0,0 +1,87 @@
+/*
+ * zmqbench - security mechanisms of data connections.
+ *
+ *   null    no authentication, no encryption (the libzmq default)
+ *   plain   username/password in clear text (fixed benchmark credentials)
+ *   curve   CurveZMQ handshake and per-message encryption (libsodium);
+ *           keypairs are generated in process with zmq_curve_keypair
+ *
+ * The server side is configured before bind. With a ZAP handler running in
+ * the server's context every handshake is also authenticated over ZAP; the
+ * handler accepts everyone, so only the cost of the exchange is measured.
+ */
+
+#ifndef ZMQBENCH_SECURITY_HPP
+#define ZMQBENCH_SECURITY_HPP
+
+#include "zmqbench/options.hpp"
+
+#include <zmq.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace zmqbench {
+
+// Z85-encoded, 40 characters each
+struct curve_keypair {
+    std::string public_key;
+    std::string secret_key;
+};
+
+// Security of one lat/thr run: one mechanism, ZAP on or off, and the keys
+// this process needs for its role(s)
+struct security_setup {
+    std::string mechanism = "null";
+    bool zap = false;
+    curve_keypair server_keys;  // curve, unless the role is client
+    curve_keypair client_keys;  // curve, unless the role is server
+    std::string server_key;     // the client's --curve-serverkey, or ours
+};
+
+// Generates the keys; throws usage_error for settings that cannot run. A
+// client of a persistent server gets server_key from the "ready" reply.
+security_setup resolve_security(const options &opt);
+
+// Whether the loaded libzmq was built with CURVE support
+bool curve_available();
+
+// Throws std::runtime_error without CURVE support
+curve_keypair make_curve_keypair();
+
+// null, plain, and curve when the loaded libzmq supports it
+std::vector<std::string> available_mechanisms();
+
+// Server side; zap also sets a ZAP domain, which NULL needs to ask the handler
+void secure_server(zmq::socket_t &socket, const std::string &mechanism, const curve_keypair &keys,
+                   bool zap);
+
+// Client side; server_key is the server's public key (curve only)
+void secure_client(zmq::socket_t &socket, const std::string &mechanism,
+                   const std::string &server_key, const curve_keypair &keys);
+
+// Answers ZAP requests with "200 OK" on its own thread, from construction
+// until destruction; bound to inproc://zeromq.zap.01 of the given context
+class zap_handler {
+public:
+    explicit zap_handler(zmq::context_t &context);
+    ~zap_handler();
+    zap_handler(const zap_handler &) = delete;
+    zap_handler &operator=(const zap_handler &) = delete;
+
+    long long requests() const { return requests_; }
+
+private:
+    void run();
+
+    zmq::socket_t socket_;
+    std::atomic<bool> stop_{false};
+    std::atomic<long long> requests_{0};
+    std::thread thread_;
+};
+
+}  // namespace zmqbench
+
+#endif  // ZMQBENCH_SECURITY_HPP
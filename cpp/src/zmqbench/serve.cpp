@@ -0,0 +1,181 @@
+/*
+ * zmqbench serve / stop - long-lived benchmark server.
+ *
+ * `serve` binds a REP control socket and runs whatever tests clients ask
+ * for on its data endpoint (see control.hpp for the exchange). The data
+ * socket is kept across tests while the command, socket options and security
+ * stay the same, so a sweep reuses one connection; it is rebuilt when they
+ * change or after a failed test. The server's CURVE keypair is generated at
+ * startup and its public key sent with "ready". No fixed sleeps: readiness
+ * and completion are both confirmed over the control channel.
+ *
+ * A test fails when the data socket receives nothing for data_timeout_ms, so
+ * a client that dies mid-test does not leave the server stuck; the control
+ * socket is free again and `stop` still reaches it.
+ *
+ * `stop` sends "stop" to a running server.
+ */
+
+#include "zmqbench/commands.hpp"
+#include "zmqbench/control.hpp"
+#include "zmqbench/security.hpp"
+
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace zmqbench {
+
+namespace {
+
+// Longest gap between messages within a test
+constexpr int data_timeout_ms = 10000;
+
+}  // namespace
+
+void run_serve(const options &opt) {
+    if (opt.control.empty()) {
+        throw usage_error("serve needs --control");
+    }
+
+    zmq::context_t context(opt.io_threads);
+    zmq::socket_t control(context, zmq::socket_type::rep);
+    control.bind(opt.control);
+
+    std::cout << "Control on " << opt.control << "\n";
+    std::cout << "Data on " << opt.endpoint << "\n";
+
+    auto reply = [&](const control_message &msg) {
+        control.send(zmq::buffer(encode(msg)), zmq::send_flags::none);
+    };
+
+    curve_keypair keys;
+    if (curve_available()) {
+        keys = make_curve_keypair();
+    }
+
+    // Data socket and the settings it was created with; the ZAP handler
+    // lives as long as a data socket that asks it
+    std::unique_ptr<zap_handler> zap;
+    zmq::socket_t data;
+    std::string data_command;
+    socket_options data_sockopts;
+    std::string data_mechanism;
+    bool data_zap = false;
+
+    test_spec spec;
+    const session *current = nullptr;
+    served outcome;
+    std::string failure;
+
+    while (true) {
+        zmq::message_t request;
+        if (!control.recv(request, zmq::recv_flags::none)) {
+            continue;
+        }
+
+        try {
+            control_message msg = decode(request.to_string());
+
+            if (msg.verb == "spec") {
+                spec = decode_spec(msg);
+                const command *cmd = find_command(spec.command);
+                if (cmd == nullptr || cmd->persistent == nullptr) {
+                    throw std::runtime_error("command '" + spec.command + "' cannot run under serve");
+                }
+
+                if (data.handle() == nullptr || spec.command != data_command ||
+                    spec.sockopts != data_sockopts || spec.mechanism != data_mechanism ||
+                    spec.zap != data_zap) {
+                    data.close();
+                    zap.reset();
+                    if (spec.zap) {
+                        zap = std::make_unique<zap_handler>(context);
+                    }
+                    data = zmq::socket_t(context, cmd->persistent->server_type);
+                    configure(data, spec.sockopts);
+                    data.set(zmq::sockopt::rcvtimeo, data_timeout_ms);
+                    secure_server(data, spec.mechanism, keys, spec.zap);
+                    bind_with_retry(data, opt.endpoint);
+                    data_command = spec.command;
+                    data_sockopts = spec.sockopts;
+                    data_mechanism = spec.mechanism;
+                    data_zap = spec.zap;
+                }
+                current = cmd->persistent;
+
+                control_message ready("ready");
+                if (spec.mechanism == "curve") {
+                    ready.fields["curve_serverkey"] = keys.public_key;
+                }
+                reply(ready);
+
+            } else if (msg.verb == "start") {
+                if (current == nullptr) {
+                    throw std::runtime_error("start without a spec");
+                }
+
+                bool primed = false;
+                failure.clear();
+                try {
+                    outcome = current->serve(data, spec, [&]() {
+                        reply(control_message("started"));
+                        primed = true;
+                    });
+                } catch (const std::exception &e) {
+                    // Socket state is unknown after a failed test
+                    data.close();
+                    current = nullptr;
+                    if (!primed) {
+                        throw;
+                    }
+                    failure = e.what();
+                }
+
+                if (failure.empty()) {
+                    std::cout << spec.command << " " << spec.message_size << " bytes: "
+                              << outcome.received << " messages";
+                    if (outcome.measured) {
+                        std::cout << ", " << outcome.measured->msg_per_sec << " msg/s";
+                    }
+                    std::cout << "\n";
+                } else {
+                    std::cerr << "Error: " << failure << "\n";
+                }
+
+            } else if (msg.verb == "finish") {
+                if (!failure.empty()) {
+                    throw std::runtime_error(failure);
+                }
+                reply(encode_served(outcome));
+
+            } else if (msg.verb == "stop") {
+                reply(control_message("bye"));
+                break;
+
+            } else {
+                throw std::runtime_error("unknown control request '" + msg.verb + "'");
+            }
+        } catch (const std::exception &e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            control_message error("error");
+            error.fields["message"] = e.what();
+            reply(error);
+        }
+    }
+
+    std::cout << "Stopped.\n";
+}
+
+void run_stop(const options &opt) {
+    if (opt.control.empty()) {
+        throw usage_error("stop needs --control");
+    }
+
+    zmq::context_t context(1);
+    control_client client(context, opt.control);
+    client.stop();
+}
+
+}  // namespace zmqbench
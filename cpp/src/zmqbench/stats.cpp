@@ -0,0 +1,113 @@
+#include "zmqbench/stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+namespace zmqbench {
+
+double percentile(const std::vector<double> &sorted, double q) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(std::ceil(q * static_cast<double>(sorted.size())));
+    if (rank > 0) {
+        rank--;
+    }
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+latency_summary summarize(std::vector<double> samples) {
+    latency_summary summary;
+    if (samples.empty()) {
+        return summary;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    summary.samples = samples.size();
+    summary.min = samples.front();
+    summary.max = samples.back();
+    summary.mean = std::accumulate(samples.begin(), samples.end(), 0.0) /
+                   static_cast<double>(samples.size());
+    summary.p50 = percentile(samples, 0.50);
+    summary.p90 = percentile(samples, 0.90);
+    summary.p99 = percentile(samples, 0.99);
+    summary.p999 = percentile(samples, 0.999);
+    return summary;
+}
+
+namespace {
+
+double median_of_sorted(const std::vector<double> &sorted) {
+    size_t n = sorted.size();
+    return n % 2 == 1 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2.0;
+}
+
+}  // namespace
+
+double trial_summary::relative_width() const {
+    return median != 0.0 ? (ci_high - ci_low) / std::fabs(median) * 100.0 : 0.0;
+}
+
+std::vector<double> reject_outliers(const std::vector<double> &values) {
+    if (values.size() < 4) {
+        return values;
+    }
+
+    std::vector<double> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    double q1 = percentile(sorted, 0.25);
+    double q3 = percentile(sorted, 0.75);
+    double fence = 1.5 * (q3 - q1);
+
+    std::vector<double> kept;
+    for (double v : values) {
+        if (v >= q1 - fence && v <= q3 + fence) {
+            kept.push_back(v);
+        }
+    }
+    return kept;
+}
+
+trial_summary summarize_trials(const std::vector<double> &values, double confidence,
+                               size_t resamples) {
+    trial_summary summary;
+    summary.trials = values.size();
+    summary.confidence = confidence;
+    summary.values = values;
+    if (values.empty()) {
+        return summary;
+    }
+
+    std::vector<double> kept = reject_outliers(values);
+    summary.rejected = values.size() - kept.size();
+    std::sort(kept.begin(), kept.end());
+    summary.median = median_of_sorted(kept);
+    summary.ci_low = summary.median;
+    summary.ci_high = summary.median;
+    if (kept.size() < 2) {
+        return summary;
+    }
+
+    std::mt19937_64 rng(0x5eed);
+    std::uniform_int_distribution<size_t> pick(0, kept.size() - 1);
+    std::vector<double> medians;
+    medians.reserve(resamples);
+    std::vector<double> resample(kept.size());
+    for (size_t b = 0; b < resamples; b++) {
+        for (double &v : resample) {
+            v = kept[pick(rng)];
+        }
+        std::sort(resample.begin(), resample.end());
+        medians.push_back(median_of_sorted(resample));
+    }
+
+    std::sort(medians.begin(), medians.end());
+    double tail = (1.0 - confidence) / 2.0;
+    summary.ci_low = percentile(medians, tail);
+    summary.ci_high = percentile(medians, 1.0 - tail);
+    return summary;
+}
+
+}  // namespace zmqbench
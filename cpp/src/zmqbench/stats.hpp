@@ -0,0 +1,58 @@
+/*
+ * zmqbench - latency sample statistics and repeated-trial summaries.
+ *
+ * A trial summary describes one headline value (latency or msg/s) measured
+ * several times: Tukey-fence outliers are dropped, the median of the rest is
+ * reported with a percentile-bootstrap confidence interval.
+ */
+
+#ifndef ZMQBENCH_STATS_HPP
+#define ZMQBENCH_STATS_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace zmqbench {
+
+struct latency_summary {
+    size_t samples = 0;
+    double min = 0.0;
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double p999 = 0.0;
+    double max = 0.0;
+};
+
+// Nearest-rank percentile of an ascending-sorted sample set, q in [0, 1]
+double percentile(const std::vector<double> &sorted, double q);
+
+// Sorts its own copy of the samples
+latency_summary summarize(std::vector<double> samples);
+
+struct trial_summary {
+    size_t trials = 0;    // trials run
+    size_t rejected = 0;  // dropped as outliers
+    double median = 0.0;  // of the kept trials
+    double ci_low = 0.0;
+    double ci_high = 0.0;
+    double confidence = 0.95;
+    std::vector<double> values;  // every trial, in run order, outliers included
+
+    // CI width relative to the median, in percent
+    double relative_width() const;
+};
+
+// Drops values outside [Q1 - 1.5 IQR, Q3 + 1.5 IQR]; needs 4+ values,
+// fewer are returned unchanged
+std::vector<double> reject_outliers(const std::vector<double> &values);
+
+// Percentile-bootstrap CI of the median. Fixed seed, so the same trials
+// always give the same interval.
+trial_summary summarize_trials(const std::vector<double> &values, double confidence = 0.95,
+                               size_t resamples = 2000);
+
+}  // namespace zmqbench
+
+#endif  // ZMQBENCH_STATS_HPP
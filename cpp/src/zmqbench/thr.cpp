@@ -0,0 +1,221 @@
+/*
+ * zmqbench thr - one-way throughput over PUSH/PULL.
+ *
+ * Client: PUSH sends N messages per size. Server: PULL receives them and
+ * times from the first message (warm-up) to the last, as in local_thr.
+ * No sleeps around the send loop: PUSH queues until the connection is up
+ * and the context's default linger flushes the tail before exit.
+ *
+ * Against a persistent server the first message doubles as the readiness
+ * probe: the server answers "start" only after it has arrived, and the
+ * sender's clock runs until the server confirms the last one.
+ *
+ * --recv buffer receives into one preallocated buffer instead of a message
+ * per call; --allocs counts the receiver process's heap allocations per
+ * message over the timed window. --mechanism curve encrypts every message
+ * (security.hpp); the handshake falls within the warm-up.
+ */
+
+#include "zmqbench/alloc_count.hpp"
+#include "zmqbench/commands.hpp"
+#include "zmqbench/control.hpp"
+#include "zmqbench/data_path.hpp"
+#include "zmqbench/report.hpp"
+#include "zmqbench/security.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace zmqbench {
+
+namespace {
+
+using clock_type = std::chrono::high_resolution_clock;
+
+template <typename Inbox>
+served receive(zmq::socket_t &socket, const test_spec &spec, const std::function<void()> &primed,
+               Inbox &message) {
+    auto recv_one = [&](int i) {
+        if (!message.recv(socket)) {
+            throw std::runtime_error("Failed to receive message " + std::to_string(i));
+        }
+        if (message.truncated()) {
+            throw std::runtime_error("Message " + std::to_string(i) + " truncated: " +
+                                     std::to_string(message.size()) + " bytes into a " +
+                                     std::to_string(spec.message_size) + " byte buffer");
+        }
+        if (message.size() != spec.message_size) {
+            throw std::runtime_error("Message size mismatch at message " + std::to_string(i) +
+                                     ". Expected " + std::to_string(spec.message_size) + ", got " +
+                                     std::to_string(message.size()));
+        }
+    };
+
+    // Start timing after the first message (warm-up)
+    recv_one(0);
+    if (spec.count_allocs) {
+        alloc_count::enable();
+    }
+    primed();
+    unsigned long long allocs_before = alloc_count::total();
+    auto start = clock_type::now();
+
+    for (int i = 1; i < spec.message_count; i++) {
+        recv_one(i);
+    }
+
+    auto end = clock_type::now();
+    unsigned long long allocs = alloc_count::total() - allocs_before;
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    result r;
+    r.command = "thr";
+    r.message_size = spec.message_size;
+    r.message_count = spec.message_count;
+    r.elapsed_us = static_cast<double>(elapsed);
+    r.msg_per_sec = static_cast<double>(spec.message_count - 1) / (r.elapsed_us / 1000000.0);
+    r.megabits = (r.msg_per_sec * spec.message_size * 8) / 1000000.0;
+    if (spec.count_allocs) {
+        r.has_allocs = true;
+        r.allocs_per_msg = static_cast<double>(allocs) / (spec.message_count - 1);
+    }
+
+    served outcome;
+    outcome.received = spec.message_count;
+    outcome.measured = r;
+    return outcome;
+}
+
+served serve(zmq::socket_t &socket, const test_spec &spec, const std::function<void()> &primed) {
+    if (spec.recv == "buffer") {
+        data_path::buffer_inbox message(spec.message_size);
+        return receive(socket, spec, primed, message);
+    }
+    data_path::inbox message;
+    return receive(socket, spec, primed, message);
+}
+
+void send(zmq::socket_t &socket, const std::vector<char> &buffer, int message_count) {
+    for (int i = 0; i < message_count; i++) {
+        if (!data_path::send_copy(socket, buffer.data(), buffer.size())) {
+            throw std::runtime_error("Failed to send message " + std::to_string(i));
+        }
+    }
+}
+
+}  // namespace
+
+const session thr_session = {zmq::socket_type::pull, serve};
+
+void run_thr(const options &opt) {
+    check_control_role(opt);
+    std::string transport = transport_of(opt.endpoint);
+    security_setup security = resolve_security(opt);
+
+    auto server = [&](zmq::context_t &context, bool verbose) {
+        std::unique_ptr<zap_handler> zap;
+        if (security.zap) {
+            zap = std::make_unique<zap_handler>(context);
+        }
+        zmq::socket_t socket(context, zmq::socket_type::pull);
+        configure(socket, opt.sockopts);
+        secure_server(socket, security.mechanism, security.server_keys, security.zap);
+        bind_with_retry(socket, opt.endpoint);
+        if (verbose && chatty(opt)) {
+            // Flushed: scripts wait for this line before starting the client
+            std::cout << "Listening on " << opt.endpoint << std::endl;
+            if (security.mechanism == "curve") {
+                // Flushed now: a client in another process needs it to connect
+                std::cout << "CURVE server key: " << security.server_keys.public_key << std::endl;
+            }
+            std::cout << "Message count: " << opt.count << "\n";
+            std::cout << "Waiting for messages...\n";
+        }
+
+        for (size_t size : opt.sizes) {
+            result r = repeat_trials(opt, [&]() {
+                served outcome = serve(socket, spec_for(opt, size), [] {});
+                outcome.measured->transport = transport;
+                return *outcome.measured;
+            });
+            report(opt, r);
+        }
+    };
+
+    auto client = [&](zmq::context_t &context, bool verbose) {
+        std::unique_ptr<control_client> control;
+        if (!opt.control.empty()) {
+            control = std::make_unique<control_client>(context, opt.control);
+        }
+
+        zmq::socket_t socket;
+        std::string server_key = security.server_key;
+        for (size_t size : opt.sizes) {
+            auto connect = [&]() {
+                if (socket.handle() == nullptr) {
+                    socket = zmq::socket_t(context, zmq::socket_type::push);
+                    configure(socket, opt.sockopts);
+                    secure_client(socket, security.mechanism, server_key, security.client_keys);
+                    socket.connect(opt.endpoint);
+                    if (verbose && chatty(opt)) {
+                        std::cout << "Connected to " << opt.endpoint << "\n";
+                        std::cout << "Message count: " << opt.count << "\n";
+                    }
+                }
+            };
+
+            std::vector<char> buffer(size, 'X');
+            if (!control) {
+                // The receiver times and reports every trial
+                connect();
+                for (int t = 0; t < opt.trials; t++) {
+                    send(socket, buffer, opt.count);
+                }
+                if (verbose && chatty(opt)) {
+                    std::cout << "Sent " << opt.count << " messages of " << size << " bytes.\n";
+                }
+                continue;
+            }
+
+            auto trial = [&]() {
+                control_message ready = control->prepare(spec_for(opt, size));
+                if (security.mechanism == "curve") {
+                    server_key = ready.get("curve_serverkey");
+                }
+                connect();
+
+                // Warm-up message, then wait until the server has seen it
+                send(socket, buffer, 1);
+                control->start();
+
+                auto start = clock_type::now();
+                send(socket, buffer, opt.count - 1);
+                served outcome = control->finish();
+                auto end = clock_type::now();
+
+                if (outcome.received != opt.count || !outcome.measured) {
+                    throw std::runtime_error("Server received " + std::to_string(outcome.received) +
+                                             " messages, expected " + std::to_string(opt.count));
+                }
+
+                result r = *outcome.measured;
+                r.command = "thr";
+                r.transport = transport;
+                r.message_size = size;
+                r.message_count = opt.count;
+                double elapsed_sec = std::chrono::duration<double>(end - start).count();
+                r.end_to_end_msg_per_sec = static_cast<double>(opt.count - 1) / elapsed_sec;
+                return r;
+            };
+            report(opt, repeat_trials(opt, trial));
+        }
+    };
+
+    run_roles(opt, server, client);
+}
+
+}  // namespace zmqbench
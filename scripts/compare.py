@@ -20,10 +20,50 @@ class BenchmarkParser:
         self.results_dir = self.project_root / "docs" / "results"
 
     def parse_cpp_results(self):
-        """Parse C++ baseline results"""
+        """Parse C++ baseline results (JSON records when available)"""
+        records_path = self.results_dir / "cpp-results.jsonl"
+        if records_path.exists():
+            return self._parse_records(records_path)
         file_path = self.results_dir / "cpp-baseline.md"
         return self._parse_generic_format(file_path, "C++")
 
+    def _parse_records(self, file_path):
+        """Parse JSON Lines records written by the C++ benchmarks (ZMQ_BENCH_OUTPUT)"""
+        results = {"latency": [], "throughput": []}
+
+        for line in file_path.read_text().splitlines():
+            if not line.strip():
+                continue
+            record = json.loads(line)
+
+            # Cross-language comparison uses REQ/REP and PUSH/PULL over tcp via cppzmq
+            if record.get("transport") != "tcp" or record.get("binding", "cppzmq") != "cppzmq":
+                continue
+            # Default receive path, no allocation counting
+            config = record.get("config") or {}
+            if config.get("recv", "message") != "message" or "allocs_per_msg" in config:
+                continue
+            # Plaintext only: CURVE and ZAP runs measure the security layer
+            if config.get("mechanism", "null") != "null" or config.get("zap"):
+                continue
+            # Side runs of one section (run_benchmark.sh sets ZMQ_BENCH_SUITE)
+            if "suite" in config:
+                continue
+            if record.get("benchmark") == "lat" and record.get("latency_us") is not None:
+                results["latency"].append(
+                    {"size": record["size"], "latency_us": record["latency_us"]}
+                )
+            elif record.get("benchmark") == "thr" and record.get("msg_per_sec") is not None:
+                results["throughput"].append(
+                    {
+                        "size": record["size"],
+                        "msg_per_sec": record["msg_per_sec"],
+                        "mbps": record["mbps"],
+                    }
+                )
+
+        return results
+
     def parse_dotnet_results(self):
         """Parse .NET results"""
         file_path = self.results_dir / "dotnet.md"
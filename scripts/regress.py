@@ -0,0 +1,296 @@
+#!/usr/bin/env python3
+
+"""
+ZeroMQ Binding Benchmark - Performance Regression Gate
+Compares C++ results against a stored baseline and exits non-zero on regressions
+
+A metric regresses when it is worse than the baseline by more than the
+threshold AND the difference is statistically significant:
+- both sides have trial samples: two-sided Mann-Whitney U test
+- only the current run has trials: baseline value outside the current 95% CI
+- single values on both sides: threshold only
+
+Usage:
+    python3 scripts/regress.py                      # compare existing results
+    python3 scripts/regress.py --run                # run cpp/run_benchmark.sh first
+    python3 scripts/regress.py --threshold 3 --baseline docs/results/cpp-regression-baseline.jsonl
+    python3 scripts/regress.py --save-baseline docs/results/cpp-regression-baseline.jsonl
+
+Exit codes: 0 no regression, 1 regression found, 2 missing or unusable input
+"""
+
+import argparse
+import json
+import math
+import shutil
+import subprocess
+import sys
+from pathlib import Path
+
+# metric -> (benchmark, lower_is_better, unit)
+METRICS = {
+    "latency_us": ("lat", True, "us"),
+    "msg_per_sec": ("thr", False, "msg/s"),
+}
+
+
+class Samples:
+    """Trial values of one metric at one message size"""
+
+    def __init__(self):
+        self.values = []
+        self.runs = 0
+        self.ci = None  # (low, high) of the record; only meaningful for a single run
+
+    def median(self):
+        ordered = sorted(self.values)
+        n = len(ordered)
+        mid = n // 2
+        return ordered[mid] if n % 2 else (ordered[mid - 1] + ordered[mid]) / 2.0
+
+
+def load_records(path):
+    """Samples from JSON Lines records (cpp/run_benchmark.sh, ZMQ_BENCH_OUTPUT)"""
+    samples = {}
+    for line in path.read_text().splitlines():
+        if not line.strip():
+            continue
+        record = json.loads(line)
+
+        # Same selection as compare.py: REQ/REP and PUSH/PULL over tcp via cppzmq
+        if record.get("transport") != "tcp" or record.get("binding", "cppzmq") != "cppzmq":
+            continue
+        # Default receive path, no allocation counting
+        config = record.get("config") or {}
+        if config.get("recv", "message") != "message" or "allocs_per_msg" in config:
+            continue
+        # Plaintext only: CURVE and ZAP runs measure the security layer
+        if config.get("mechanism", "null") != "null" or config.get("zap"):
+            continue
+        # Side runs of one section (run_benchmark.sh sets ZMQ_BENCH_SUITE)
+        if "suite" in config:
+            continue
+        for metric, (benchmark, _, _) in METRICS.items():
+            if record.get("benchmark") != benchmark or record.get(metric) is None:
+                continue
+            entry = samples.setdefault((metric, record["size"]), Samples())
+            entry.runs += 1
+            trials = record.get("trials") or {}
+            if trials.get("values"):
+                entry.values.extend(v for v in trials["values"] if v is not None)
+                if entry.runs == 1 and trials.get("ci_low") is not None:
+                    entry.ci = (trials["ci_low"], trials["ci_high"])
+                else:
+                    entry.ci = None
+            else:
+                entry.values.append(record[metric])
+    return samples
+
+
+def load_benchmark_data(path, language="C++"):
+    """Single values from compare.py's benchmark_data.json"""
+    data = json.loads(path.read_text())
+    samples = {}
+    for section, metric in (("latency", "latency_us"), ("throughput", "msg_per_sec")):
+        for entry in data.get(section, {}).get(language, []):
+            if entry.get(metric) is not None:
+                samples.setdefault((metric, entry["size"]), Samples()).values.append(entry[metric])
+    return samples
+
+
+def load(path):
+    if path.suffix == ".jsonl":
+        return load_records(path)
+    return load_benchmark_data(path)
+
+
+def mann_whitney(a, b):
+    """Two-sided Mann-Whitney U test; returns (U of a, p-value)
+
+    Exact null distribution for small tie-free samples, otherwise the normal
+    approximation with tie and continuity corrections.
+    """
+    n1, n2 = len(a), len(b)
+    combined = sorted([(v, 0) for v in a] + [(v, 1) for v in b])
+
+    # Average ranks over ties
+    ranks = [0.0] * len(combined)
+    tie_term = 0.0
+    i = 0
+    while i < len(combined):
+        j = i
+        while j + 1 < len(combined) and combined[j + 1][0] == combined[i][0]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[k] = (i + j) / 2.0 + 1.0
+        t = j - i + 1
+        tie_term += t ** 3 - t
+        i = j + 1
+
+    r1 = sum(rank for rank, (_, group) in zip(ranks, combined) if group == 0)
+    u1 = r1 - n1 * (n1 + 1) / 2.0
+    u_min = min(u1, n1 * n2 - u1)
+
+    if tie_term == 0 and n1 <= 30 and n2 <= 30:
+        # counts[j][u]: orderings of i a's and j b's with U == u, built row by row
+        counts = [[1] for _ in range(n2 + 1)]
+        for _ in range(n1):
+            row = [[1]]
+            for j in range(1, n2 + 1):
+                # Last element is an a (adds j to U) or a b
+                left = [0] * j + counts[j]
+                up = row[j - 1]
+                size = max(len(left), len(up))
+                row.append([(left[k] if k < len(left) else 0) + (up[k] if k < len(up) else 0)
+                            for k in range(size)])
+            counts = row
+        dist = counts[n2]
+        total = sum(dist)
+        p = 2.0 * sum(dist[: int(u_min) + 1]) / total
+        return u1, min(p, 1.0)
+
+    n = n1 + n2
+    mean = n1 * n2 / 2.0
+    var = n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1)))
+    if var <= 0:
+        return u1, 1.0
+    z = (abs(u1 - mean) - 0.5) / math.sqrt(var)
+    p = math.erfc(max(z, 0.0) / math.sqrt(2.0))
+    return u1, min(p, 1.0)
+
+
+class Comparison:
+    """One metric at one message size"""
+
+    def __init__(self, metric, size, baseline, current, threshold, alpha):
+        self.metric = metric
+        self.size = size
+        self.baseline = baseline.median()
+        self.current = current.median()
+        lower_is_better = METRICS[metric][1]
+
+        change = (self.current - self.baseline) / self.baseline * 100.0 if self.baseline else 0.0
+        self.change = change
+        # Positive = worse, whichever direction the metric runs
+        self.worse = change if lower_is_better else -change
+
+        if len(baseline.values) >= 2 and len(current.values) >= 2:
+            _, self.p_value = mann_whitney(baseline.values, current.values)
+            self.test = f"MWU p={self.p_value:.3g}"
+            significant = self.p_value < alpha
+        elif len(current.values) >= 2 and current.ci:
+            low, high = current.ci
+            significant = not (low <= self.baseline <= high)
+            self.test = "outside CI" if significant else "inside CI"
+        else:
+            significant = True
+            self.test = "threshold only"
+
+        if self.worse > threshold and significant:
+            self.status = "REGRESSION"
+        elif -self.worse > threshold and significant:
+            self.status = "improved"
+        elif abs(self.worse) > threshold:
+            self.status = "noise"
+        else:
+            self.status = "ok"
+
+
+def compare(baseline, current, threshold, alpha):
+    comparisons = []
+    missing = []
+    for key in sorted(baseline):
+        if key not in current:
+            missing.append(key)
+            continue
+        metric, size = key
+        comparisons.append(Comparison(metric, size, baseline[key], current[key], threshold, alpha))
+    return comparisons, missing
+
+
+def print_table(comparisons):
+    print(f"{'Metric':<13}{'Size':>7}  {'Baseline':>12}  {'Current':>12}  {'Change':>8}  "
+          f"{'Test':<16}Status")
+    for c in comparisons:
+        unit = METRICS[c.metric][2]
+        print(f"{c.metric:<13}{c.size:>7}  {c.baseline:>12.6g}  {c.current:>12.6g}  "
+              f"{c.change:>+7.1f}%  {c.test:<16}{c.status}")
+        if c.status == "REGRESSION":
+            print(f"    ✗ {c.worse:.1f}% worse than baseline ({unit})")
+
+
+def main():
+    """Main execution"""
+    script_dir = Path(__file__).parent
+    project_root = script_dir.parent
+    results_dir = project_root / "docs" / "results"
+
+    default_baseline = results_dir / "cpp-regression-baseline.jsonl"
+    if not default_baseline.exists():
+        default_baseline = results_dir / "benchmark_data.json"
+
+    parser = argparse.ArgumentParser(description="C++ performance regression gate")
+    parser.add_argument("--baseline", type=Path, default=default_baseline,
+                        help="records (.jsonl) or benchmark_data.json (default: %(default)s)")
+    parser.add_argument("--current", type=Path, default=results_dir / "cpp-results.jsonl",
+                        help="records of the run under test (default: %(default)s)")
+    parser.add_argument("--run", action="store_true",
+                        help="run cpp/run_benchmark.sh first (writes the default --current)")
+    parser.add_argument("--threshold", type=float, default=5.0,
+                        help="percent change that counts as a regression (default: 5)")
+    parser.add_argument("--alpha", type=float, default=0.05,
+                        help="significance level of the Mann-Whitney test (default: 0.05)")
+    parser.add_argument("--save-baseline", type=Path,
+                        help="after comparing, store the current records as the new baseline")
+    args = parser.parse_args()
+
+    print("=" * 50)
+    print("ZeroMQ Binding Benchmark - Regression Gate")
+    print("=" * 50)
+    print()
+
+    if args.run:
+        print("Running C++ benchmarks...")
+        result = subprocess.run(["./run_benchmark.sh"], cwd=project_root / "cpp")
+        if result.returncode != 0:
+            print(f"  ✗ run_benchmark.sh failed with exit code {result.returncode}")
+            return 2
+        print()
+
+    for label, path in (("Baseline", args.baseline), ("Current", args.current)):
+        if not path.exists():
+            print(f"  ✗ {label} not found: {path}")
+            return 2
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+    print(f"Baseline: {args.baseline} ({len(baseline)} metrics)")
+    print(f"Current:  {args.current} ({len(current)} metrics)")
+    print(f"Threshold: {args.threshold}%, alpha: {args.alpha}")
+    print()
+
+    comparisons, missing = compare(baseline, current, args.threshold, args.alpha)
+    if not comparisons:
+        print("  ✗ No metric appears in both baseline and current results")
+        return 2
+
+    print_table(comparisons)
+    for metric, size in missing:
+        print(f"  ⚠ {metric} at {size} bytes missing from current results")
+    print()
+
+    if args.save_baseline:
+        shutil.copyfile(args.current, args.save_baseline)
+        print(f"  ✓ Current results saved as baseline: {args.save_baseline}")
+
+    regressions = [c for c in comparisons if c.status == "REGRESSION"]
+    if regressions:
+        print(f"✗ {len(regressions)} regression(s) above {args.threshold}%")
+        return 1
+
+    print("✓ No regressions")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())